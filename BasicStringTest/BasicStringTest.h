@@ -13,3 +13,31 @@ void CapacityTester();
 void ModifiersTester();
 
 void NonMemberFunctionsTester();
+
+void RopeTester();
+
+void ConcatenationTester();
+
+void NumericConversionTester();
+
+void InputOutputTester();
+
+void AllocatorTester();
+
+void AsciiTester();
+
+void UnicodeTester();
+
+void MultiPatternSearchTester();
+
+void StringColumnTester();
+
+void SharedStringTester();
+
+void FormatTester();
+
+void CodecTester();
+
+void EditDistanceTester();
+
+void GapBufferTester();
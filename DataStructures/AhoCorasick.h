@@ -0,0 +1,547 @@
+#pragma once
+#include <stdexcept>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <utility>
+#include <initializer_list>
+#include "BasicString.h"
+#include "BasicStringView.h"
+#include "Vector.h"
+#include "SIMD.h"
+
+constexpr size_t AHO_CORASICK_DFA_LIMIT = 1U << 22;		//Transitions of a full DFA, 16MB
+constexpr size_t TEDDY_MAX_PATTERNS = 32;				//Larger sets use the automaton even with SSSE3
+
+namespace DataStructures
+{
+	class AhoCorasick;
+	struct PatternMatch;
+
+	struct PatternMatch
+	{
+		size_t pattern;		//Index of the pattern in the order given
+		size_t position;	//Of its first character
+	};
+
+	//Finds every occurrence of a fixed set of patterns in one pass over the text, whatever the number of patterns.
+	//Patterns are compiled into an automaton whose transitions are flattened into arrays indexed by state and byte class,
+	//where bytes that occur in no pattern share one class. If a full DFA fits in AHO_CORASICK_DFA_LIMIT transitions every byte
+	//costs one table lookup. Larger sets spend that budget on full rows for the shallow states, where the search spends most
+	//of its time, and keep sorted sparse rows with failure links for deeper states.
+	//With SSSE3, sets of up to TEDDY_MAX_PATTERNS patterns are searched 16 positions at a time instead (Teddy, from Hyperscan):
+	//the nibbles of the first three bytes at every position are looked up in shuffle tables of eight pattern buckets,
+	//and only positions where some bucket matches all of them are compared with its patterns.
+	class AhoCorasick
+	{
+	public:
+		class Scanner;
+
+		//Constructor
+		AhoCorasick();
+		AhoCorasick(std::initializer_list<StringView> patterns);	//Throw invalid_argument on an empty pattern
+		template<typename InputIterator>
+		AhoCorasick(InputIterator first, InputIterator last);		//Of anything convertible to StringView
+
+		//Capacity
+		size_t pattern_count() const noexcept;
+		size_t pattern_length(size_t pattern) const;				//Check and throw out_of_range exception
+		size_t state_count() const noexcept;
+		bool is_dfa() const noexcept;
+
+		//Operations
+		//Every occurrence, overlapping ones included. The automaton reports them in the order they end, Teddy in the order they start.
+		template<typename Func> void find_all(StringView text, Func on_match) const;	//on_match(const PatternMatch&)
+		Vector<PatternMatch> find_all(StringView text) const;
+		bool contains_any(StringView text) const;										//Stops at the first match
+		size_t count(StringView text) const;
+		Scanner scanner() const noexcept;
+
+	private:
+		//A state is a handle: the offset of its full row in dense, or SPARSE and the offset of its record in sparse.
+		//Rows end with the range of the state's outputs, records are { failure link, outputs begin, outputs end,
+		//child count, then label and handle of each child by label }. Handles of states with outputs carry MATCH.
+		enum : uint32_t
+		{
+			NONE = uint32_t(-1),
+			SPARSE = 1U << 31,
+			MATCH = 1U << 30,
+			OFFSET = MATCH - 1
+		};
+
+		struct Output
+		{
+			uint32_t pattern;
+			uint32_t length;
+		};
+
+		uint16_t byte_classes[256] = {};
+		size_t class_count = 1;
+		size_t row_size = 3;
+		size_t states = 1;
+		bool dfa = true;
+		Vector<uint32_t> dense;
+		Vector<uint32_t> sparse;
+		Vector<Output> outputs;									//Patterns ending at a state, its own and those of its suffixes
+		Vector<uint32_t> lengths;
+
+		bool teddy = false;
+		size_t fingerprint = 0;									//Bytes looked up at every position, at most 3
+		alignas(16) unsigned char teddy_low[3][16] = {};
+		alignas(16) unsigned char teddy_high[3][16] = {};
+		uint32_t bucket_begin[9] = {};
+		Vector<uint32_t> bucket_patterns;
+		String pattern_text;									//Patterns one after another, kept for Teddy
+		Vector<uint32_t> pattern_begin;
+
+		//Helper functions
+		inline void _compile(const Vector<StringView>& patterns);
+		inline void _compile_teddy(const Vector<StringView>& patterns);
+		inline uint32_t _next(uint32_t handle, uint16_t byte_class) const noexcept;
+		template<typename Func> inline bool _find(StringView text, Func& on_match) const;	//on_match returns false to stop, then so does this
+		template<typename Func> inline bool _scan(const unsigned char* first, const unsigned char* last, uint32_t& handle, size_t offset, Func& on_match) const;
+		template<typename Func> inline bool _report(uint32_t handle, size_t end, Func& on_match) const;
+		template<typename Func> inline bool _teddy_scan(const unsigned char* first, const unsigned char* last, Func& on_match) const;
+		template<typename Func> inline bool _teddy_verify(const unsigned char* first, const unsigned char* last, const unsigned char* at, unsigned buckets, Func& on_match) const;
+	};
+
+	//Matches a text that arrives in chunks as if it were one string, occurrences may span chunks.
+	//Positions count from the start of the first chunk. Always runs the automaton.
+	class AhoCorasick::Scanner
+	{
+	public:
+		explicit Scanner(const AhoCorasick& _automaton) noexcept : automaton(&_automaton) {}
+
+		template<typename Func> void feed(StringView chunk, Func on_match);
+		void reset() noexcept;
+		size_t position() const noexcept;			//Bytes fed since the last reset
+
+	private:
+		const AhoCorasick* automaton;
+		uint32_t handle = 0;
+		size_t offset = 0;
+	};
+
+	/* Dividing Line ( 㧥 ;) ( 㧥 ;) ( 㧥 ;)  */
+
+	inline AhoCorasick::AhoCorasick()
+	{
+		_compile(Vector<StringView>());
+	}
+
+	inline AhoCorasick::AhoCorasick(std::initializer_list<StringView> patterns)
+	{
+		Vector<StringView> compiled;
+		compiled.reserve(patterns.size());
+		for (const StringView& pattern : patterns)
+			compiled.push_back(pattern);
+		_compile(compiled);
+	}
+
+	template<typename InputIterator>
+	inline AhoCorasick::AhoCorasick(InputIterator first, InputIterator last)
+	{
+		Vector<StringView> compiled;
+		for (; first != last; ++first)
+			compiled.push_back(StringView(*first));
+		_compile(compiled);
+	}
+
+	inline void AhoCorasick::_compile(const Vector<StringView>& patterns)
+	{
+		size_t n = patterns.size();
+
+		//Every byte used by a pattern gets a class of its own, the others share class 0
+		bool used[256] = {};
+		for (const StringView& pattern : patterns)
+		{
+			if (pattern.empty())
+				throw std::invalid_argument{ "Patterns must not be empty!" };
+			for (char ch : pattern)
+				used[static_cast<unsigned char>(ch)] = true;
+		}
+		class_count = 1;
+		for (size_t byte = 0; byte < 256; byte++)
+			byte_classes[byte] = used[byte] ? uint16_t(class_count++) : 0;
+
+		//Trie, the children of a state are a linked list while building
+		Vector<uint32_t> first_child(1, NONE);
+		Vector<uint32_t> next_sibling(1, NONE);
+		Vector<uint16_t> label(1, uint16_t(0));
+		Vector<uint32_t> terminal(1, NONE);					//Last pattern ending at a state, the others through terminal_next
+		Vector<uint32_t> terminal_next(n, NONE);
+		lengths.clear();
+		lengths.reserve(n);
+		for (size_t i = 0; i < n; i++)
+		{
+			uint32_t state = 0;
+			for (char ch : patterns[i])
+			{
+				uint16_t byte_class = byte_classes[static_cast<unsigned char>(ch)];
+				uint32_t child = first_child[state];
+				while (child != NONE && label[child] != byte_class)
+					child = next_sibling[child];
+				if (child == NONE)
+				{
+					child = uint32_t(label.size());
+					uint32_t sibling = first_child[state];
+					first_child.push_back(NONE);
+					next_sibling.push_back(sibling);
+					label.push_back(byte_class);
+					terminal.push_back(NONE);
+					first_child[state] = child;
+				}
+				state = child;
+			}
+			terminal_next[i] = terminal[state];
+			terminal[state] = uint32_t(i);
+			lengths.push_back(uint32_t(patterns[i].size()));
+		}
+		states = label.size();
+
+		//Breadth first, so that shallow states come first and every failure link points backwards
+		auto child_of = [&](uint32_t state, uint16_t byte_class)
+		{
+			uint32_t child = first_child[state];
+			while (child != NONE && label[child] != byte_class)
+				child = next_sibling[child];
+			return child;
+		};
+		Vector<uint32_t> order;
+		Vector<uint32_t> trie_fail(states, uint32_t(0));
+		order.reserve(states);
+		order.push_back(0);
+		for (size_t i = 0; i < order.size(); i++)
+		{
+			uint32_t state = order[i];
+			for (uint32_t child = first_child[state]; child != NONE; child = next_sibling[child])
+			{
+				order.push_back(child);
+				if (state == 0) continue;
+				uint32_t suffix = trie_fail[state];
+				uint32_t target = child_of(suffix, label[child]);
+				while (target == NONE && suffix != 0)
+				{
+					suffix = trie_fail[suffix];
+					target = child_of(suffix, label[child]);
+				}
+				trie_fail[child] = target == NONE ? 0 : target;
+			}
+		}
+		Vector<uint32_t> renumbered(states, uint32_t(0));
+		for (size_t i = 0; i < states; i++)
+			renumbered[order[i]] = uint32_t(i);
+
+		Vector<uint32_t> fail(states, uint32_t(0));
+		Vector<uint32_t> output_begin;
+		output_begin.reserve(states + 1);
+		outputs.clear();
+		output_begin.push_back(0);
+		for (size_t i = 0; i < states; i++)
+		{
+			uint32_t suffix = renumbered[trie_fail[order[i]]];
+			fail[i] = suffix;
+			for (uint32_t pattern = terminal[order[i]]; pattern != NONE; pattern = terminal_next[pattern])
+				outputs.push_back(Output{ pattern, lengths[pattern] });
+			if (i != 0)
+			{
+				for (uint32_t k = output_begin[suffix]; k < output_begin[suffix + 1]; k++)
+				{
+					Output inherited = outputs[k];
+					outputs.push_back(inherited);
+				}
+			}
+			uint32_t end = uint32_t(outputs.size());
+			output_begin.push_back(end);
+		}
+
+		//As many states get a full row as the budget allows, the shallow ones first since failure links point to shallower states
+		row_size = class_count + 2;
+		dfa = states * row_size <= AHO_CORASICK_DFA_LIMIT;
+		size_t dense_count = dfa ? states : AHO_CORASICK_DFA_LIMIT / row_size;
+		Vector<uint32_t> handles(states, uint32_t(0));
+		size_t sparse_size = 0;
+		for (size_t i = 0; i < states; i++)
+		{
+			size_t child_count = 0;
+			for (uint32_t child = first_child[order[i]]; child != NONE; child = next_sibling[child])
+				++child_count;
+			if (i < dense_count)
+				handles[i] = uint32_t(i * row_size);
+			else
+			{
+				if (sparse_size > OFFSET)
+					throw std::length_error{ "Too many patterns!" };
+				handles[i] = SPARSE | uint32_t(sparse_size);
+				sparse_size += 4 + 2 * child_count;
+			}
+			if (output_begin[i] != output_begin[i + 1])
+				handles[i] |= MATCH;
+		}
+
+		//A full row is the row of the failure link with the state's own children written over it
+		dense.clear();
+		dense.resize(dense_count * row_size, uint32_t(0));
+		for (size_t i = 0; i < dense_count; i++)
+		{
+			uint32_t* row = dense.data() + i * row_size;
+			if (i != 0)
+				memcpy(row, dense.data() + fail[i] * row_size, class_count * sizeof(uint32_t));
+			for (uint32_t child = first_child[order[i]]; child != NONE; child = next_sibling[child])
+				row[label[child]] = handles[renumbered[child]];
+			row[class_count] = output_begin[i];
+			row[class_count + 1] = output_begin[i + 1];
+		}
+
+		sparse.clear();
+		sparse.reserve(sparse_size);
+		std::pair<uint16_t, uint32_t> children[257];
+		for (size_t i = dense_count; i < states; i++)
+		{
+			size_t child_count = 0;
+			for (uint32_t child = first_child[order[i]]; child != NONE; child = next_sibling[child])
+				children[child_count++] = std::make_pair(label[child], handles[renumbered[child]]);
+			std::sort(children, children + child_count);
+			uint32_t record[4] = { handles[fail[i]] & ~MATCH, output_begin[i], output_begin[i + 1], uint32_t(child_count) };
+			for (uint32_t field : record)
+				sparse.push_back(field);
+			for (size_t k = 0; k < child_count; k++)
+			{
+				sparse.push_back(uint32_t(children[k].first));
+				sparse.push_back(children[k].second);
+			}
+		}
+
+		_compile_teddy(patterns);
+	}
+
+	inline void AhoCorasick::_compile_teddy(const Vector<StringView>& patterns)
+	{
+		size_t n = patterns.size();
+#if defined(DATASTRUCTURES_SSSE3)
+		teddy = n != 0 && n <= TEDDY_MAX_PATTERNS;
+#else
+		teddy = false;
+#endif
+		if (!teddy) return;
+
+		fingerprint = 3;
+		for (const StringView& pattern : patterns)
+			fingerprint = pattern.size() < fingerprint ? pattern.size() : fingerprint;
+
+		//Pattern i goes into bucket i % 8, bit i % 8 of the tables is set for every nibble its first bytes have
+		memset(teddy_low, 0, sizeof(teddy_low));
+		memset(teddy_high, 0, sizeof(teddy_high));
+		bucket_patterns.clear();
+		for (size_t bucket = 0; bucket < 8; bucket++)
+		{
+			bucket_begin[bucket] = uint32_t(bucket_patterns.size());
+			for (size_t i = bucket; i < n; i += 8)
+			{
+				bucket_patterns.push_back(uint32_t(i));
+				for (size_t j = 0; j < fingerprint; j++)
+				{
+					unsigned char byte = static_cast<unsigned char>(patterns[i][j]);
+					teddy_low[j][byte & 0x0F] |= 1 << bucket;
+					teddy_high[j][byte >> 4] |= 1 << bucket;
+				}
+			}
+		}
+		bucket_begin[8] = uint32_t(bucket_patterns.size());
+
+		pattern_text.clear();
+		pattern_begin.clear();
+		for (const StringView& pattern : patterns)
+		{
+			pattern_begin.push_back(uint32_t(pattern_text.size()));
+			pattern_text.append(pattern.data(), pattern.size());
+		}
+	}
+
+	inline size_t AhoCorasick::pattern_count() const noexcept
+	{
+		return lengths.size();
+	}
+
+	inline size_t AhoCorasick::pattern_length(size_t pattern) const
+	{
+		if (pattern >= lengths.size())
+			throw std::out_of_range{ "Accessed position is out of range!" };
+		return lengths[pattern];
+	}
+
+	inline size_t AhoCorasick::state_count() const noexcept
+	{
+		return states;
+	}
+
+	inline bool AhoCorasick::is_dfa() const noexcept
+	{
+		return dfa;
+	}
+
+	template<typename Func>
+	inline void AhoCorasick::find_all(StringView text, Func on_match) const
+	{
+		auto report = [&](const PatternMatch& match) { on_match(match); return true; };
+		_find(text, report);
+	}
+
+	inline Vector<PatternMatch> AhoCorasick::find_all(StringView text) const
+	{
+		Vector<PatternMatch> result;
+		find_all(text, [&](const PatternMatch& match) { result.push_back(match); });
+		return result;
+	}
+
+	inline bool AhoCorasick::contains_any(StringView text) const
+	{
+		auto stop = [](const PatternMatch&) { return false; };
+		return !_find(text, stop);
+	}
+
+	inline size_t AhoCorasick::count(StringView text) const
+	{
+		size_t n = 0;
+		find_all(text, [&](const PatternMatch&) { ++n; });
+		return n;
+	}
+
+	inline AhoCorasick::Scanner AhoCorasick::scanner() const noexcept
+	{
+		return Scanner(*this);
+	}
+
+	inline uint32_t AhoCorasick::_next(uint32_t handle, uint16_t byte_class) const noexcept
+	{
+		handle &= ~MATCH;
+		while (handle & SPARSE)
+		{
+			const uint32_t* record = sparse.data() + (handle & OFFSET);
+			const uint32_t* child = record + 4;
+			for (const uint32_t* last = child + 2 * record[3]; child != last && child[0] <= byte_class; child += 2)
+				if (child[0] == byte_class) return child[1];
+			handle = record[0];
+		}
+		return dense[handle + byte_class];
+	}
+
+	template<typename Func>
+	inline bool AhoCorasick::_find(StringView text, Func & on_match) const
+	{
+		const unsigned char* first = reinterpret_cast<const unsigned char*>(text.data());
+		if (teddy) return _teddy_scan(first, first + text.size(), on_match);
+		uint32_t handle = 0;
+		return _scan(first, first + text.size(), handle, 0, on_match);
+	}
+
+	template<typename Func>
+	inline bool AhoCorasick::_scan(const unsigned char * first, const unsigned char * last, uint32_t & handle, size_t offset, Func & on_match) const
+	{
+		if (dfa)
+		{
+			//Every handle is a row offset, so a step is one load and one add
+			const uint32_t* table = dense.data();
+			for (const unsigned char* curr = first; curr != last; ++curr)
+			{
+				handle = table[(handle & ~MATCH) + byte_classes[*curr]];
+				if ((handle & MATCH) && !_report(handle, offset + (curr - first) + 1, on_match)) return false;
+			}
+			return true;
+		}
+		for (const unsigned char* curr = first; curr != last; ++curr)
+		{
+			handle = _next(handle, byte_classes[*curr]);
+			if ((handle & MATCH) && !_report(handle, offset + (curr - first) + 1, on_match)) return false;
+		}
+		return true;
+	}
+
+	template<typename Func>
+	inline bool AhoCorasick::_report(uint32_t handle, size_t end, Func & on_match) const
+	{
+		//The range sits in the row or record that the next step reads anyway
+		const uint32_t* range = handle & SPARSE ? sparse.data() + (handle & OFFSET) + 1 : dense.data() + (handle & OFFSET) + class_count;
+		for (const Output* output = outputs.data() + range[0]; output != outputs.data() + range[1]; ++output)
+			if (!on_match(PatternMatch{ output->pattern, end - output->length })) return false;
+		return true;
+	}
+
+	template<typename Func>
+	inline bool AhoCorasick::_teddy_scan(const unsigned char * first, const unsigned char * last, Func & on_match) const
+	{
+		const unsigned char* curr = first;
+#if defined(DATASTRUCTURES_SSSE3)
+		const __m128i nibble = _mm_set1_epi8(0x0F);
+		__m128i low[3];
+		__m128i high[3];
+		for (size_t j = 0; j < fingerprint; j++)
+		{
+			low[j] = _mm_load_si128(reinterpret_cast<const __m128i*>(teddy_low[j]));
+			high[j] = _mm_load_si128(reinterpret_cast<const __m128i*>(teddy_high[j]));
+		}
+		//Byte i of candidates holds the buckets that match the fingerprint starting at curr + i
+		for (; size_t(last - curr) >= 16 + fingerprint - 1; curr += 16)
+		{
+			__m128i candidates = _mm_set1_epi8(-1);
+			for (size_t j = 0; j < fingerprint; j++)
+			{
+				__m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(curr + j));
+				__m128i low_buckets = _mm_shuffle_epi8(low[j], _mm_and_si128(input, nibble));
+				__m128i high_buckets = _mm_shuffle_epi8(high[j], _mm_and_si128(_mm_srli_epi16(input, 4), nibble));
+				candidates = _mm_and_si128(candidates, _mm_and_si128(low_buckets, high_buckets));
+			}
+			unsigned mask = unsigned(_mm_movemask_epi8(_mm_cmpeq_epi8(candidates, _mm_setzero_si128()))) ^ 0xFFFF;
+			if (mask == 0) continue;
+			alignas(16) unsigned char buckets[16];
+			_mm_store_si128(reinterpret_cast<__m128i*>(buckets), candidates);
+			for (; mask; mask &= mask - 1)
+			{
+				unsigned i = _count_trailing_zeros(mask);
+				if (!_teddy_verify(first, last, curr + i, buckets[i], on_match)) return false;
+			}
+		}
+#endif
+		for (; curr != last; ++curr)
+			if (!_teddy_verify(first, last, curr, 0xFF, on_match)) return false;
+		return true;
+	}
+
+	template<typename Func>
+	inline bool AhoCorasick::_teddy_verify(const unsigned char * first, const unsigned char * last, const unsigned char * at, unsigned buckets, Func & on_match) const
+	{
+		for (; buckets; buckets &= buckets - 1)
+		{
+			unsigned bucket = _count_trailing_zeros(buckets);
+			for (uint32_t k = bucket_begin[bucket]; k < bucket_begin[bucket + 1]; k++)
+			{
+				uint32_t pattern = bucket_patterns[k];
+				size_t length = lengths[pattern];
+				if (length <= size_t(last - at) && memcmp(at, pattern_text.data() + pattern_begin[pattern], length) == 0
+					&& !on_match(PatternMatch{ pattern, size_t(at - first) }))
+					return false;
+			}
+		}
+		return true;
+	}
+
+	template<typename Func>
+	inline void AhoCorasick::Scanner::feed(StringView chunk, Func on_match)
+	{
+		auto report = [&](const PatternMatch& match) { on_match(match); return true; };
+		const unsigned char* first = reinterpret_cast<const unsigned char*>(chunk.data());
+		automaton->_scan(first, first + chunk.size(), handle, offset, report);
+		offset += chunk.size();
+	}
+
+	inline void AhoCorasick::Scanner::reset() noexcept
+	{
+		handle = 0;
+		offset = 0;
+	}
+
+	inline size_t AhoCorasick::Scanner::position() const noexcept
+	{
+		return offset;
+	}
+}
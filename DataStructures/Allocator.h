@@ -0,0 +1,467 @@
+#pragma once
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+#include <new>
+#include <memory>
+#include <type_traits>
+
+namespace DataStructures
+{
+	template<typename T> class MallocAllocator;
+	class Arena;
+	template<typename T> class ArenaAllocator;
+	class NodePool;
+	template<typename T> class PoolAllocator;
+
+	constexpr size_t ARENA_BLOCK_SIZE = 1U << 16;
+	constexpr size_t NODE_POOL_SLAB_SIZE = 1U << 16;
+	constexpr size_t NODE_POOL_GRANULE = alignof(std::max_align_t);
+	constexpr size_t NODE_POOL_MAX_NODE = 256U;		//Larger requests go to malloc
+
+	//Containers take any std-style allocator. Storage of trivially copyable elements is grown with
+	//reallocate(p, old_n, new_n) when the allocator has one, which may extend the block in place instead of copying it.
+
+	template<typename Allocator, typename = void>
+	struct _has_reallocate : std::false_type {};
+
+	template<typename Allocator>
+	struct _has_reallocate<Allocator, std::void_t<decltype(std::declval<Allocator&>().reallocate(
+		std::declval<typename std::allocator_traits<Allocator>::pointer>(), size_t(), size_t()))>> : std::true_type {};
+
+	template<typename Allocator>
+	inline typename std::allocator_traits<Allocator>::pointer _allocator_reallocate(Allocator& alloc,
+		typename std::allocator_traits<Allocator>::pointer p, size_t old_n, size_t new_n, size_t, std::true_type)
+	{
+		return alloc.reallocate(p, old_n, new_n);
+	}
+
+	template<typename Allocator>
+	inline typename std::allocator_traits<Allocator>::pointer _allocator_reallocate(Allocator& alloc,
+		typename std::allocator_traits<Allocator>::pointer p, size_t old_n, size_t new_n, size_t n, std::false_type)
+	{
+		using value_type = typename std::allocator_traits<Allocator>::value_type;
+		typename std::allocator_traits<Allocator>::pointer grown = std::allocator_traits<Allocator>::allocate(alloc, new_n);
+		if (p)
+		{
+			memcpy(static_cast<void*>(grown), static_cast<const void*>(p), n * sizeof(value_type));
+			std::allocator_traits<Allocator>::deallocate(alloc, p, old_n);
+		}
+		return grown;
+	}
+
+	//Resizes a block of old_n elements to new_n and keeps its first n elements, p may be null
+	template<typename Allocator>
+	inline typename std::allocator_traits<Allocator>::pointer _allocator_reallocate(Allocator& alloc,
+		typename std::allocator_traits<Allocator>::pointer p, size_t old_n, size_t new_n, size_t n)
+	{
+		return _allocator_reallocate(alloc, p, old_n, new_n, n, _has_reallocate<Allocator>{});
+	}
+
+	//malloc, free and realloc. The default allocator of BasicString.
+	template<typename T>
+	class MallocAllocator
+	{
+	public:
+		using value_type = T;
+
+		MallocAllocator() noexcept = default;
+		template<typename U> MallocAllocator(const MallocAllocator<U>&) noexcept {}
+
+		T* allocate(size_t n);
+		void deallocate(T* p, size_t n) noexcept;
+		T* reallocate(T* p, size_t old_n, size_t new_n);	//Only for trivially copyable T
+	};
+
+	template<typename T, typename U>
+	inline bool operator==(const MallocAllocator<T>&, const MallocAllocator<U>&) noexcept { return true; }
+
+	template<typename T, typename U>
+	inline bool operator!=(const MallocAllocator<T>&, const MallocAllocator<U>&) noexcept { return false; }
+
+	//Monotonic memory for objects that die together, e.g. everything built while serving one request.
+	//Allocation bumps a pointer inside the current block and deallocation does nothing, the memory comes back
+	//all at once at reset() or destruction. The most recent allocation can still be grown in place or handed back,
+	//so a string appended to right after it was allocated grows without copying.
+	class Arena
+	{
+	public:
+		//Constructor, Destructor and Assignment
+		explicit Arena(size_t _block_size = ARENA_BLOCK_SIZE) noexcept;
+		Arena(const Arena&) = delete;
+		Arena& operator=(const Arena&) = delete;
+		~Arena();
+
+		//Modifiers
+		void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t));
+		void deallocate(void* p, size_t bytes) noexcept;	//Only the most recent allocation is given back
+		void* reallocate(void* p, size_t old_bytes, size_t new_bytes, size_t alignment = alignof(std::max_align_t));
+		void reset() noexcept;								//Releases every allocation, keeps the newest block for reuse
+
+		//Capacity
+		size_t used() const noexcept;						//Bytes handed out since the last reset()
+		size_t reserved() const noexcept;					//Bytes held in blocks
+
+	private:
+		struct Block
+		{
+			Block* next;
+			size_t size;									//Including this header
+		};
+
+		Block* blocks = nullptr;							//Newest first
+		char* current = nullptr;							//Free space of the newest block is [current, limit)
+		char* limit = nullptr;
+		char* last = nullptr;								//Start of the most recent allocation
+		size_t block_size;
+		size_t used_bytes = 0;
+		size_t reserved_bytes = 0;
+
+		//Helper functions
+		inline static char* _align(char* p, size_t alignment) noexcept;
+		inline void _grow(size_t bytes, size_t alignment);	//Start a new block with room for bytes
+	};
+
+	//Allocates from an Arena, which must outlive everything allocated from it
+	template<typename T>
+	class ArenaAllocator
+	{
+	public:
+		using value_type = T;
+
+		ArenaAllocator(Arena& _arena) noexcept : arena(&_arena) {}
+		template<typename U> ArenaAllocator(const ArenaAllocator<U>& other) noexcept : arena(&other.get_arena()) {}
+
+		T* allocate(size_t n);
+		void deallocate(T* p, size_t n) noexcept;
+		T* reallocate(T* p, size_t old_n, size_t new_n);	//Only for trivially copyable T
+		Arena& get_arena() const noexcept;
+
+	private:
+		Arena* arena;
+	};
+
+	template<typename T, typename U>
+	inline bool operator==(const ArenaAllocator<T>& lhs, const ArenaAllocator<U>& rhs) noexcept { return &lhs.get_arena() == &rhs.get_arena(); }
+
+	template<typename T, typename U>
+	inline bool operator!=(const ArenaAllocator<T>& lhs, const ArenaAllocator<U>& rhs) noexcept { return !(lhs == rhs); }
+
+	//Fixed-size nodes for linked containers. Nodes are carved one after another from large slabs, so nodes allocated
+	//in a row sit next to each other in memory, and a freed node goes onto an intrusive free list of its size class
+	//to be handed out again by the next allocation of that size. Slabs are only released at destruction.
+	class NodePool
+	{
+	public:
+		//Constructor, Destructor and Assignment
+		explicit NodePool(size_t _slab_size = NODE_POOL_SLAB_SIZE) noexcept;
+		NodePool(const NodePool&) = delete;
+		NodePool& operator=(const NodePool&) = delete;
+		~NodePool();
+
+		//Modifiers
+		void* allocate(size_t bytes);
+		void deallocate(void* p, size_t bytes) noexcept;
+
+		//Capacity
+		size_t used() const noexcept;						//Bytes of nodes handed out and not yet given back
+		size_t reserved() const noexcept;					//Bytes held in slabs
+
+	private:
+		struct FreeNode
+		{
+			FreeNode* next;
+		};
+
+		struct Slab
+		{
+			Slab* next;
+			size_t size;									//Including this header, padded to NODE_POOL_GRANULE
+		};
+
+		FreeNode* free_lists[NODE_POOL_MAX_NODE / NODE_POOL_GRANULE] = {};
+		Slab* slabs = nullptr;
+		char* current = nullptr;							//Free space of the newest slab is [current, limit)
+		char* limit = nullptr;
+		size_t slab_size;
+		size_t used_bytes = 0;
+		size_t reserved_bytes = 0;
+
+		//Helper functions
+		inline void _grow();
+	};
+
+	//Allocates single objects from a NodePool, which must outlive everything allocated from it.
+	//Copies and rebound copies share the pool, so a container's nodes come from the pool its allocator was built with.
+	template<typename T>
+	class PoolAllocator
+	{
+	public:
+		using value_type = T;
+
+		PoolAllocator(NodePool& _pool) noexcept : pool(&_pool) {}
+		template<typename U> PoolAllocator(const PoolAllocator<U>& other) noexcept : pool(&other.get_pool()) {}
+
+		T* allocate(size_t n);
+		void deallocate(T* p, size_t n) noexcept;
+		NodePool& get_pool() const noexcept;
+
+	private:
+		NodePool* pool;
+	};
+
+	template<typename T, typename U>
+	inline bool operator==(const PoolAllocator<T>& lhs, const PoolAllocator<U>& rhs) noexcept { return &lhs.get_pool() == &rhs.get_pool(); }
+
+	template<typename T, typename U>
+	inline bool operator!=(const PoolAllocator<T>& lhs, const PoolAllocator<U>& rhs) noexcept { return !(lhs == rhs); }
+
+	/* Dividing Line ( 㧥 ;) ( 㧥 ;) ( 㧥 ;)  */
+
+	template<typename T>
+	inline T * MallocAllocator<T>::allocate(size_t n)
+	{
+		T* p = static_cast<T*>(malloc(n * sizeof(T)));
+		if (!p && n) throw std::bad_alloc{};
+		return p;
+	}
+
+	template<typename T>
+	inline void MallocAllocator<T>::deallocate(T * p, size_t) noexcept
+	{
+		free(p);
+	}
+
+	template<typename T>
+	inline T * MallocAllocator<T>::reallocate(T * p, size_t, size_t new_n)
+	{
+		T* grown = static_cast<T*>(realloc(p, new_n * sizeof(T)));
+		if (!grown && new_n) throw std::bad_alloc{};
+		return grown;
+	}
+
+	inline Arena::Arena(size_t _block_size) noexcept : block_size(_block_size)
+	{
+	}
+
+	inline Arena::~Arena()
+	{
+		while (blocks)
+		{
+			Block* next = blocks->next;
+			free(blocks);
+			blocks = next;
+		}
+	}
+
+	inline char * Arena::_align(char * p, size_t alignment) noexcept
+	{
+		return reinterpret_cast<char*>((reinterpret_cast<uintptr_t>(p) + alignment - 1) & ~(uintptr_t(alignment) - 1));
+	}
+
+	inline void Arena::_grow(size_t bytes, size_t alignment)
+	{
+		size_t size = sizeof(Block) + alignment + bytes;
+		if (size < block_size) size = block_size;
+		Block* block = static_cast<Block*>(malloc(size));
+		if (!block) throw std::bad_alloc{};
+		block->next = blocks;
+		block->size = size;
+		blocks = block;
+		current = reinterpret_cast<char*>(block + 1);
+		limit = reinterpret_cast<char*>(block) + size;
+		last = nullptr;
+		reserved_bytes += size;
+	}
+
+	inline void * Arena::allocate(size_t bytes, size_t alignment)
+	{
+		char* p = _align(current, alignment);
+		if (!current || p > limit || bytes > size_t(limit - p))
+		{
+			_grow(bytes, alignment);
+			p = _align(current, alignment);
+		}
+		last = p;
+		current = p + bytes;
+		used_bytes += bytes;
+		return p;
+	}
+
+	inline void Arena::deallocate(void * p, size_t bytes) noexcept
+	{
+		if (p && p == last && last + bytes == current)
+		{
+			current = last;
+			last = nullptr;
+			used_bytes -= bytes;
+		}
+	}
+
+	inline void * Arena::reallocate(void * p, size_t old_bytes, size_t new_bytes, size_t alignment)
+	{
+		if (!p) return allocate(new_bytes, alignment);
+		char* block = static_cast<char*>(p);
+		if (block == last && block + old_bytes == current && new_bytes <= size_t(limit - block))
+		{
+			//The most recent allocation, grow or shrink it where it is
+			current = block + new_bytes;
+			used_bytes = used_bytes - old_bytes + new_bytes;
+			return p;
+		}
+		void* moved = allocate(new_bytes, alignment);
+		memcpy(moved, p, old_bytes < new_bytes ? old_bytes : new_bytes);
+		return moved;
+	}
+
+	inline void Arena::reset() noexcept
+	{
+		if (!blocks) return;
+		Block* next = blocks->next;
+		while (next)
+		{
+			Block* after = next->next;
+			reserved_bytes -= next->size;
+			free(next);
+			next = after;
+		}
+		blocks->next = nullptr;
+		current = reinterpret_cast<char*>(blocks + 1);
+		last = nullptr;
+		used_bytes = 0;
+	}
+
+	inline size_t Arena::used() const noexcept
+	{
+		return used_bytes;
+	}
+
+	inline size_t Arena::reserved() const noexcept
+	{
+		return reserved_bytes;
+	}
+
+	template<typename T>
+	inline T * ArenaAllocator<T>::allocate(size_t n)
+	{
+		return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T)));
+	}
+
+	template<typename T>
+	inline void ArenaAllocator<T>::deallocate(T * p, size_t n) noexcept
+	{
+		arena->deallocate(p, n * sizeof(T));
+	}
+
+	template<typename T>
+	inline T * ArenaAllocator<T>::reallocate(T * p, size_t old_n, size_t new_n)
+	{
+		return static_cast<T*>(arena->reallocate(p, old_n * sizeof(T), new_n * sizeof(T), alignof(T)));
+	}
+
+	template<typename T>
+	inline Arena & ArenaAllocator<T>::get_arena() const noexcept
+	{
+		return *arena;
+	}
+
+	inline NodePool::NodePool(size_t _slab_size) noexcept : slab_size(_slab_size)
+	{
+	}
+
+	inline NodePool::~NodePool()
+	{
+		while (slabs)
+		{
+			Slab* next = slabs->next;
+			free(slabs);
+			slabs = next;
+		}
+	}
+
+	inline void NodePool::_grow()
+	{
+		size_t header = (sizeof(Slab) + NODE_POOL_GRANULE - 1) / NODE_POOL_GRANULE * NODE_POOL_GRANULE;
+		size_t size = header + (slab_size > NODE_POOL_MAX_NODE ? slab_size : NODE_POOL_MAX_NODE);
+		Slab* slab = static_cast<Slab*>(malloc(size));
+		if (!slab) throw std::bad_alloc{};
+		slab->next = slabs;
+		slab->size = size;
+		slabs = slab;
+		current = reinterpret_cast<char*>(slab) + header;
+		limit = reinterpret_cast<char*>(slab) + size;
+		reserved_bytes += size;
+	}
+
+	inline void * NodePool::allocate(size_t bytes)
+	{
+		if (bytes == 0) bytes = 1;
+		if (bytes > NODE_POOL_MAX_NODE)
+		{
+			void* p = malloc(bytes);
+			if (!p) throw std::bad_alloc{};
+			return p;
+		}
+		size_t size_class = (bytes - 1) / NODE_POOL_GRANULE;
+		bytes = (size_class + 1) * NODE_POOL_GRANULE;
+		if (FreeNode* node = free_lists[size_class])
+		{
+			free_lists[size_class] = node->next;
+			used_bytes += bytes;
+			return node;
+		}
+		//The tail of a slab too short for this node is left unused
+		if (!current || bytes > size_t(limit - current))
+			_grow();
+		void* p = current;
+		current += bytes;
+		used_bytes += bytes;	//Only once _grow() can no longer throw
+		return p;
+	}
+
+	inline void NodePool::deallocate(void * p, size_t bytes) noexcept
+	{
+		if (!p) return;
+		if (bytes == 0) bytes = 1;
+		if (bytes > NODE_POOL_MAX_NODE)
+		{
+			free(p);
+			return;
+		}
+		size_t size_class = (bytes - 1) / NODE_POOL_GRANULE;
+		used_bytes -= (size_class + 1) * NODE_POOL_GRANULE;
+		FreeNode* node = static_cast<FreeNode*>(p);
+		node->next = free_lists[size_class];
+		free_lists[size_class] = node;
+	}
+
+	inline size_t NodePool::used() const noexcept
+	{
+		return used_bytes;
+	}
+
+	inline size_t NodePool::reserved() const noexcept
+	{
+		return reserved_bytes;
+	}
+
+	template<typename T>
+	inline T * PoolAllocator<T>::allocate(size_t n)
+	{
+		static_assert(alignof(T) <= NODE_POOL_GRANULE, "NodePool cannot align nodes beyond max_align_t");
+		return static_cast<T*>(pool->allocate(n * sizeof(T)));
+	}
+
+	template<typename T>
+	inline void PoolAllocator<T>::deallocate(T * p, size_t n) noexcept
+	{
+		pool->deallocate(p, n * sizeof(T));
+	}
+
+	template<typename T>
+	inline NodePool & PoolAllocator<T>::get_pool() const noexcept
+	{
+		return *pool;
+	}
+}
@@ -1,21 +1,30 @@
 #pragma once
 #include <stdexcept>
 #include <string>
+#include <istream>
+#include <locale>
+#include "Allocator.h"
+#include "NumericConversion.h"
+#include "SIMD.h"
 
 #define MAX_STRING_SIZE -1U
 
 namespace DataStructures
 {
-	template<typename CharT = char, typename Traits = std::char_traits<CharT>> class BasicString;
+	template<typename CharT = char, typename Traits = std::char_traits<CharT>, class Allocator = MallocAllocator<CharT>> class BasicString;
+	template<typename CharT, typename Traits> class BasicSharedString;
 	using String = BasicString<char>;
 	using WString = BasicString<wchar_t>;
+	using U16String = BasicString<char16_t>;
+	using U32String = BasicString<char32_t>;
 
-	template<typename CharT, typename Traits>
+	template<typename CharT, typename Traits, class Allocator>
 	class BasicString
 	{
 	public:
 		using traits_type = Traits;
 		using value_type = CharT;
+		using allocator_type = Allocator;
 		using size_type = size_t;
 		using difference_type = ptrdiff_t;
 		using reference = CharT&;
@@ -32,16 +41,19 @@ namespace DataStructures
 
 		//Constructor, Destructor and Assignment
 		explicit BasicString() noexcept;
-		explicit BasicString(size_type n, const CharT& val);
-		BasicString(const BasicString& other, size_type pos, size_type n = npos);
-		BasicString(const CharT* s, size_type n);
-		BasicString(const CharT* s);
+		explicit BasicString(const Allocator& alloc) noexcept;
+		explicit BasicString(size_type n, const CharT& val, const Allocator& alloc = Allocator());
+		BasicString(const BasicString& other, size_type pos, size_type n = npos, const Allocator& alloc = Allocator());
+		BasicString(const CharT* s, size_type n, const Allocator& alloc = Allocator());
+		BasicString(const CharT* s, const Allocator& alloc = Allocator());
 		template<typename InputIterator, typename = typename std::enable_if_t<std::_Is_iterator<InputIterator>::value>>
-		BasicString(InputIterator first, InputIterator last);
-		BasicString(std::initializer_list<CharT> init);
+		BasicString(InputIterator first, InputIterator last, const Allocator& alloc = Allocator());
+		BasicString(std::initializer_list<CharT> init, const Allocator& alloc = Allocator());
 
 		BasicString(const BasicString& origin);
+		BasicString(const BasicString& origin, const Allocator& alloc);
 		BasicString(BasicString&& origin) noexcept;
+		BasicString(BasicString&& origin, const Allocator& alloc);
 		~BasicString();
 
 		BasicString& operator=(const BasicString& origin);
@@ -60,6 +72,8 @@ namespace DataStructures
 		BasicString& assign(InputIterator first, InputIterator last);
 		BasicString& assign(std::initializer_list<CharT> init);
 
+		allocator_type get_allocator() const;
+
 		//Element access
 		reference at(size_type index);				//Check and throw out_of_range exception
 		const_reference at(size_type index) const;
@@ -130,6 +144,9 @@ namespace DataStructures
 		BasicString& operator+=(const CharT* s);
 		BasicString& operator+=(std::initializer_list<CharT> init);
 
+		//Builds a string from strings, C strings and characters, measuring each once and allocating once
+		template<typename ... Pieces> static BasicString concat(const Pieces& ... pieces);
+
 		int compare(const BasicString& str) const;
 		int compare(size_type pos1, size_type count1, const BasicString& str) const;
 		int compare(size_type pos1, size_type count1, const BasicString& str, size_type pos2, size_type count2 = npos) const;
@@ -194,108 +211,52 @@ namespace DataStructures
 		size_type find_last_not_of(const CharT* s, size_type pos = npos) const;
 		size_type find_last_not_of(CharT ch, size_type pos = npos) const;
 
+		//ASCII operations
+		//In place and vectorized for char. Only ASCII letters and whitespace are touched, so UTF-8 text stays intact.
+		BasicString& to_lower();
+		BasicString& to_upper();
+		BasicString& trim();						//Strip leading and trailing whitespace
+		BasicString& ltrim();
+		BasicString& rtrim();
+		BasicString& collapse_whitespace();			//Every run of whitespace becomes a single space
+		BasicString& replace_all(CharT from, CharT to);
+		int compare_ignore_case(const BasicString& str) const;
+		int compare_ignore_case(const CharT* s) const;
+		size_type find_ignore_case(const BasicString& str, size_type pos = 0) const;
+		size_type find_ignore_case(const CharT* s, size_type pos, size_type count) const;
+		size_type find_ignore_case(const CharT* s, size_type pos = 0) const;
+
+		//BasicSharedString takes over the storage of a string moved into it
+		template<typename, typename> friend class BasicSharedString;
 
 		//Non-Member Functions
-		template<typename CharT, typename Traits>
-		friend BasicString<CharT, Traits> operator+(const BasicString<CharT, Traits>& lhs, const BasicString<CharT, Traits>& rhs);
-		template<typename CharT, typename Traits>
-		friend BasicString<CharT, Traits> operator+(const CharT* lhs, const BasicString<CharT, Traits>& rhs);
-		template<typename CharT, typename Traits>
-		friend BasicString<CharT, Traits> operator+(CharT lhs, const BasicString<CharT, Traits>& rhs);
-		template<typename CharT, typename Traits>
-		friend BasicString<CharT, Traits> operator+(const BasicString<CharT, Traits>& lhs, const CharT* rhs);
-		template<typename CharT, typename Traits>
-		friend BasicString<CharT, Traits> operator+(const BasicString<CharT, Traits>& lhs, CharT rhs);
-		template<typename CharT, typename Traits>
-		friend BasicString<CharT, Traits> operator+(BasicString<CharT, Traits>&& lhs, const BasicString<CharT, Traits>& rhs);
-		template<typename CharT, typename Traits>
-		friend BasicString<CharT, Traits> operator+(const BasicString<CharT, Traits>& lhs, BasicString<CharT, Traits>&& rhs);
-		template<typename CharT, typename Traits>
-		friend BasicString<CharT, Traits> operator+(BasicString<CharT, Traits>&& lhs, BasicString<CharT, Traits>&& rhs);
-		template<typename CharT, typename Traits>
-		friend BasicString<CharT, Traits> operator+(const CharT* lhs, BasicString<CharT, Traits>&& rhs);
-		template<typename CharT, typename Traits>
-		friend BasicString<CharT, Traits> operator+(CharT lhs, BasicString<CharT, Traits>&& rhs);
-		template<typename CharT, typename Traits>
-		friend BasicString<CharT, Traits> operator+(BasicString<CharT, Traits>&& lhs, const CharT* rhs);
-		template<typename CharT, typename Traits>
-		friend BasicString<CharT, Traits> operator+(BasicString<CharT, Traits>&& lhs, CharT rhs);
-
-		template<typename CharT, typename Traits> friend bool operator==(const BasicString<CharT, Traits>& lhs, const BasicString<CharT, Traits>& rhs);
-		template<typename CharT, typename Traits> friend bool operator!=(const BasicString<CharT, Traits>& lhs, const BasicString<CharT, Traits>& rhs);
-		template<typename CharT, typename Traits> friend bool operator<(const BasicString<CharT, Traits>& lhs, const BasicString<CharT, Traits>& rhs);
-		template<typename CharT, typename Traits> friend bool operator<=(const BasicString<CharT, Traits>& lhs, const BasicString<CharT, Traits>& rhs);
-		template<typename CharT, typename Traits> friend bool operator>(const BasicString<CharT, Traits>& lhs, const BasicString<CharT, Traits>& rhs);
-		template<typename CharT, typename Traits> friend bool operator>=(const BasicString<CharT, Traits>& lhs, const BasicString<CharT, Traits>& rhs);
-
-		template<typename CharT, typename Traits> friend bool operator==(const CharT* lhs, const BasicString<CharT, Traits>& rhs);
-		template<typename CharT, typename Traits> friend bool operator!=(const CharT* lhs, const BasicString<CharT, Traits>& rhs);
-		template<typename CharT, typename Traits> friend bool operator<(const CharT* lhs, const BasicString<CharT, Traits>& rhs);
-		template<typename CharT, typename Traits> friend bool operator<=(const CharT* lhs, const BasicString<CharT, Traits>& rhs);
-		template<typename CharT, typename Traits> friend bool operator>(const CharT* lhs, const BasicString<CharT, Traits>& rhs);
-		template<typename CharT, typename Traits> friend bool operator>=(const CharT* lhs, const BasicString<CharT, Traits>& rhs);
-		template<typename CharT, typename Traits> friend bool operator==(const BasicString<CharT, Traits>& lhs, const CharT* rhs);
-		template<typename CharT, typename Traits> friend bool operator!=(const BasicString<CharT, Traits>& lhs, const CharT* rhs);
-		template<typename CharT, typename Traits> friend bool operator<(const BasicString<CharT, Traits>& lhs, const CharT* rhs);
-		template<typename CharT, typename Traits> friend bool operator<=(const BasicString<CharT, Traits>& lhs, const CharT* rhs);
-		template<typename CharT, typename Traits> friend bool operator>(const BasicString<CharT, Traits>& lhs, const CharT* rhs);
-		template<typename CharT, typename Traits> friend bool operator>=(const BasicString<CharT, Traits>& lhs, const CharT* rhs);
-
-		template<typename CharT, typename Traits> friend void swap(BasicString<CharT, Traits>& lhs, BasicString<CharT, Traits>& rhs) noexcept;
-
-		template <typename CharT, typename Traits> friend
-		std::basic_ostream<CharT, Traits>& operator<<(std::basic_ostream<CharT, Traits>& os, const BasicString<CharT, Traits>& str);
-		template <typename CharT, typename Traits> friend
-		std::basic_istream<CharT, Traits>& operator >> (std::basic_istream<CharT, Traits>& is, BasicString<CharT, Traits>& str);
-
-		template<typename CharT, typename Traits> friend
-		std::basic_istream<CharT, Traits>& getline(std::basic_istream<CharT, Traits>& input, BasicString<CharT, Traits>& str, CharT delim);
-		template<typename CharT, typename Traits> friend
-		std::basic_istream<CharT, Traits>& getline(std::basic_istream<CharT, Traits>&& input, BasicString<CharT, Traits>& str, CharT delim);
-		template<typename CharT, typename Traits> friend
-		std::basic_istream<CharT, Traits>& getline(std::basic_istream<CharT, Traits>& input, BasicString<CharT, Traits>& str);
-		template<typename CharT, typename Traits> friend
-		std::basic_istream<CharT, Traits>& getline(std::basic_istream<CharT, Traits>&& input, BasicString<CharT, Traits>& str);
-
-		//Numeric conversions
-		friend int       stoi(const String& str, std::size_t* pos, int base);
-		friend int       stoi(const WString& str, std::size_t* pos, int base);
-		friend long      stol(const String& str, std::size_t* pos, int base);
-		friend long      stol(const WString& str, std::size_t* pos, int base);
-		friend long long stoll(const String& str, std::size_t* pos, int base);
-		friend long long stoll(const WString& str, std::size_t* pos, int base);
-
-		friend unsigned long      stoul(const String& str, std::size_t* pos, int base);
-		friend unsigned long      stoul(const WString& str, std::size_t* pos, int base);
-		friend unsigned long long stoull(const String& str, std::size_t* pos, int base);
-		friend unsigned long long stoull(const WString& str, std::size_t* pos, int base);
-
-		friend float       stof(const String& str, std::size_t* pos);
-		friend float       stof(const WString& str, std::size_t* pos);
-		friend double      stod(const String& str, std::size_t* pos);
-		friend double      stod(const WString& str, std::size_t* pos);
-		friend long double stold(const String& str, std::size_t* pos);
-		friend long double stold(const WString& str, std::size_t* pos);
-
-		friend String to_string(int value);
-		friend String to_string(long value);
-		friend String to_string(long long value);
-		friend String to_string(unsigned value);
-		friend String to_string(unsigned long value);
-		friend String to_string(unsigned long long value);
-		friend String to_string(float value);
-		friend String to_string(double value);
-		friend String to_string(long double value);
-
-		friend WString to_wstring(int value);
-		friend WString to_wstring(long value);
-		friend WString to_wstring(long long value);
-		friend WString to_wstring(unsigned value);
-		friend WString to_wstring(unsigned long value);
-		friend WString to_wstring(unsigned long long value);
-		friend WString to_wstring(float value);
-		friend WString to_wstring(double value);
-		friend WString to_wstring(long double value);
+		//operator+ is not a friend. It is defined after the class on top of concat() and append(), see Concatenation.
+
+		template<typename CharT, typename Traits, class Allocator> friend bool operator==(const BasicString<CharT, Traits, Allocator>& lhs, const BasicString<CharT, Traits, Allocator>& rhs);
+		template<typename CharT, typename Traits, class Allocator> friend bool operator!=(const BasicString<CharT, Traits, Allocator>& lhs, const BasicString<CharT, Traits, Allocator>& rhs);
+		template<typename CharT, typename Traits, class Allocator> friend bool operator<(const BasicString<CharT, Traits, Allocator>& lhs, const BasicString<CharT, Traits, Allocator>& rhs);
+		template<typename CharT, typename Traits, class Allocator> friend bool operator<=(const BasicString<CharT, Traits, Allocator>& lhs, const BasicString<CharT, Traits, Allocator>& rhs);
+		template<typename CharT, typename Traits, class Allocator> friend bool operator>(const BasicString<CharT, Traits, Allocator>& lhs, const BasicString<CharT, Traits, Allocator>& rhs);
+		template<typename CharT, typename Traits, class Allocator> friend bool operator>=(const BasicString<CharT, Traits, Allocator>& lhs, const BasicString<CharT, Traits, Allocator>& rhs);
+
+		template<typename CharT, typename Traits, class Allocator> friend bool operator==(const CharT* lhs, const BasicString<CharT, Traits, Allocator>& rhs);
+		template<typename CharT, typename Traits, class Allocator> friend bool operator!=(const CharT* lhs, const BasicString<CharT, Traits, Allocator>& rhs);
+		template<typename CharT, typename Traits, class Allocator> friend bool operator<(const CharT* lhs, const BasicString<CharT, Traits, Allocator>& rhs);
+		template<typename CharT, typename Traits, class Allocator> friend bool operator<=(const CharT* lhs, const BasicString<CharT, Traits, Allocator>& rhs);
+		template<typename CharT, typename Traits, class Allocator> friend bool operator>(const CharT* lhs, const BasicString<CharT, Traits, Allocator>& rhs);
+		template<typename CharT, typename Traits, class Allocator> friend bool operator>=(const CharT* lhs, const BasicString<CharT, Traits, Allocator>& rhs);
+		template<typename CharT, typename Traits, class Allocator> friend bool operator==(const BasicString<CharT, Traits, Allocator>& lhs, const CharT* rhs);
+		template<typename CharT, typename Traits, class Allocator> friend bool operator!=(const BasicString<CharT, Traits, Allocator>& lhs, const CharT* rhs);
+		template<typename CharT, typename Traits, class Allocator> friend bool operator<(const BasicString<CharT, Traits, Allocator>& lhs, const CharT* rhs);
+		template<typename CharT, typename Traits, class Allocator> friend bool operator<=(const BasicString<CharT, Traits, Allocator>& lhs, const CharT* rhs);
+		template<typename CharT, typename Traits, class Allocator> friend bool operator>(const BasicString<CharT, Traits, Allocator>& lhs, const CharT* rhs);
+		template<typename CharT, typename Traits, class Allocator> friend bool operator>=(const BasicString<CharT, Traits, Allocator>& lhs, const CharT* rhs);
+
+		template<typename CharT, typename Traits, class Allocator> friend void swap(BasicString<CharT, Traits, Allocator>& lhs, BasicString<CharT, Traits, Allocator>& rhs) noexcept;
+
+		//operator<<, operator>> and getline are not friends. They are defined after the class, see Input and output.
+
+		//Numeric conversions are not friends. They are defined after the class on top of NumericConversion.h.
 
 		//Literals
 		//operator""s
@@ -304,31 +265,53 @@ namespace DataStructures
 		//hash(const String&)
 
 	private:
-		size_type reserved_size = 1;
+		size_type reserved_size = 0;
 		size_type string_length = 0;
-		char* storage = nullptr;
+		char* storage = nullptr;					//Null after being moved from
+		Allocator allocator;
 
-		inline void _reallocate(size_type rsv_sz);
+		inline void _reallocate(size_type rsv_sz);	//In place if the allocator has reallocate()
 		inline void _move_storage(CharT* dest, CharT* from, size_type n);
-		inline void _allocate(size_type rsv_sz);	//malloc some storage and set reserved_size to rsv_sz
+		inline void _allocate(size_type rsv_sz);	//Allocate some storage and set reserved_size to rsv_sz
+		inline void _deallocate();
 		template <typename ... Args> inline void _construct(size_type pos, Args&& ... args);
 		template <typename ... Args> inline void _construct(iterator iter, Args&& ... args);
 		inline void _add_null_char(size_type pos);
+
+		struct _Unallocated {};
+		BasicString(_Unallocated, const Allocator& alloc) noexcept;	//No storage yet, for concat() to allocate the exact size
+
+		static Allocator _concat_allocator();
+		template<typename ... Pieces> static const Allocator& _concat_allocator(const BasicString& str, const Pieces& ... pieces) noexcept;
+		template<typename Piece, typename ... Pieces> static Allocator _concat_allocator(const Piece& piece, const Pieces& ... pieces);
+
+		static size_type _concat_size(size_type* lengths) noexcept;
+		template<typename Piece, typename ... Pieces> static size_type _concat_size(size_type* lengths, const Piece& piece, const Pieces& ... pieces);
+		static void _concat_copy(CharT* dest, const size_type* lengths) noexcept;
+		template<typename Piece, typename ... Pieces> static void _concat_copy(CharT* dest, const size_type* lengths, const Piece& piece, const Pieces& ... pieces);
+		template<class OtherAllocator> static size_type _piece_length(const BasicString<CharT, Traits, OtherAllocator>& str) noexcept;
+		static size_type _piece_length(const CharT* s) noexcept;
+		static size_type _piece_length(const CharT& ch) noexcept;
+		template<class OtherAllocator> static const CharT* _piece_data(const BasicString<CharT, Traits, OtherAllocator>& str) noexcept;
+		static const CharT* _piece_data(const CharT* s) noexcept;
+		static const CharT* _piece_data(const CharT& ch) noexcept;
 	};
 
 	/* Dividing Line ( 㧥 ;) ( 㧥 ;) ( 㧥 ;)  */
 	#define Tstorage reinterpret_cast<CharT*>(storage)
 	#define Tsize sizeof(CharT)
 
-	template<typename CharT, typename Traits>
-	inline void BasicString<CharT, Traits>::_reallocate(size_type rsv_sz)
+	template<typename CharT, typename Traits, class Allocator>
+	inline void BasicString<CharT, Traits, Allocator>::_reallocate(size_type rsv_sz)
 	{
+		size_type old_size = storage ? reserved_size + 1 : 0;
+		size_type kept = storage ? (string_length < rsv_sz ? string_length : rsv_sz) + 1 : 0;
+		storage = reinterpret_cast<char*>(_allocator_reallocate(allocator, Tstorage, old_size, rsv_sz + 1, kept));
 		reserved_size = rsv_sz;
-		storage = reinterpret_cast<char*>(realloc(storage, (reserved_size + 1) * Tsize));
 	}
 
-	template<typename CharT, typename Traits>
-	inline void BasicString<CharT, Traits>::_move_storage(CharT * dest, CharT * from, size_type n)
+	template<typename CharT, typename Traits, class Allocator>
+	inline void BasicString<CharT, Traits, Allocator>::_move_storage(CharT * dest, CharT * from, size_type n)
 	{
 		if (dest < from)
 		{
@@ -346,42 +329,57 @@ namespace DataStructures
 			return;
 	}
 
-	template<typename CharT, typename Traits>
-	inline void BasicString<CharT, Traits>::_allocate(size_type rsv_sz)
+	template<typename CharT, typename Traits, class Allocator>
+	inline void BasicString<CharT, Traits, Allocator>::_allocate(size_type rsv_sz)
 	{
 		reserved_size = rsv_sz;
-		storage = reinterpret_cast<char*>(malloc((reserved_size + 1) * Tsize));
+		storage = reinterpret_cast<char*>(std::allocator_traits<Allocator>::allocate(allocator, reserved_size + 1));
 	}
 
-	template<typename CharT, typename Traits>
-	inline void BasicString<CharT, Traits>::_add_null_char(size_type pos)
+	template<typename CharT, typename Traits, class Allocator>
+	inline void BasicString<CharT, Traits, Allocator>::_deallocate()
 	{
-		new(Tstorage + pos) CharT(0);	//How to get a null character?
+		if (storage)
+			std::allocator_traits<Allocator>::deallocate(allocator, Tstorage, reserved_size + 1);
 	}
 
-	template<typename CharT, typename Traits>
+	template<typename CharT, typename Traits, class Allocator>
+	inline void BasicString<CharT, Traits, Allocator>::_add_null_char(size_type pos)
+	{
+		if (storage)
+			new(Tstorage + pos) CharT(0);	//How to get a null character?
+	}
+
+	template<typename CharT, typename Traits, class Allocator>
 	template<typename ...Args>
-	inline void BasicString<CharT, Traits>::_construct(size_type pos, Args && ...args)
+	inline void BasicString<CharT, Traits, Allocator>::_construct(size_type pos, Args && ...args)
 	{
 		new(Tstorage + pos) CharT(std::forward<Args>(args) ...);
 	}
 
-	template<typename CharT, typename Traits>
+	template<typename CharT, typename Traits, class Allocator>
 	template<typename ...Args>
-	inline void BasicString<CharT, Traits>::_construct(iterator iter, Args && ...args)
+	inline void BasicString<CharT, Traits, Allocator>::_construct(iterator iter, Args && ...args)
 	{
 		new(iter) CharT(std::forward<Args>(args) ...);
 	}
 
-	template<typename CharT, typename Traits>
-	inline BasicString<CharT, Traits>::BasicString() noexcept : string_length(0)
+	template<typename CharT, typename Traits, class Allocator>
+	inline BasicString<CharT, Traits, Allocator>::BasicString() noexcept : string_length(0), allocator()
 	{
 		_allocate(0);
 		_add_null_char(string_length);
 	}
 
-	template<typename CharT, typename Traits>
-	inline BasicString<CharT, Traits>::BasicString(size_type n, const CharT & val) : string_length(0)
+	template<typename CharT, typename Traits, class Allocator>
+	inline BasicString<CharT, Traits, Allocator>::BasicString(const Allocator & alloc) noexcept : string_length(0), allocator(alloc)
+	{
+		_allocate(0);
+		_add_null_char(string_length);
+	}
+
+	template<typename CharT, typename Traits, class Allocator>
+	inline BasicString<CharT, Traits, Allocator>::BasicString(size_type n, const CharT & val, const Allocator & alloc) : string_length(0), allocator(alloc)
 	{
 		_allocate(n);
 		while (string_length < n)
@@ -393,8 +391,8 @@ namespace DataStructures
 		_add_null_char(string_length);
 	}
 
-	template<typename CharT, typename Traits>
-	inline BasicString<CharT, Traits>::BasicString(const BasicString & other, size_type pos, size_type n) : string_length(0)
+	template<typename CharT, typename Traits, class Allocator>
+	inline BasicString<CharT, Traits, Allocator>::BasicString(const BasicString & other, size_type pos, size_type n, const Allocator & alloc) : string_length(0), allocator(alloc)
 	{
 		if (pos < other.size() && n <= other.size() - pos)	//Caution! Overflow may occur!
 		{
@@ -416,8 +414,8 @@ namespace DataStructures
 		_add_null_char(string_length);
 	}
 
-	template<typename CharT, typename Traits>
-	inline BasicString<CharT, Traits>::BasicString(const CharT * s, size_type n) : string_length(0)
+	template<typename CharT, typename Traits, class Allocator>
+	inline BasicString<CharT, Traits, Allocator>::BasicString(const CharT * s, size_type n, const Allocator & alloc) : string_length(0), allocator(alloc)
 	{
 		_allocate(n);
 		memcpy(storage, s, n * Tsize);
@@ -425,8 +423,8 @@ namespace DataStructures
 		_add_null_char(string_length);
 	}
 
-	template<typename CharT, typename Traits>
-	inline BasicString<CharT, Traits>::BasicString(const CharT * s) : string_length(0)
+	template<typename CharT, typename Traits, class Allocator>
+	inline BasicString<CharT, Traits, Allocator>::BasicString(const CharT * s, const Allocator & alloc) : string_length(0), allocator(alloc)
 	{
 		size_type n = Traits::length(s);
 		_allocate(n);
@@ -435,8 +433,8 @@ namespace DataStructures
 		_add_null_char(string_length);
 	}
 
-	template<typename CharT, typename Traits>
-	inline BasicString<CharT, Traits>::BasicString(std::initializer_list<CharT> init) : string_length(0)
+	template<typename CharT, typename Traits, class Allocator>
+	inline BasicString<CharT, Traits, Allocator>::BasicString(std::initializer_list<CharT> init, const Allocator & alloc) : string_length(0), allocator(alloc)
 	{
 		size_type n = init.size();
 		_allocate(n);
@@ -449,8 +447,13 @@ namespace DataStructures
 		_add_null_char(string_length);
 	}
 
-	template<typename CharT, typename Traits>
-	inline BasicString<CharT, Traits>::BasicString(const BasicString & origin) : string_length(0)
+	template<typename CharT, typename Traits, class Allocator>
+	inline BasicString<CharT, Traits, Allocator>::BasicString(const BasicString & origin) : BasicString(origin, origin.allocator)
+	{
+	}
+
+	template<typename CharT, typename Traits, class Allocator>
+	inline BasicString<CharT, Traits, Allocator>::BasicString(const BasicString & origin, const Allocator & alloc) : string_length(0), allocator(alloc)
 	{
 		_allocate(origin.string_length);
 		memcpy(storage, origin.storage, Tsize * origin.string_length);
@@ -458,107 +461,134 @@ namespace DataStructures
 		_add_null_char(string_length);
 	}
 
-	template<typename CharT, typename Traits>
-	inline BasicString<CharT, Traits>::BasicString(BasicString && origin) noexcept
+	template<typename CharT, typename Traits, class Allocator>
+	inline BasicString<CharT, Traits, Allocator>::BasicString(BasicString && origin) noexcept : allocator(origin.allocator)
 	{
 		swap(origin);
 	}
 
-	template<typename CharT, typename Traits>
-	inline BasicString<CharT, Traits>::~BasicString()
+	template<typename CharT, typename Traits, class Allocator>
+	inline BasicString<CharT, Traits, Allocator>::BasicString(BasicString && origin, const Allocator & alloc) : allocator(alloc)
 	{
-		clear();
-		free(storage);
+		if (allocator == origin.allocator)
+		{
+			swap(origin);
+			return;
+		}
+		_allocate(origin.string_length);
+		memcpy(storage, origin.storage, Tsize * origin.string_length);
+		string_length = origin.string_length;
+		_add_null_char(string_length);
 	}
 
-	template<typename CharT, typename Traits>
-	inline BasicString<CharT, Traits> & BasicString<CharT, Traits>::operator=(const BasicString & origin)
+	template<typename CharT, typename Traits, class Allocator>
+	inline BasicString<CharT, Traits, Allocator>::~BasicString()
+	{
+		for (size_t i = 0; i < string_length; i++)	//Not clear(), a moved-from string has no storage to write the null character to
+			Tstorage[i].~CharT();
+		_deallocate();
+	}
+
+	template<typename CharT, typename Traits, class Allocator>
+	inline BasicString<CharT, Traits, Allocator> & BasicString<CharT, Traits, Allocator>::operator=(const BasicString & origin)
 	{
 		return assign(origin);
 	}
 
-	template<typename CharT, typename Traits>
-	inline BasicString<CharT, Traits> & BasicString<CharT, Traits>::operator=(BasicString && origin)
+	template<typename CharT, typename Traits, class Allocator>
+	inline BasicString<CharT, Traits, Allocator> & BasicString<CharT, Traits, Allocator>::operator=(BasicString && origin)
 	{
 		return assign(std::move(origin));
 	}
 
-	template<typename CharT, typename Traits>
-	inline BasicString<CharT, Traits> & BasicString<CharT, Traits>::operator=(const CharT * s)
+	template<typename CharT, typename Traits, class Allocator>
+	inline BasicString<CharT, Traits, Allocator> & BasicString<CharT, Traits, Allocator>::operator=(const CharT * s)
 	{
 		return assign(s);
 	}
 
-	template<typename CharT, typename Traits>
-	inline BasicString<CharT, Traits> & BasicString<CharT, Traits>::operator=(CharT ch)
+	template<typename CharT, typename Traits, class Allocator>
+	inline BasicString<CharT, Traits, Allocator> & BasicString<CharT, Traits, Allocator>::operator=(CharT ch)
 	{
 		return assign(1, ch);
 	}
 
-	template<typename CharT, typename Traits>
-	inline BasicString<CharT, Traits> & BasicString<CharT, Traits>::operator=(std::initializer_list<CharT> init)
+	template<typename CharT, typename Traits, class Allocator>
+	inline BasicString<CharT, Traits, Allocator> & BasicString<CharT, Traits, Allocator>::operator=(std::initializer_list<CharT> init)
 	{
 		return assign(init);
 	}
 
-	template<typename CharT, typename Traits>
-	inline BasicString<CharT, Traits> & BasicString<CharT, Traits>::assign(size_type n, CharT ch)
+	template<typename CharT, typename Traits, class Allocator>
+	inline BasicString<CharT, Traits, Allocator> & BasicString<CharT, Traits, Allocator>::assign(size_type n, CharT ch)
 	{
-		swap(BasicString(n, ch));
+		swap(BasicString(n, ch, allocator));
 		return *this;
 	}
 
-	template<typename CharT, typename Traits>
-	inline BasicString<CharT, Traits> & BasicString<CharT, Traits>::assign(const BasicString & origin)
+	template<typename CharT, typename Traits, class Allocator>
+	inline BasicString<CharT, Traits, Allocator> & BasicString<CharT, Traits, Allocator>::assign(const BasicString & origin)
 	{
 		if (this != &origin)
 		{
-			swap(BasicString(origin));
+			swap(BasicString(origin, allocator));
 		}
 		return *this;
 	}
 
-	template<typename CharT, typename Traits>
-	inline BasicString<CharT, Traits> & BasicString<CharT, Traits>::assign(const BasicString & origin, size_type pos, size_type n)
+	template<typename CharT, typename Traits, class Allocator>
+	inline BasicString<CharT, Traits, Allocator> & BasicString<CharT, Traits, Allocator>::assign(const BasicString & origin, size_type pos, size_type n)
 	{
-		swap(BasicString(origin, pos, n));
+		swap(BasicString(origin, pos, n, allocator));
 		return *this;
 	}
 
-	template<typename CharT, typename Traits>
-	inline BasicString<CharT, Traits> & BasicString<CharT, Traits>::assign(BasicString && origin)
+	template<typename CharT, typename Traits, class Allocator>
+	inline BasicString<CharT, Traits, Allocator> & BasicString<CharT, Traits, Allocator>::assign(BasicString && origin)
 	{
 		if (this != &origin)
 		{
-			swap(origin);
+			if (allocator == origin.allocator)
+				swap(origin);
+			else
+			{
+				BasicString copy(origin.data(), origin.size(), allocator);	//Storage cannot change hands between allocators
+				swap(copy);
+			}
 		}
 		return *this;
 	}
 
-	template<typename CharT, typename Traits>
-	inline BasicString<CharT, Traits> & BasicString<CharT, Traits>::assign(const CharT * s, size_type n)
+	template<typename CharT, typename Traits, class Allocator>
+	inline typename BasicString<CharT, Traits, Allocator>::allocator_type BasicString<CharT, Traits, Allocator>::get_allocator() const
+	{
+		return allocator;
+	}
+
+	template<typename CharT, typename Traits, class Allocator>
+	inline BasicString<CharT, Traits, Allocator> & BasicString<CharT, Traits, Allocator>::assign(const CharT * s, size_type n)
 	{
-		swap(BasicString(s, n));
+		swap(BasicString(s, n, allocator));
 		return *this;
 	}
 
-	template<typename CharT, typename Traits>
-	inline BasicString<CharT, Traits> & BasicString<CharT, Traits>::assign(const CharT * s)
+	template<typename CharT, typename Traits, class Allocator>
+	inline BasicString<CharT, Traits, Allocator> & BasicString<CharT, Traits, Allocator>::assign(const CharT * s)
 	{
-		swap(BasicString(s));
+		swap(BasicString(s, allocator));
 		return *this;
 	}
 
-	template<typename CharT, typename Traits>
-	inline BasicString<CharT, Traits> & BasicString<CharT, Traits>::assign(std::initializer_list<CharT> init)
+	template<typename CharT, typename Traits, class Allocator>
+	inline BasicString<CharT, Traits, Allocator> & BasicString<CharT, Traits, Allocator>::assign(std::initializer_list<CharT> init)
 	{
-		swap(BasicString(init));
+		swap(BasicString(init, allocator));
 		return *this;
 	}
 
-	template<typename CharT, typename Traits>
+	template<typename CharT, typename Traits, class Allocator>
 	template<typename InputIterator, typename SFINAE_MAGIC>
-	inline BasicString<CharT, Traits>::BasicString(InputIterator first, InputIterator last) : string_length(0)
+	inline BasicString<CharT, Traits, Allocator>::BasicString(InputIterator first, InputIterator last, const Allocator & alloc) : string_length(0), allocator(alloc)
 	{
 		size_type n = std::distance(first, last);
 		_allocate(n);
@@ -570,200 +600,203 @@ namespace DataStructures
 		_add_null_char(string_length);
 	}
 
-	template<typename CharT, typename Traits>
+	template<typename CharT, typename Traits, class Allocator>
 	template<typename InputIterator, typename SFINAE_MAGIC>
-	inline BasicString<CharT, Traits> & BasicString<CharT, Traits>::assign(InputIterator first, InputIterator last)
+	inline BasicString<CharT, Traits, Allocator> & BasicString<CharT, Traits, Allocator>::assign(InputIterator first, InputIterator last)
 	{
-		swap(BasicString(first, last));
+		swap(BasicString(first, last, allocator));
 		return *this;
 	}
 
-	template<typename CharT, typename Traits>
-	inline void BasicString<CharT, Traits>::swap(BasicString & other) noexcept
+	template<typename CharT, typename Traits, class Allocator>
+	inline void BasicString<CharT, Traits, Allocator>::swap(BasicString & other) noexcept
 	{
 		using std::swap;
 		swap(storage, other.storage);
 		swap(reserved_size, other.reserved_size);
 		swap(string_length, other.string_length);
+		swap(allocator, other.allocator);
 	}
 
-	template<typename CharT, typename Traits>
-	inline void BasicString<CharT, Traits>::clear() noexcept
+	template<typename CharT, typename Traits, class Allocator>
+	inline void BasicString<CharT, Traits, Allocator>::clear() noexcept
 	{
 		for (size_t i = 0; i < string_length; i++)
 		{
 			Tstorage[i].~CharT();
 		}
+		string_length = 0;
+		_add_null_char(string_length);
 	}
 
-	template<typename CharT, typename Traits>
-	inline typename BasicString<CharT, Traits>::reference BasicString<CharT, Traits>::at(size_type index)
+	template<typename CharT, typename Traits, class Allocator>
+	inline typename BasicString<CharT, Traits, Allocator>::reference BasicString<CharT, Traits, Allocator>::at(size_type index)
 	{
 		if (index < string_length)
 			return Tstorage[index];
 		throw std::out_of_range{ "Accessed position is out of range!" };
 	}
 
-	template<typename CharT, typename Traits>
-	inline typename BasicString<CharT, Traits>::const_reference BasicString<CharT, Traits>::at(size_type index) const
+	template<typename CharT, typename Traits, class Allocator>
+	inline typename BasicString<CharT, Traits, Allocator>::const_reference BasicString<CharT, Traits, Allocator>::at(size_type index) const
 	{
 		if (index < string_length)
 			return Tstorage[index];
 		throw std::out_of_range{ "Accessed position is out of range!" };
 	}
 
-	template<typename CharT, typename Traits>
-	inline typename BasicString<CharT, Traits>::reference BasicString<CharT, Traits>::operator[](size_type index)
+	template<typename CharT, typename Traits, class Allocator>
+	inline typename BasicString<CharT, Traits, Allocator>::reference BasicString<CharT, Traits, Allocator>::operator[](size_type index)
 	{
 		return Tstorage[index];
 	}
 
-	template<typename CharT, typename Traits>
-	inline typename BasicString<CharT, Traits>::const_reference BasicString<CharT, Traits>::operator[](size_type index) const
+	template<typename CharT, typename Traits, class Allocator>
+	inline typename BasicString<CharT, Traits, Allocator>::const_reference BasicString<CharT, Traits, Allocator>::operator[](size_type index) const
 	{
 		return Tstorage[index];
 	}
 
-	template<typename CharT, typename Traits>
-	inline typename BasicString<CharT, Traits>::reference BasicString<CharT, Traits>::front()
+	template<typename CharT, typename Traits, class Allocator>
+	inline typename BasicString<CharT, Traits, Allocator>::reference BasicString<CharT, Traits, Allocator>::front()
 	{
 		return Tstorage[0];
 	}
 
-	template<typename CharT, typename Traits>
-	inline typename BasicString<CharT, Traits>::const_reference BasicString<CharT, Traits>::front() const
+	template<typename CharT, typename Traits, class Allocator>
+	inline typename BasicString<CharT, Traits, Allocator>::const_reference BasicString<CharT, Traits, Allocator>::front() const
 	{
 		return Tstorage[0];
 	}
 
-	template<typename CharT, typename Traits>
-	inline typename BasicString<CharT, Traits>::reference BasicString<CharT, Traits>::back()
+	template<typename CharT, typename Traits, class Allocator>
+	inline typename BasicString<CharT, Traits, Allocator>::reference BasicString<CharT, Traits, Allocator>::back()
 	{
 		return Tstorage[string_length - 1];
 	}
 
-	template<typename CharT, typename Traits>
-	inline typename BasicString<CharT, Traits>::const_reference BasicString<CharT, Traits>::back() const
+	template<typename CharT, typename Traits, class Allocator>
+	inline typename BasicString<CharT, Traits, Allocator>::const_reference BasicString<CharT, Traits, Allocator>::back() const
 	{
 		return Tstorage[string_length - 1];
 	}
 
-	template<typename CharT, typename Traits>
-	inline CharT * BasicString<CharT, Traits>::data()
+	template<typename CharT, typename Traits, class Allocator>
+	inline CharT * BasicString<CharT, Traits, Allocator>::data()
 	{
 		return Tstorage;
 	}
 
-	template<typename CharT, typename Traits>
-	inline const CharT * BasicString<CharT, Traits>::data() const
+	template<typename CharT, typename Traits, class Allocator>
+	inline const CharT * BasicString<CharT, Traits, Allocator>::data() const
 	{
 		return Tstorage;
 	}
 
-	template<typename CharT, typename Traits>
-	inline const CharT * BasicString<CharT, Traits>::c_str() const
+	template<typename CharT, typename Traits, class Allocator>
+	inline const CharT * BasicString<CharT, Traits, Allocator>::c_str() const
 	{
 		return Tstorage;
 	}
 
-	template<typename CharT, typename Traits>
-	inline typename BasicString<CharT, Traits>::iterator BasicString<CharT, Traits>::begin()
+	template<typename CharT, typename Traits, class Allocator>
+	inline typename BasicString<CharT, Traits, Allocator>::iterator BasicString<CharT, Traits, Allocator>::begin()
 	{
 		return Tstorage;
 	}
 
-	template<typename CharT, typename Traits>
-	inline typename BasicString<CharT, Traits>::const_iterator BasicString<CharT, Traits>::begin() const
+	template<typename CharT, typename Traits, class Allocator>
+	inline typename BasicString<CharT, Traits, Allocator>::const_iterator BasicString<CharT, Traits, Allocator>::begin() const
 	{
 		return Tstorage;
 	}
 
-	template<typename CharT, typename Traits>
-	inline typename BasicString<CharT, Traits>::const_iterator BasicString<CharT, Traits>::cbegin() const
+	template<typename CharT, typename Traits, class Allocator>
+	inline typename BasicString<CharT, Traits, Allocator>::const_iterator BasicString<CharT, Traits, Allocator>::cbegin() const
 	{
 		return begin();
 	}
 
-	template<typename CharT, typename Traits>
-	inline typename BasicString<CharT, Traits>::iterator BasicString<CharT, Traits>::end()
+	template<typename CharT, typename Traits, class Allocator>
+	inline typename BasicString<CharT, Traits, Allocator>::iterator BasicString<CharT, Traits, Allocator>::end()
 	{
 		return Tstorage + string_length;
 	}
 
-	template<typename CharT, typename Traits>
-	inline typename BasicString<CharT, Traits>::const_iterator BasicString<CharT, Traits>::end() const
+	template<typename CharT, typename Traits, class Allocator>
+	inline typename BasicString<CharT, Traits, Allocator>::const_iterator BasicString<CharT, Traits, Allocator>::end() const
 	{
 		return Tstorage + string_length;
 	}
 
-	template<typename CharT, typename Traits>
-	inline typename BasicString<CharT, Traits>::const_iterator BasicString<CharT, Traits>::cend() const
+	template<typename CharT, typename Traits, class Allocator>
+	inline typename BasicString<CharT, Traits, Allocator>::const_iterator BasicString<CharT, Traits, Allocator>::cend() const
 	{
 		return end();
 	}
 
-	template<typename CharT, typename Traits>
-	inline typename BasicString<CharT, Traits>::reverse_iterator BasicString<CharT, Traits>::rbegin()
+	template<typename CharT, typename Traits, class Allocator>
+	inline typename BasicString<CharT, Traits, Allocator>::reverse_iterator BasicString<CharT, Traits, Allocator>::rbegin()
 	{
 		return reverse_iterator(end());
 	}
 
-	template<typename CharT, typename Traits>
-	inline typename BasicString<CharT, Traits>::const_reverse_iterator BasicString<CharT, Traits>::rbegin() const
+	template<typename CharT, typename Traits, class Allocator>
+	inline typename BasicString<CharT, Traits, Allocator>::const_reverse_iterator BasicString<CharT, Traits, Allocator>::rbegin() const
 	{
 		return const_reverse_iterator(end());
 	}
 
-	template<typename CharT, typename Traits>
-	inline typename BasicString<CharT, Traits>::const_reverse_iterator BasicString<CharT, Traits>::crbegin() const
+	template<typename CharT, typename Traits, class Allocator>
+	inline typename BasicString<CharT, Traits, Allocator>::const_reverse_iterator BasicString<CharT, Traits, Allocator>::crbegin() const
 	{
 		return rbegin();
 	}
 
-	template<typename CharT, typename Traits>
-	inline typename BasicString<CharT, Traits>::reverse_iterator BasicString<CharT, Traits>::rend()
+	template<typename CharT, typename Traits, class Allocator>
+	inline typename BasicString<CharT, Traits, Allocator>::reverse_iterator BasicString<CharT, Traits, Allocator>::rend()
 	{
 		return reverse_iterator(begin());
 	}
 
-	template<typename CharT, typename Traits>
-	inline typename BasicString<CharT, Traits>::const_reverse_iterator BasicString<CharT, Traits>::rend() const
+	template<typename CharT, typename Traits, class Allocator>
+	inline typename BasicString<CharT, Traits, Allocator>::const_reverse_iterator BasicString<CharT, Traits, Allocator>::rend() const
 	{
 		return const_reverse_iterator(begin());
 	}
 
-	template<typename CharT, typename Traits>
-	inline typename BasicString<CharT, Traits>::const_reverse_iterator BasicString<CharT, Traits>::crend() const
+	template<typename CharT, typename Traits, class Allocator>
+	inline typename BasicString<CharT, Traits, Allocator>::const_reverse_iterator BasicString<CharT, Traits, Allocator>::crend() const
 	{
 		return rend();
 	}
 
-	template<typename CharT, typename Traits>
-	inline bool BasicString<CharT, Traits>::empty() const
+	template<typename CharT, typename Traits, class Allocator>
+	inline bool BasicString<CharT, Traits, Allocator>::empty() const
 	{
 		return string_length == 0;
 	}
 
-	template<typename CharT, typename Traits>
-	inline typename BasicString<CharT, Traits>::size_type BasicString<CharT, Traits>::size() const
+	template<typename CharT, typename Traits, class Allocator>
+	inline typename BasicString<CharT, Traits, Allocator>::size_type BasicString<CharT, Traits, Allocator>::size() const
 	{
 		return string_length;
 	}
 
-	template<typename CharT, typename Traits>
-	inline typename BasicString<CharT, Traits>::size_type BasicString<CharT, Traits>::length() const
+	template<typename CharT, typename Traits, class Allocator>
+	inline typename BasicString<CharT, Traits, Allocator>::size_type BasicString<CharT, Traits, Allocator>::length() const
 	{
 		return string_length;
 	}
 
-	template<typename CharT, typename Traits>
-	inline typename BasicString<CharT, Traits>::size_type BasicString<CharT, Traits>::max_size() const
+	template<typename CharT, typename Traits, class Allocator>
+	inline typename BasicString<CharT, Traits, Allocator>::size_type BasicString<CharT, Traits, Allocator>::max_size() const
 	{
 		return MAX_STRING_SIZE;
 	}
 
-	template<typename CharT, typename Traits>
-	inline void BasicString<CharT, Traits>::reserve(size_type n)
+	template<typename CharT, typename Traits, class Allocator>
+	inline void BasicString<CharT, Traits, Allocator>::reserve(size_type n)
 	{
 		if (reserved_size >= n)
 		{
@@ -776,37 +809,730 @@ namespace DataStructures
 		}
 	}
 
-	template<typename CharT, typename Traits>
-	inline typename BasicString<CharT, Traits>::size_type BasicString<CharT, Traits>::capacity() const
+	template<typename CharT, typename Traits, class Allocator>
+	inline typename BasicString<CharT, Traits, Allocator>::size_type BasicString<CharT, Traits, Allocator>::capacity() const
 	{
 		return reserved_size;
 	}
 
-	template<typename CharT, typename Traits>
-	inline void BasicString<CharT, Traits>::shrink_to_fit()
+	template<typename CharT, typename Traits, class Allocator>
+	inline void BasicString<CharT, Traits, Allocator>::shrink_to_fit()
 	{
 		_reallocate(string_length);
 	}
 
-	int       stoi(const String& str, std::size_t* pos = 0, int base = 10);
-	int       stoi(const WString& str, std::size_t* pos = 0, int base = 10);
-	long      stol(const String& str, std::size_t* pos = 0, int base = 10);
-	long      stol(const WString& str, std::size_t* pos = 0, int base = 10);
-	long long stoll(const String& str, std::size_t* pos = 0, int base = 10);
-	long long stoll(const WString& str, std::size_t* pos = 0, int base = 10);
+	template<typename CharT, typename Traits, class Allocator>
+	inline BasicString<CharT, Traits, Allocator> & BasicString<CharT, Traits, Allocator>::insert(size_type pos, size_type n, CharT ch)
+	{
+		if (pos > string_length)
+			throw std::out_of_range{ "Accessed position is out of range!" };
+		if (string_length + n > reserved_size)
+			_reallocate(reserved_size / 2 > n ? reserved_size + reserved_size / 2 + 1 : reserved_size + n);
+		_move_storage(Tstorage + pos + n, Tstorage + pos, string_length - pos);
+		for (size_t i = 0; i < n; i++)
+			_construct(pos + i, ch);
+		string_length += n;
+		_add_null_char(string_length);
+		return *this;
+	}
+
+	template<typename CharT, typename Traits, class Allocator>
+	inline BasicString<CharT, Traits, Allocator> & BasicString<CharT, Traits, Allocator>::insert(size_type pos, const CharT * s)
+	{
+		return insert(pos, s, Traits::length(s));
+	}
+
+	template<typename CharT, typename Traits, class Allocator>
+	inline BasicString<CharT, Traits, Allocator> & BasicString<CharT, Traits, Allocator>::insert(size_type pos, const CharT * s, size_type n)
+	{
+		if (pos > string_length)
+			throw std::out_of_range{ "Accessed position is out of range!" };
+		if (s >= Tstorage && s <= Tstorage + string_length)	//s points into *this, which may be moved by reallocation
+			return insert(pos, BasicString(s, n, allocator));
+		if (string_length + n > reserved_size)
+			_reallocate(reserved_size / 2 > n ? reserved_size + reserved_size / 2 + 1 : reserved_size + n);
+		_move_storage(Tstorage + pos + n, Tstorage + pos, string_length - pos);
+		memcpy(Tstorage + pos, s, n * Tsize);
+		string_length += n;
+		_add_null_char(string_length);
+		return *this;
+	}
+
+	template<typename CharT, typename Traits, class Allocator>
+	inline BasicString<CharT, Traits, Allocator> & BasicString<CharT, Traits, Allocator>::insert(size_type pos, const BasicString & str)
+	{
+		return insert(pos, str.data(), str.size());
+	}
+
+	template<typename CharT, typename Traits, class Allocator>
+	inline BasicString<CharT, Traits, Allocator> & BasicString<CharT, Traits, Allocator>::insert(size_type pos, const BasicString & str, size_type str_pos, size_type n)
+	{
+		if (str_pos > str.size())
+			throw std::out_of_range{ "Accessed position is out of range!" };
+		return insert(pos, str.data() + str_pos, n < str.size() - str_pos ? n : str.size() - str_pos);
+	}
+
+	template<typename CharT, typename Traits, class Allocator>
+	inline BasicString<CharT, Traits, Allocator> & BasicString<CharT, Traits, Allocator>::erase(size_type pos, size_type n)
+	{
+		if (pos > string_length)
+			throw std::out_of_range{ "Accessed position is out of range!" };
+		if (n > string_length - pos)
+			n = string_length - pos;
+		_move_storage(Tstorage + pos, Tstorage + pos + n, string_length - pos - n);
+		string_length -= n;
+		_add_null_char(string_length);
+		return *this;
+	}
+
+	template<typename CharT, typename Traits, class Allocator>
+	inline void BasicString<CharT, Traits, Allocator>::push_back(CharT val)
+	{
+		append(1, val);
+	}
+
+	template<typename CharT, typename Traits, class Allocator>
+	inline void BasicString<CharT, Traits, Allocator>::pop_back()
+	{
+		Tstorage[--string_length].~CharT();
+		_add_null_char(string_length);
+	}
+
+	template<typename CharT, typename Traits, class Allocator>
+	inline void BasicString<CharT, Traits, Allocator>::resize(size_type n)
+	{
+		resize(n, CharT());
+	}
+
+	template<typename CharT, typename Traits, class Allocator>
+	inline void BasicString<CharT, Traits, Allocator>::resize(size_type n, CharT ch)
+	{
+		if (n > string_length)
+		{
+			append(n - string_length, ch);
+			return;
+		}
+		for (size_t i = n; i < string_length; i++)
+		{
+			Tstorage[i].~CharT();
+		}
+		string_length = n;
+		_add_null_char(string_length);
+	}
+
+	template<typename CharT, typename Traits, class Allocator>
+	inline BasicString<CharT, Traits, Allocator> & BasicString<CharT, Traits, Allocator>::append(size_type n, CharT ch)
+	{
+		return insert(string_length, n, ch);
+	}
+
+	template<typename CharT, typename Traits, class Allocator>
+	inline BasicString<CharT, Traits, Allocator> & BasicString<CharT, Traits, Allocator>::append(const BasicString & str)
+	{
+		return insert(string_length, str.data(), str.size());
+	}
+
+	template<typename CharT, typename Traits, class Allocator>
+	inline BasicString<CharT, Traits, Allocator> & BasicString<CharT, Traits, Allocator>::append(const BasicString & str, size_type pos, size_type n)
+	{
+		return insert(string_length, str, pos, n);
+	}
+
+	template<typename CharT, typename Traits, class Allocator>
+	inline BasicString<CharT, Traits, Allocator> & BasicString<CharT, Traits, Allocator>::append(const CharT * s, size_type n)
+	{
+		return insert(string_length, s, n);
+	}
+
+	template<typename CharT, typename Traits, class Allocator>
+	inline BasicString<CharT, Traits, Allocator> & BasicString<CharT, Traits, Allocator>::append(const CharT * s)
+	{
+		return insert(string_length, s, Traits::length(s));
+	}
+
+	template<typename CharT, typename Traits, class Allocator>
+	template<typename InputIterator, typename SFINAE_MAGIC>
+	inline BasicString<CharT, Traits, Allocator> & BasicString<CharT, Traits, Allocator>::append(InputIterator first, InputIterator last)
+	{
+		return append(BasicString(first, last, allocator));
+	}
+
+	template<typename CharT, typename Traits, class Allocator>
+	inline BasicString<CharT, Traits, Allocator> & BasicString<CharT, Traits, Allocator>::append(std::initializer_list<CharT> init)
+	{
+		return insert(string_length, init.begin(), init.size());
+	}
+
+	template<typename CharT, typename Traits, class Allocator>
+	inline BasicString<CharT, Traits, Allocator> & BasicString<CharT, Traits, Allocator>::operator+=(const BasicString & str)
+	{
+		return append(str);
+	}
+
+	template<typename CharT, typename Traits, class Allocator>
+	inline BasicString<CharT, Traits, Allocator> & BasicString<CharT, Traits, Allocator>::operator+=(CharT ch)
+	{
+		return append(1, ch);
+	}
+
+	template<typename CharT, typename Traits, class Allocator>
+	inline BasicString<CharT, Traits, Allocator> & BasicString<CharT, Traits, Allocator>::operator+=(const CharT * s)
+	{
+		return append(s);
+	}
+
+	template<typename CharT, typename Traits, class Allocator>
+	inline BasicString<CharT, Traits, Allocator> & BasicString<CharT, Traits, Allocator>::operator+=(std::initializer_list<CharT> init)
+	{
+		return append(init);
+	}
+
+	template<typename CharT, typename Traits, class Allocator>
+	template<typename ... Pieces>
+	inline BasicString<CharT, Traits, Allocator> BasicString<CharT, Traits, Allocator>::concat(const Pieces & ... pieces)
+	{
+		size_type lengths[sizeof...(Pieces) + 1];	//Filled by _concat_size, so a C string is measured once
+		size_type n = _concat_size(lengths, pieces...);
+		BasicString result(_Unallocated(), _concat_allocator(pieces...));	//On the allocator of the first BasicString
+		result._allocate(n);
+		_concat_copy(reinterpret_cast<CharT*>(result.storage), lengths, pieces...);
+		result.string_length = n;
+		result._add_null_char(n);
+		return result;
+	}
+
+	template<typename CharT, typename Traits, class Allocator>
+	inline BasicString<CharT, Traits, Allocator> & BasicString<CharT, Traits, Allocator>::to_lower()
+	{
+		_ascii_to_lower(Tstorage, Tstorage + string_length);
+		return *this;
+	}
+
+	template<typename CharT, typename Traits, class Allocator>
+	inline BasicString<CharT, Traits, Allocator> & BasicString<CharT, Traits, Allocator>::to_upper()
+	{
+		_ascii_to_upper(Tstorage, Tstorage + string_length);
+		return *this;
+	}
+
+	template<typename CharT, typename Traits, class Allocator>
+	inline BasicString<CharT, Traits, Allocator> & BasicString<CharT, Traits, Allocator>::trim()
+	{
+		rtrim();
+		return ltrim();
+	}
+
+	template<typename CharT, typename Traits, class Allocator>
+	inline BasicString<CharT, Traits, Allocator> & BasicString<CharT, Traits, Allocator>::ltrim()
+	{
+		size_type n = _skip_ascii_space(Tstorage, Tstorage + string_length) - Tstorage;
+		if (n > 0)
+		{
+			memmove(storage, Tstorage + n, (string_length - n) * Tsize);
+			string_length -= n;
+			_add_null_char(string_length);
+		}
+		return *this;
+	}
+
+	template<typename CharT, typename Traits, class Allocator>
+	inline BasicString<CharT, Traits, Allocator> & BasicString<CharT, Traits, Allocator>::rtrim()
+	{
+		string_length = _skip_ascii_space_backward(Tstorage, Tstorage + string_length) - Tstorage;
+		_add_null_char(string_length);
+		return *this;
+	}
+
+	template<typename CharT, typename Traits, class Allocator>
+	inline BasicString<CharT, Traits, Allocator> & BasicString<CharT, Traits, Allocator>::collapse_whitespace()
+	{
+		const CharT* read = Tstorage;
+		const CharT* last = Tstorage + string_length;
+		CharT* write = Tstorage;
+		while (read != last)
+		{
+			//Copy the next word as one block, then one space for the whole run after it
+			const CharT* space = _find_ascii_space(read, last);
+			if (write != read)
+				memmove(write, read, (space - read) * Tsize);
+			write += space - read;
+			if (space == last) break;
+			*write++ = CharT(' ');
+			read = _skip_ascii_space(space, last);
+		}
+		string_length = write - Tstorage;
+		_add_null_char(string_length);
+		return *this;
+	}
+
+	template<typename CharT, typename Traits, class Allocator>
+	inline BasicString<CharT, Traits, Allocator> & BasicString<CharT, Traits, Allocator>::replace_all(CharT from, CharT to)
+	{
+		_replace_char(Tstorage, Tstorage + string_length, from, to);
+		return *this;
+	}
+
+	template<typename CharT, typename Traits, class Allocator>
+	inline int BasicString<CharT, Traits, Allocator>::compare_ignore_case(const BasicString & str) const
+	{
+		size_type n = string_length < str.string_length ? string_length : str.string_length;
+		size_type i = _mismatch_ignore_case(Tstorage, str.data(), n);
+		if (i < n)
+			return Traits::lt(_ascii_lower(Tstorage[i]), _ascii_lower(str.data()[i])) ? -1 : 1;
+		return string_length < str.string_length ? -1 : string_length > str.string_length ? 1 : 0;
+	}
+
+	template<typename CharT, typename Traits, class Allocator>
+	inline int BasicString<CharT, Traits, Allocator>::compare_ignore_case(const CharT * s) const
+	{
+		size_type length = Traits::length(s);
+		size_type n = string_length < length ? string_length : length;
+		size_type i = _mismatch_ignore_case(Tstorage, s, n);
+		if (i < n)
+			return Traits::lt(_ascii_lower(Tstorage[i]), _ascii_lower(s[i])) ? -1 : 1;
+		return string_length < length ? -1 : string_length > length ? 1 : 0;
+	}
+
+	template<typename CharT, typename Traits, class Allocator>
+	inline typename BasicString<CharT, Traits, Allocator>::size_type BasicString<CharT, Traits, Allocator>::find_ignore_case(const BasicString & str, size_type pos) const
+	{
+		return find_ignore_case(str.data(), pos, str.size());
+	}
+
+	template<typename CharT, typename Traits, class Allocator>
+	inline typename BasicString<CharT, Traits, Allocator>::size_type BasicString<CharT, Traits, Allocator>::find_ignore_case(const CharT * s, size_type pos, size_type count) const
+	{
+		if (pos > string_length) return npos;
+		if (count == 0) return pos;
+		const CharT* last = Tstorage + string_length;
+		const CharT* found = _find_ignore_case(Tstorage + pos, last, s, count);
+		return found == last ? npos : found - Tstorage;
+	}
+
+	template<typename CharT, typename Traits, class Allocator>
+	inline typename BasicString<CharT, Traits, Allocator>::size_type BasicString<CharT, Traits, Allocator>::find_ignore_case(const CharT * s, size_type pos) const
+	{
+		return find_ignore_case(s, pos, Traits::length(s));
+	}
+
+	//Concatenation
+	//A temporary on the left of operator+ is appended to and moved on, so a + b + c + d allocates a new string once
+	//and grows it like append() does. BasicString::concat(a, b, c, d) measures every piece first and allocates once.
+
+	template<typename CharT, typename Traits, class Allocator>
+	inline BasicString<CharT, Traits, Allocator>::BasicString(_Unallocated, const Allocator & alloc) noexcept : string_length(0), allocator(alloc)
+	{
+	}
+
+	template<typename CharT, typename Traits, class Allocator>
+	inline Allocator BasicString<CharT, Traits, Allocator>::_concat_allocator()
+	{
+		return Allocator();
+	}
 
-	unsigned long      stoul(const String& str, std::size_t* pos = 0, int base = 10);
-	unsigned long      stoul(const WString& str, std::size_t* pos = 0, int base = 10);
-	unsigned long long stoull(const String& str, std::size_t* pos = 0, int base = 10);
-	unsigned long long stoull(const WString& str, std::size_t* pos = 0, int base = 10);
+	template<typename CharT, typename Traits, class Allocator>
+	template<typename ... Pieces>
+	inline const Allocator & BasicString<CharT, Traits, Allocator>::_concat_allocator(const BasicString & str, const Pieces & ... pieces) noexcept
+	{
+		return str.allocator;
+	}
 
-	float       stof(const String& str, std::size_t* pos = 0);
-	float       stof(const WString& str, std::size_t* pos = 0);
-	double      stod(const String& str, std::size_t* pos = 0);
-	double      stod(const WString& str, std::size_t* pos = 0);
-	long double stold(const String& str, std::size_t* pos = 0);
-	long double stold(const WString& str, std::size_t* pos = 0);
+	template<typename CharT, typename Traits, class Allocator>
+	template<typename Piece, typename ... Pieces>
+	inline Allocator BasicString<CharT, Traits, Allocator>::_concat_allocator(const Piece & piece, const Pieces & ... pieces)
+	{
+		return _concat_allocator(pieces...);
+	}
+
+	template<typename CharT, typename Traits, class Allocator>
+	inline typename BasicString<CharT, Traits, Allocator>::size_type BasicString<CharT, Traits, Allocator>::_concat_size(size_type * lengths) noexcept
+	{
+		return 0;
+	}
+
+	template<typename CharT, typename Traits, class Allocator>
+	template<typename Piece, typename ... Pieces>
+	inline typename BasicString<CharT, Traits, Allocator>::size_type BasicString<CharT, Traits, Allocator>::_concat_size(size_type * lengths, const Piece & piece, const Pieces & ... pieces)
+	{
+		*lengths = _piece_length(piece);
+		return *lengths + _concat_size(lengths + 1, pieces...);
+	}
+
+	template<typename CharT, typename Traits, class Allocator>
+	inline void BasicString<CharT, Traits, Allocator>::_concat_copy(CharT * dest, const size_type * lengths) noexcept
+	{
+	}
+
+	template<typename CharT, typename Traits, class Allocator>
+	template<typename Piece, typename ... Pieces>
+	inline void BasicString<CharT, Traits, Allocator>::_concat_copy(CharT * dest, const size_type * lengths, const Piece & piece, const Pieces & ... pieces)
+	{
+		Traits::copy(dest, _piece_data(piece), *lengths);
+		_concat_copy(dest + *lengths, lengths + 1, pieces...);
+	}
+
+	template<typename CharT, typename Traits, class Allocator>
+	template<class OtherAllocator>
+	inline typename BasicString<CharT, Traits, Allocator>::size_type BasicString<CharT, Traits, Allocator>::_piece_length(const BasicString<CharT, Traits, OtherAllocator>& str) noexcept
+	{
+		return str.size();
+	}
+
+	template<typename CharT, typename Traits, class Allocator>
+	inline typename BasicString<CharT, Traits, Allocator>::size_type BasicString<CharT, Traits, Allocator>::_piece_length(const CharT * s) noexcept
+	{
+		return Traits::length(s);
+	}
+
+	template<typename CharT, typename Traits, class Allocator>
+	inline typename BasicString<CharT, Traits, Allocator>::size_type BasicString<CharT, Traits, Allocator>::_piece_length(const CharT & ch) noexcept
+	{
+		return 1;
+	}
+
+	template<typename CharT, typename Traits, class Allocator>
+	template<class OtherAllocator>
+	inline const CharT * BasicString<CharT, Traits, Allocator>::_piece_data(const BasicString<CharT, Traits, OtherAllocator>& str) noexcept
+	{
+		return str.data();
+	}
+
+	template<typename CharT, typename Traits, class Allocator>
+	inline const CharT * BasicString<CharT, Traits, Allocator>::_piece_data(const CharT * s) noexcept
+	{
+		return s;
+	}
+
+	template<typename CharT, typename Traits, class Allocator>
+	inline const CharT * BasicString<CharT, Traits, Allocator>::_piece_data(const CharT & ch) noexcept
+	{
+		return &ch;
+	}
+
+	template<typename CharT, typename Traits, class Allocator>
+	inline BasicString<CharT, Traits, Allocator> operator+(const BasicString<CharT, Traits, Allocator>& lhs, const BasicString<CharT, Traits, Allocator>& rhs)
+	{
+		return BasicString<CharT, Traits, Allocator>::concat(lhs, rhs);
+	}
+
+	template<typename CharT, typename Traits, class Allocator>
+	inline BasicString<CharT, Traits, Allocator> operator+(const CharT* lhs, const BasicString<CharT, Traits, Allocator>& rhs)
+	{
+		return BasicString<CharT, Traits, Allocator>::concat(lhs, rhs);
+	}
+
+	template<typename CharT, typename Traits, class Allocator>
+	inline BasicString<CharT, Traits, Allocator> operator+(CharT lhs, const BasicString<CharT, Traits, Allocator>& rhs)
+	{
+		return BasicString<CharT, Traits, Allocator>::concat(lhs, rhs);
+	}
+
+	template<typename CharT, typename Traits, class Allocator>
+	inline BasicString<CharT, Traits, Allocator> operator+(const BasicString<CharT, Traits, Allocator>& lhs, const CharT* rhs)
+	{
+		return BasicString<CharT, Traits, Allocator>::concat(lhs, rhs);
+	}
+
+	template<typename CharT, typename Traits, class Allocator>
+	inline BasicString<CharT, Traits, Allocator> operator+(const BasicString<CharT, Traits, Allocator>& lhs, CharT rhs)
+	{
+		return BasicString<CharT, Traits, Allocator>::concat(lhs, rhs);
+	}
+
+	template<typename CharT, typename Traits, class Allocator>
+	inline BasicString<CharT, Traits, Allocator> operator+(BasicString<CharT, Traits, Allocator>&& lhs, const BasicString<CharT, Traits, Allocator>& rhs)
+	{
+		return std::move(lhs.append(rhs));
+	}
+
+	template<typename CharT, typename Traits, class Allocator>
+	inline BasicString<CharT, Traits, Allocator> operator+(const BasicString<CharT, Traits, Allocator>& lhs, BasicString<CharT, Traits, Allocator>&& rhs)
+	{
+		return std::move(rhs.insert(size_t(0), lhs));
+	}
+
+	template<typename CharT, typename Traits, class Allocator>
+	inline BasicString<CharT, Traits, Allocator> operator+(BasicString<CharT, Traits, Allocator>&& lhs, BasicString<CharT, Traits, Allocator>&& rhs)
+	{
+		return std::move(lhs.append(rhs));
+	}
+
+	template<typename CharT, typename Traits, class Allocator>
+	inline BasicString<CharT, Traits, Allocator> operator+(const CharT* lhs, BasicString<CharT, Traits, Allocator>&& rhs)
+	{
+		return std::move(rhs.insert(size_t(0), lhs));
+	}
+
+	template<typename CharT, typename Traits, class Allocator>
+	inline BasicString<CharT, Traits, Allocator> operator+(CharT lhs, BasicString<CharT, Traits, Allocator>&& rhs)
+	{
+		return std::move(rhs.insert(size_t(0), 1, lhs));
+	}
+
+	template<typename CharT, typename Traits, class Allocator>
+	inline BasicString<CharT, Traits, Allocator> operator+(BasicString<CharT, Traits, Allocator>&& lhs, const CharT* rhs)
+	{
+		return std::move(lhs.append(rhs));
+	}
+
+	template<typename CharT, typename Traits, class Allocator>
+	inline BasicString<CharT, Traits, Allocator> operator+(BasicString<CharT, Traits, Allocator>&& lhs, CharT rhs)
+	{
+		return std::move(lhs.append(1, rhs));
+	}
+
+	//Input and output
+	//getline and operator>> work on the get area of the stream buffer directly: a whole span is searched for the
+	//delimiter or whitespace and appended at once, instead of extracting one character at a time through the istream.
+	//Reading into the same string again reuses its capacity. For bulk line reading see LineReader.h.
+
+	//gptr(), egptr() and gbump() are protected, this exposes them for any basic_streambuf
+	template<typename CharT, typename Traits>
+	class _StreamBufferAccess : public std::basic_streambuf<CharT, Traits>
+	{
+	public:
+		using buffer_type = std::basic_streambuf<CharT, Traits>;
+		static const CharT* begin(buffer_type* buf) { return (buf->*&_StreamBufferAccess::gptr)(); }
+		static const CharT* end(buffer_type* buf) { return (buf->*&_StreamBufferAccess::egptr)(); }
+		static void advance(buffer_type* buf, size_t n) { (buf->*&_StreamBufferAccess::gbump)(int(n)); }
+	};
+
+	template<typename CharT, typename Traits, class Allocator>
+	inline std::basic_ostream<CharT, Traits>& operator<<(std::basic_ostream<CharT, Traits>& os, const BasicString<CharT, Traits, Allocator>& str)
+	{
+		typename std::basic_ostream<CharT, Traits>::sentry guard(os);
+		if (!guard) return os;
+		size_t padding = os.width() > 0 && size_t(os.width()) > str.size() ? size_t(os.width()) - str.size() : 0;
+		bool pad_right = (os.flags() & std::ios_base::adjustfield) == std::ios_base::left;
+		bool failed = false;
+		for (; !pad_right && padding > 0 && !failed; padding--)
+			failed = Traits::eq_int_type(os.rdbuf()->sputc(os.fill()), Traits::eof());
+		failed = failed || os.rdbuf()->sputn(str.data(), str.size()) != std::streamsize(str.size());
+		for (; padding > 0 && !failed; padding--)
+			failed = Traits::eq_int_type(os.rdbuf()->sputc(os.fill()), Traits::eof());
+		os.width(0);
+		if (failed) os.setstate(std::ios_base::badbit);
+		return os;
+	}
+
+	//Skips leading whitespace if skipws is set, then reads until whitespace, at most width() characters if it is positive
+	template<typename CharT, typename Traits, class Allocator>
+	inline std::basic_istream<CharT, Traits>& operator>>(std::basic_istream<CharT, Traits>& input, BasicString<CharT, Traits, Allocator>& str)
+	{
+		using Access = _StreamBufferAccess<CharT, Traits>;
+		typename std::basic_istream<CharT, Traits>::sentry guard(input);
+		if (!guard) return input;
+		std::ios_base::iostate state = std::ios_base::goodbit;
+		const std::ctype<CharT>& facet = std::use_facet<std::ctype<CharT>>(input.getloc());
+		std::basic_streambuf<CharT, Traits>* buf = input.rdbuf();
+		size_t limit = input.width() > 0 ? size_t(input.width()) : str.max_size();
+		size_t extracted = 0;
+		str.clear();
+		while (extracted < limit)
+		{
+			const CharT* first = Access::begin(buf);
+			const CharT* last = Access::end(buf);
+			if (first == last)
+			{
+				typename Traits::int_type next = buf->sgetc();	//Refills the get area
+				if (Traits::eq_int_type(next, Traits::eof()))
+				{
+					state |= std::ios_base::eofbit;
+					break;
+				}
+				first = Access::begin(buf);
+				last = Access::end(buf);
+				if (first == last)	//Unbuffered, one character at a time
+				{
+					CharT ch = Traits::to_char_type(next);
+					if (facet.is(std::ctype_base::space, ch)) break;
+					str.push_back(ch);
+					buf->sbumpc();
+					extracted++;
+					continue;
+				}
+			}
+			if (size_t(last - first) > limit - extracted) last = first + (limit - extracted);
+			const CharT* found = facet.scan_is(std::ctype_base::space, first, last);
+			str.append(first, found - first);
+			Access::advance(buf, found - first);
+			extracted += found - first;
+			if (found != last) break;
+		}
+		input.width(0);
+		if (extracted == 0) state |= std::ios_base::failbit;
+		input.setstate(state);
+		return input;
+	}
+
+	//Reads until delim, which is extracted but not stored
+	template<typename CharT, typename Traits, class Allocator>
+	inline std::basic_istream<CharT, Traits>& getline(std::basic_istream<CharT, Traits>& input, BasicString<CharT, Traits, Allocator>& str, CharT delim)
+	{
+		using Access = _StreamBufferAccess<CharT, Traits>;
+		typename std::basic_istream<CharT, Traits>::sentry guard(input, true);
+		if (!guard) return input;
+		std::ios_base::iostate state = std::ios_base::goodbit;
+		std::basic_streambuf<CharT, Traits>* buf = input.rdbuf();
+		size_t extracted = 0;
+		str.clear();
+		for (;;)
+		{
+			const CharT* first = Access::begin(buf);
+			const CharT* last = Access::end(buf);
+			if (first == last)
+			{
+				typename Traits::int_type next = buf->sgetc();
+				if (Traits::eq_int_type(next, Traits::eof()))
+				{
+					state |= std::ios_base::eofbit;
+					break;
+				}
+				first = Access::begin(buf);
+				last = Access::end(buf);
+				if (first == last)
+				{
+					buf->sbumpc();
+					extracted++;
+					if (Traits::eq(Traits::to_char_type(next), delim)) break;
+					str.push_back(Traits::to_char_type(next));
+					continue;
+				}
+			}
+			const CharT* found = _find_char(first, last, delim);
+			str.append(first, found - first);
+			if (found != last)
+			{
+				Access::advance(buf, found - first + 1);
+				extracted += found - first + 1;
+				break;
+			}
+			Access::advance(buf, last - first);
+			extracted += last - first;
+		}
+		if (extracted == 0) state |= std::ios_base::failbit;
+		input.setstate(state);
+		return input;
+	}
+
+	template<typename CharT, typename Traits, class Allocator>
+	inline std::basic_istream<CharT, Traits>& getline(std::basic_istream<CharT, Traits>&& input, BasicString<CharT, Traits, Allocator>& str, CharT delim)
+	{
+		return getline(input, str, delim);
+	}
+
+	template<typename CharT, typename Traits, class Allocator>
+	inline std::basic_istream<CharT, Traits>& getline(std::basic_istream<CharT, Traits>& input, BasicString<CharT, Traits, Allocator>& str)
+	{
+		return getline(input, str, input.widen('\n'));
+	}
+
+	template<typename CharT, typename Traits, class Allocator>
+	inline std::basic_istream<CharT, Traits>& getline(std::basic_istream<CharT, Traits>&& input, BasicString<CharT, Traits, Allocator>& str)
+	{
+		return getline(input, str, input.widen('\n'));
+	}
+
+	//Numeric conversions
+	//Same contract as the std versions: leading whitespace is skipped, then a sign, and for integers a 0x or 0 base prefix.
+	//Throws invalid_argument if nothing is converted and out_of_range if the value does not fit.
+	//No locale is consulted, the decimal point is always '.'. long double is treated as double.
+	template<typename Integer, typename CharT>
+	inline Integer _sto_integer(const CharT* first, const CharT* last, std::size_t* pos, int base)
+	{
+		const CharT* curr = first;
+		while (curr != last && _is_space(*curr)) ++curr;
+		bool negative = false;
+		if (curr != last && (*curr == CharT('+') || *curr == CharT('-')))
+			negative = *curr++ == CharT('-');
+		if (base != 0 && (base < 2 || base > 36)) throw std::invalid_argument{ "Invalid base for numeric conversion!" };
+		if ((base == 0 || base == 16) && last - curr > 2 && curr[0] == CharT('0') && (curr[1] | 0x20) == 'x' &&
+			_digit_value(static_cast<unsigned long>(curr[2])) < 16)
+		{
+			curr += 2;
+			base = 16;
+		}
+		else if (base == 0) base = curr != last && *curr == CharT('0') ? 8 : 10;
+
+		unsigned long long magnitude;
+		bool overflow;
+		const CharT* digits_last = _parse_unsigned(curr, last, base, magnitude, overflow);
+		if (digits_last == curr) throw std::invalid_argument{ "No conversion could be performed!" };
+		if (std::is_signed<Integer>::value)
+		{
+			unsigned long long limit = static_cast<unsigned long long>(std::numeric_limits<Integer>::max()) + negative;
+			if (overflow || magnitude > limit) throw std::out_of_range{ "Converted value is out of range!" };
+		}
+		else if (overflow || magnitude > static_cast<unsigned long long>(std::numeric_limits<Integer>::max()))
+			throw std::out_of_range{ "Converted value is out of range!" };
+		if (pos) *pos = digits_last - first;
+		using Unsigned = std::make_unsigned_t<Integer>;
+		return static_cast<Integer>(negative ? Unsigned(0) - Unsigned(magnitude) : Unsigned(magnitude));	//Unsigned results wrap like strtoul
+	}
+
+	template<typename Float, typename CharT>
+	inline Float _sto_float(const CharT* first, const CharT* last, std::size_t* pos)
+	{
+		const CharT* curr = first;
+		while (curr != last && _is_space(*curr)) ++curr;
+		bool negative = false;
+		if (curr != last && (*curr == CharT('+') || *curr == CharT('-')))
+			negative = *curr++ == CharT('-');
+		Float value;
+		FromCharsResult<CharT> result = _parse_float(curr, last, value);
+		if (result.ec == std::errc::invalid_argument) throw std::invalid_argument{ "No conversion could be performed!" };
+		if (result.ec == std::errc::result_out_of_range) throw std::out_of_range{ "Converted value is out of range!" };
+		if (pos) *pos = result.ptr - first;
+		return negative ? -value : value;
+	}
+
+	template<typename CharT, typename Number>
+	inline BasicString<CharT> _to_basic_string(Number value)
+	{
+		CharT buffer[32];
+		ToCharsResult<CharT> result = to_chars(buffer, buffer + 32, value);
+		return BasicString<CharT>(buffer, result.ptr - buffer);
+	}
 
+	inline int       stoi(const String& str, std::size_t* pos = 0, int base = 10) { return _sto_integer<int>(str.data(), str.data() + str.size(), pos, base); }
+	inline int       stoi(const WString& str, std::size_t* pos = 0, int base = 10) { return _sto_integer<int>(str.data(), str.data() + str.size(), pos, base); }
+	inline long      stol(const String& str, std::size_t* pos = 0, int base = 10) { return _sto_integer<long>(str.data(), str.data() + str.size(), pos, base); }
+	inline long      stol(const WString& str, std::size_t* pos = 0, int base = 10) { return _sto_integer<long>(str.data(), str.data() + str.size(), pos, base); }
+	inline long long stoll(const String& str, std::size_t* pos = 0, int base = 10) { return _sto_integer<long long>(str.data(), str.data() + str.size(), pos, base); }
+	inline long long stoll(const WString& str, std::size_t* pos = 0, int base = 10) { return _sto_integer<long long>(str.data(), str.data() + str.size(), pos, base); }
+
+	inline unsigned long      stoul(const String& str, std::size_t* pos = 0, int base = 10) { return _sto_integer<unsigned long>(str.data(), str.data() + str.size(), pos, base); }
+	inline unsigned long      stoul(const WString& str, std::size_t* pos = 0, int base = 10) { return _sto_integer<unsigned long>(str.data(), str.data() + str.size(), pos, base); }
+	inline unsigned long long stoull(const String& str, std::size_t* pos = 0, int base = 10) { return _sto_integer<unsigned long long>(str.data(), str.data() + str.size(), pos, base); }
+	inline unsigned long long stoull(const WString& str, std::size_t* pos = 0, int base = 10) { return _sto_integer<unsigned long long>(str.data(), str.data() + str.size(), pos, base); }
+
+	inline float       stof(const String& str, std::size_t* pos = 0) { return _sto_float<float>(str.data(), str.data() + str.size(), pos); }
+	inline float       stof(const WString& str, std::size_t* pos = 0) { return _sto_float<float>(str.data(), str.data() + str.size(), pos); }
+	inline double      stod(const String& str, std::size_t* pos = 0) { return _sto_float<double>(str.data(), str.data() + str.size(), pos); }
+	inline double      stod(const WString& str, std::size_t* pos = 0) { return _sto_float<double>(str.data(), str.data() + str.size(), pos); }
+	inline long double stold(const String& str, std::size_t* pos = 0) { return _sto_float<double>(str.data(), str.data() + str.size(), pos); }
+	inline long double stold(const WString& str, std::size_t* pos = 0) { return _sto_float<double>(str.data(), str.data() + str.size(), pos); }
+
+	//Floating-point values are written in their shortest round-trip form, not with %f like std::to_string
+	inline String to_string(int value) { return _to_basic_string<char>(value); }
+	inline String to_string(long value) { return _to_basic_string<char>(value); }
+	inline String to_string(long long value) { return _to_basic_string<char>(value); }
+	inline String to_string(unsigned value) { return _to_basic_string<char>(value); }
+	inline String to_string(unsigned long value) { return _to_basic_string<char>(value); }
+	inline String to_string(unsigned long long value) { return _to_basic_string<char>(value); }
+	inline String to_string(float value) { return _to_basic_string<char>(value); }
+	inline String to_string(double value) { return _to_basic_string<char>(value); }
+	inline String to_string(long double value) { return _to_basic_string<char>(static_cast<double>(value)); }
+
+	inline WString to_wstring(int value) { return _to_basic_string<wchar_t>(value); }
+	inline WString to_wstring(long value) { return _to_basic_string<wchar_t>(value); }
+	inline WString to_wstring(long long value) { return _to_basic_string<wchar_t>(value); }
+	inline WString to_wstring(unsigned value) { return _to_basic_string<wchar_t>(value); }
+	inline WString to_wstring(unsigned long value) { return _to_basic_string<wchar_t>(value); }
+	inline WString to_wstring(unsigned long long value) { return _to_basic_string<wchar_t>(value); }
+	inline WString to_wstring(float value) { return _to_basic_string<wchar_t>(value); }
+	inline WString to_wstring(double value) { return _to_basic_string<wchar_t>(value); }
+	inline WString to_wstring(long double value) { return _to_basic_string<wchar_t>(static_cast<double>(value)); }
 
 	#undef Tstorage
 	#undef Tsize
@@ -0,0 +1,265 @@
+#pragma once
+#include <stdexcept>
+#include <iterator>
+#include <utility>
+#include "BasicString.h"
+#include "SIMD.h"
+
+namespace DataStructures
+{
+	template<typename CharT = char, typename Traits = std::char_traits<CharT>> class BasicStringView;
+	using StringView = BasicStringView<char>;
+	using WStringView = BasicStringView<wchar_t>;
+	using U16StringView = BasicStringView<char16_t>;
+	using U32StringView = BasicStringView<char32_t>;
+
+	//A pointer and a length into characters owned by someone else, which must outlive the view.
+	//Copying a view never copies characters. Any BasicString converts to a view of its current contents.
+	template<typename CharT, typename Traits>
+	class BasicStringView
+	{
+	public:
+		using traits_type = Traits;
+		using value_type = CharT;
+		using size_type = size_t;
+		using difference_type = ptrdiff_t;
+		using const_reference = const CharT&;
+		using const_pointer = const CharT*;
+
+		using const_iterator = const CharT*;
+		using iterator = const_iterator;
+		using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+		using reverse_iterator = const_reverse_iterator;
+
+		static const size_type npos = -1;
+
+		//Constructor, Destructor and Assignment
+		constexpr BasicStringView() noexcept = default;
+		constexpr BasicStringView(const CharT* s, size_type n) noexcept : first(s), view_length(n) {}
+		BasicStringView(const CharT* s) : first(s), view_length(Traits::length(s)) {}
+		template<class Allocator>
+		BasicStringView(const BasicString<CharT, Traits, Allocator>& str) noexcept : first(str.data()), view_length(str.size()) {}
+
+		//Element access
+		const_reference at(size_type index) const;	//Check and throw out_of_range exception
+		const_reference operator[](size_type index) const;
+		const_reference front() const;
+		const_reference back() const;
+		const CharT* data() const noexcept;
+
+		//Iterators
+		const_iterator begin() const noexcept;
+		const_iterator cbegin() const noexcept;
+		const_iterator end() const noexcept;
+		const_iterator cend() const noexcept;
+		const_reverse_iterator rbegin() const noexcept;
+		const_reverse_iterator rend() const noexcept;
+
+		//Capacity
+		bool empty() const noexcept;
+		size_type size() const noexcept;
+		size_type length() const noexcept;
+
+		//Modifiers
+		void remove_prefix(size_type n);
+		void remove_suffix(size_type n);
+		void swap(BasicStringView& other) noexcept;
+
+		//Operations
+		BasicStringView substr(size_type pos = 0, size_type n = npos) const;
+		BasicString<CharT, Traits> str() const;		//Copies the characters
+		int compare(BasicStringView other) const;
+		bool starts_with(BasicStringView prefix) const;
+		bool ends_with(BasicStringView suffix) const;
+		size_type find(CharT ch, size_type pos = 0) const;
+		size_type find(BasicStringView str, size_type pos = 0) const;
+
+	private:
+		const CharT* first = nullptr;
+		size_type view_length = 0;
+	};
+
+	template<typename CharT, typename Traits>
+	inline bool operator==(BasicStringView<CharT, Traits> lhs, BasicStringView<CharT, Traits> rhs)
+	{
+		return lhs.size() == rhs.size() && Traits::compare(lhs.data(), rhs.data(), lhs.size()) == 0;
+	}
+
+	template<typename CharT, typename Traits>
+	inline bool operator!=(BasicStringView<CharT, Traits> lhs, BasicStringView<CharT, Traits> rhs)
+	{
+		return !(lhs == rhs);
+	}
+
+	template<typename CharT, typename Traits>
+	inline bool operator<(BasicStringView<CharT, Traits> lhs, BasicStringView<CharT, Traits> rhs)
+	{
+		return lhs.compare(rhs) < 0;
+	}
+
+	/* Dividing Line ( 㧥 ;) ( 㧥 ;) ( 㧥 ;)  */
+
+	template<typename CharT, typename Traits>
+	inline typename BasicStringView<CharT, Traits>::const_reference BasicStringView<CharT, Traits>::at(size_type index) const
+	{
+		if (index >= view_length)
+			throw std::out_of_range{ "Accessed position is out of range!" };
+		return first[index];
+	}
+
+	template<typename CharT, typename Traits>
+	inline typename BasicStringView<CharT, Traits>::const_reference BasicStringView<CharT, Traits>::operator[](size_type index) const
+	{
+		return first[index];
+	}
+
+	template<typename CharT, typename Traits>
+	inline typename BasicStringView<CharT, Traits>::const_reference BasicStringView<CharT, Traits>::front() const
+	{
+		return first[0];
+	}
+
+	template<typename CharT, typename Traits>
+	inline typename BasicStringView<CharT, Traits>::const_reference BasicStringView<CharT, Traits>::back() const
+	{
+		return first[view_length - 1];
+	}
+
+	template<typename CharT, typename Traits>
+	inline const CharT * BasicStringView<CharT, Traits>::data() const noexcept
+	{
+		return first;
+	}
+
+	template<typename CharT, typename Traits>
+	inline typename BasicStringView<CharT, Traits>::const_iterator BasicStringView<CharT, Traits>::begin() const noexcept
+	{
+		return first;
+	}
+
+	template<typename CharT, typename Traits>
+	inline typename BasicStringView<CharT, Traits>::const_iterator BasicStringView<CharT, Traits>::cbegin() const noexcept
+	{
+		return first;
+	}
+
+	template<typename CharT, typename Traits>
+	inline typename BasicStringView<CharT, Traits>::const_iterator BasicStringView<CharT, Traits>::end() const noexcept
+	{
+		return first + view_length;
+	}
+
+	template<typename CharT, typename Traits>
+	inline typename BasicStringView<CharT, Traits>::const_iterator BasicStringView<CharT, Traits>::cend() const noexcept
+	{
+		return first + view_length;
+	}
+
+	template<typename CharT, typename Traits>
+	inline typename BasicStringView<CharT, Traits>::const_reverse_iterator BasicStringView<CharT, Traits>::rbegin() const noexcept
+	{
+		return const_reverse_iterator(end());
+	}
+
+	template<typename CharT, typename Traits>
+	inline typename BasicStringView<CharT, Traits>::const_reverse_iterator BasicStringView<CharT, Traits>::rend() const noexcept
+	{
+		return const_reverse_iterator(begin());
+	}
+
+	template<typename CharT, typename Traits>
+	inline bool BasicStringView<CharT, Traits>::empty() const noexcept
+	{
+		return view_length == 0;
+	}
+
+	template<typename CharT, typename Traits>
+	inline typename BasicStringView<CharT, Traits>::size_type BasicStringView<CharT, Traits>::size() const noexcept
+	{
+		return view_length;
+	}
+
+	template<typename CharT, typename Traits>
+	inline typename BasicStringView<CharT, Traits>::size_type BasicStringView<CharT, Traits>::length() const noexcept
+	{
+		return view_length;
+	}
+
+	template<typename CharT, typename Traits>
+	inline void BasicStringView<CharT, Traits>::remove_prefix(size_type n)
+	{
+		if (n > view_length)
+			throw std::out_of_range{ "Accessed position is out of range!" };
+		first += n;
+		view_length -= n;
+	}
+
+	template<typename CharT, typename Traits>
+	inline void BasicStringView<CharT, Traits>::remove_suffix(size_type n)
+	{
+		if (n > view_length)
+			throw std::out_of_range{ "Accessed position is out of range!" };
+		view_length -= n;
+	}
+
+	template<typename CharT, typename Traits>
+	inline void BasicStringView<CharT, Traits>::swap(BasicStringView & other) noexcept
+	{
+		std::swap(first, other.first);
+		std::swap(view_length, other.view_length);
+	}
+
+	template<typename CharT, typename Traits>
+	inline BasicStringView<CharT, Traits> BasicStringView<CharT, Traits>::substr(size_type pos, size_type n) const
+	{
+		if (pos > view_length)
+			throw std::out_of_range{ "Accessed position is out of range!" };
+		return BasicStringView(first + pos, n < view_length - pos ? n : view_length - pos);
+	}
+
+	template<typename CharT, typename Traits>
+	inline BasicString<CharT, Traits> BasicStringView<CharT, Traits>::str() const
+	{
+		return BasicString<CharT, Traits>(first, view_length);
+	}
+
+	template<typename CharT, typename Traits>
+	inline int BasicStringView<CharT, Traits>::compare(BasicStringView other) const
+	{
+		int result = Traits::compare(first, other.first, view_length < other.view_length ? view_length : other.view_length);
+		if (result != 0) return result;
+		return view_length < other.view_length ? -1 : view_length > other.view_length ? 1 : 0;
+	}
+
+	template<typename CharT, typename Traits>
+	inline bool BasicStringView<CharT, Traits>::starts_with(BasicStringView prefix) const
+	{
+		return prefix.view_length <= view_length && Traits::compare(first, prefix.first, prefix.view_length) == 0;
+	}
+
+	template<typename CharT, typename Traits>
+	inline bool BasicStringView<CharT, Traits>::ends_with(BasicStringView suffix) const
+	{
+		return suffix.view_length <= view_length && Traits::compare(first + view_length - suffix.view_length, suffix.first, suffix.view_length) == 0;
+	}
+
+	template<typename CharT, typename Traits>
+	inline typename BasicStringView<CharT, Traits>::size_type BasicStringView<CharT, Traits>::find(CharT ch, size_type pos) const
+	{
+		if (pos >= view_length) return npos;
+		const CharT* found = _find_char(first + pos, first + view_length, ch);
+		return found == first + view_length ? npos : found - first;
+	}
+
+	template<typename CharT, typename Traits>
+	inline typename BasicStringView<CharT, Traits>::size_type BasicStringView<CharT, Traits>::find(BasicStringView str, size_type pos) const
+	{
+		if (pos > view_length || str.view_length > view_length - pos) return npos;
+		if (str.view_length == 0) return pos;
+		//Jump between occurrences of the first character, then compare the rest
+		const CharT* last = first + view_length - str.view_length + 1;
+		for (const CharT* curr = first + pos; (curr = _find_char(curr, last, str.first[0])) != last; ++curr)
+			if (Traits::compare(curr + 1, str.first + 1, str.view_length - 1) == 0) return curr - first;
+		return npos;
+	}
+}
@@ -0,0 +1,524 @@
+#pragma once
+#include <stdexcept>
+#include <memory>
+#include <new>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+#include <type_traits>
+#include <initializer_list>
+
+constexpr size_t CHUNKED_STACK_CHUNK_BYTES = 4096U;	//By default a chunk holds as many elements as fit in this
+
+namespace DataStructures
+{
+	//Sequence that only grows and shrinks at the back, stored in a doubly linked chain of fixed-size chunks, meant as
+	//the Container of Stack, i.e. Stack<T, ChunkedStack<T>>. Growing allocates one more chunk and never moves an element,
+	//so push_back() and pop_back() are O(1) in the worst case instead of amortized, no copy of the whole stack.
+	//The chunk emptied last is kept as a spare, so pushing and popping across a chunk boundary does not allocate
+	//and free over and over. References to elements stay valid until they are popped.
+	template<typename T, size_t K = (sizeof(T) * 2 <= CHUNKED_STACK_CHUNK_BYTES ? CHUNKED_STACK_CHUNK_BYTES / sizeof(T) : 2),
+		class Allocator = std::allocator<T>>
+	class ChunkedStack
+	{
+		static_assert(K >= 1, "ChunkedStack needs room for an element per chunk!");
+
+	private:
+		struct Chunk;
+		class ChunkedStackIterator;
+		class ChunkedStackConstIterator;
+
+	public:
+		using allocator_type	= Allocator;
+		using value_type		= T;
+		using reference			= T&;
+		using const_reference	= const T&;
+		using pointer			= T*;
+		using const_pointer		= const T*;
+		using difference_type	= ptrdiff_t;
+		using size_type			= size_t;
+		using iterator			= ChunkedStackIterator;
+		using const_iterator	= ChunkedStackConstIterator;
+
+		static constexpr size_type chunk_capacity = K;
+
+		//Constructor, Destructor and Assignment
+		ChunkedStack() noexcept;
+		explicit ChunkedStack(const Allocator& alloc) noexcept;
+		ChunkedStack(size_type n, const T& val, const Allocator& alloc = Allocator());
+
+		template<typename InputIterator, typename = typename std::enable_if_t<std::_Is_iterator<InputIterator>::value>>
+		ChunkedStack(InputIterator first, InputIterator last, const Allocator& alloc = Allocator());
+
+		ChunkedStack(std::initializer_list<T> init, const Allocator& alloc = Allocator());
+		ChunkedStack(const ChunkedStack& origin);
+		ChunkedStack(ChunkedStack&& origin) noexcept;
+		~ChunkedStack();
+		ChunkedStack& operator=(const ChunkedStack& origin);
+		ChunkedStack& operator=(ChunkedStack&& origin) noexcept;
+		ChunkedStack& operator=(std::initializer_list<T> init);
+		allocator_type get_allocator() const;
+
+		//Element access
+		reference back();
+		const_reference back() const;
+
+		//Iterators, from the bottom of the stack to the top
+		iterator begin() noexcept;
+		const_iterator begin() const noexcept;
+		const_iterator cbegin() const noexcept;
+		iterator end() noexcept;
+		const_iterator end() const noexcept;
+		const_iterator cend() const noexcept;
+
+		//Capacity
+		bool empty() const noexcept;
+		size_type size() const noexcept;
+		void shrink_to_fit() noexcept;				//Frees the spare chunk
+
+		//Modifiers
+		void clear() noexcept;						//Keeps the bottom chunk and the spare
+		void push_back(const T& val);
+		void push_back(T&& val);
+		template <typename ... Args> reference emplace_back(Args&& ... args);
+		void pop_back();
+		void swap(ChunkedStack& other) noexcept;
+
+	private:
+		struct Chunk
+		{
+			Chunk* prev = nullptr;
+			Chunk* next = nullptr;
+			typename std::aligned_storage<sizeof(T), alignof(T)>::type slots[K];
+
+			T* elements() noexcept { return reinterpret_cast<T*>(slots); }
+			const T* elements() const noexcept { return reinterpret_cast<const T*>(slots); }
+		};
+
+		using chunk_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Chunk>;
+		using chunk_traits = std::allocator_traits<chunk_allocator>;
+
+		chunk_allocator allocator;
+		Chunk* bottom = nullptr;
+		Chunk* top = nullptr;					//Holds back(), its next is always null
+		Chunk* spare = nullptr;					//Emptied last, not linked
+		T* cursor = nullptr;					//Past back(), at the start of top only if the stack is empty
+		T* limit = nullptr;						//Past the last slot of top, a push that reaches it takes a new chunk
+		size_type element_count = 0;
+
+		//Helper functions
+		inline Chunk* _create_chunk();
+		inline void _destroy_chunk(Chunk* chunk) noexcept;
+		inline void _keep_spare(Chunk* chunk) noexcept;
+		inline void _release() noexcept;				//Destroys every element and frees every chunk
+		template <typename ... Args> reference _emplace_in_new_chunk(Args&& ... args);
+
+		class ChunkedStackIterator
+		{
+		public:
+			using self_type = ChunkedStackIterator;
+			using value_type = T;
+			using reference = T&;
+			using pointer = T*;
+			using difference_type = ptrdiff_t;
+			using iterator_category = std::forward_iterator_tag;
+
+			ChunkedStackIterator() {}
+
+			self_type& operator++() { if (++index == K && chunk->next) { chunk = chunk->next; index = 0; } return *this; }
+			self_type operator++(int) { self_type ret(*this); ++*this; return ret; }
+			bool operator==(const self_type& rhs) const { return chunk == rhs.chunk && index == rhs.index; }
+			bool operator!=(const self_type& rhs) const { return !(*this == rhs); }
+			reference operator*() const { return chunk->elements()[index]; }
+			pointer operator->() const { return &**this; }
+
+		private:
+			ChunkedStackIterator(Chunk* _chunk, size_type _index) : chunk(_chunk), index(_index) {}
+
+		private:
+			friend class ChunkedStack;
+			friend class ChunkedStackConstIterator;
+			Chunk* chunk = nullptr;
+			size_type index = 0;				//K only at end() of a full top chunk
+		};
+
+		class ChunkedStackConstIterator
+		{
+		public:
+			using self_type = ChunkedStackConstIterator;
+			using value_type = T;
+			using reference = const T&;
+			using pointer = const T*;
+			using difference_type = ptrdiff_t;
+			using iterator_category = std::forward_iterator_tag;
+
+			ChunkedStackConstIterator() {}
+			ChunkedStackConstIterator(const ChunkedStackIterator& origin) : chunk(origin.chunk), index(origin.index) {}
+
+			self_type& operator++() { if (++index == K && chunk->next) { chunk = chunk->next; index = 0; } return *this; }
+			self_type operator++(int) { self_type ret(*this); ++*this; return ret; }
+			bool operator==(const self_type& rhs) const { return chunk == rhs.chunk && index == rhs.index; }
+			bool operator!=(const self_type& rhs) const { return !(*this == rhs); }
+			reference operator*() const { return chunk->elements()[index]; }
+			pointer operator->() const { return &**this; }
+
+		private:
+			ChunkedStackConstIterator(const Chunk* _chunk, size_type _index) : chunk(_chunk), index(_index) {}
+
+		private:
+			friend class ChunkedStack;
+			const Chunk* chunk = nullptr;
+			size_type index = 0;
+		};
+	};
+
+	//Non-Member Functions
+	template<typename T, size_t K, class Allocator> bool operator==(const ChunkedStack<T, K, Allocator>& lhs, const ChunkedStack<T, K, Allocator>& rhs);
+	template<typename T, size_t K, class Allocator> bool operator!=(const ChunkedStack<T, K, Allocator>& lhs, const ChunkedStack<T, K, Allocator>& rhs);
+	template<typename T, size_t K, class Allocator> bool operator<(const ChunkedStack<T, K, Allocator>& lhs, const ChunkedStack<T, K, Allocator>& rhs);
+	template<typename T, size_t K, class Allocator> bool operator<=(const ChunkedStack<T, K, Allocator>& lhs, const ChunkedStack<T, K, Allocator>& rhs);
+	template<typename T, size_t K, class Allocator> bool operator>(const ChunkedStack<T, K, Allocator>& lhs, const ChunkedStack<T, K, Allocator>& rhs);
+	template<typename T, size_t K, class Allocator> bool operator>=(const ChunkedStack<T, K, Allocator>& lhs, const ChunkedStack<T, K, Allocator>& rhs);
+	template<typename T, size_t K, class Allocator> void swap(ChunkedStack<T, K, Allocator>& lhs, ChunkedStack<T, K, Allocator>& rhs) noexcept;
+
+	/* Dividing Line ( 㧥 ;) ( 㧥 ;) ( 㧥 ;)  */
+
+	template<typename T, size_t K, class Allocator>
+	inline ChunkedStack<T, K, Allocator>::ChunkedStack() noexcept
+	{
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline ChunkedStack<T, K, Allocator>::ChunkedStack(const Allocator & alloc) noexcept : allocator(alloc)
+	{
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline ChunkedStack<T, K, Allocator>::ChunkedStack(size_type n, const T & val, const Allocator & alloc) : allocator(alloc)
+	{
+		try
+		{
+			for (size_type i = 0; i < n; i++)
+				emplace_back(val);
+		}
+		catch (...)
+		{
+			_release();
+			throw;
+		}
+	}
+
+	template<typename T, size_t K, class Allocator>
+	template<typename InputIterator, typename SFINAE_MAGIC>
+	inline ChunkedStack<T, K, Allocator>::ChunkedStack(InputIterator first, InputIterator last, const Allocator & alloc) : allocator(alloc)
+	{
+		try
+		{
+			while (first != last)
+				emplace_back(*first++);
+		}
+		catch (...)
+		{
+			_release();
+			throw;
+		}
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline ChunkedStack<T, K, Allocator>::ChunkedStack(std::initializer_list<T> init, const Allocator & alloc) :
+		ChunkedStack(init.begin(), init.end(), alloc)
+	{
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline ChunkedStack<T, K, Allocator>::ChunkedStack(const ChunkedStack & origin) :
+		ChunkedStack(origin.cbegin(), origin.cend(), origin.get_allocator())
+	{
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline ChunkedStack<T, K, Allocator>::ChunkedStack(ChunkedStack && origin) noexcept : allocator(origin.allocator)
+	{
+		swap(origin);
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline ChunkedStack<T, K, Allocator>::~ChunkedStack()
+	{
+		_release();
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline ChunkedStack<T, K, Allocator> & ChunkedStack<T, K, Allocator>::operator=(const ChunkedStack & origin)
+	{
+		ChunkedStack temp(origin);
+		swap(temp);
+		return *this;
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline ChunkedStack<T, K, Allocator> & ChunkedStack<T, K, Allocator>::operator=(ChunkedStack && origin) noexcept
+	{
+		swap(origin);
+		return *this;
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline ChunkedStack<T, K, Allocator> & ChunkedStack<T, K, Allocator>::operator=(std::initializer_list<T> init)
+	{
+		ChunkedStack temp(init, get_allocator());
+		swap(temp);
+		return *this;
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline typename ChunkedStack<T, K, Allocator>::allocator_type ChunkedStack<T, K, Allocator>::get_allocator() const
+	{
+		return allocator_type(allocator);
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline typename ChunkedStack<T, K, Allocator>::reference ChunkedStack<T, K, Allocator>::back()
+	{
+		return cursor[-1];
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline typename ChunkedStack<T, K, Allocator>::const_reference ChunkedStack<T, K, Allocator>::back() const
+	{
+		return cursor[-1];
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline typename ChunkedStack<T, K, Allocator>::iterator ChunkedStack<T, K, Allocator>::begin() noexcept
+	{
+		return iterator(bottom, 0);
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline typename ChunkedStack<T, K, Allocator>::const_iterator ChunkedStack<T, K, Allocator>::begin() const noexcept
+	{
+		return const_iterator(bottom, 0);
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline typename ChunkedStack<T, K, Allocator>::const_iterator ChunkedStack<T, K, Allocator>::cbegin() const noexcept
+	{
+		return const_iterator(bottom, 0);
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline typename ChunkedStack<T, K, Allocator>::iterator ChunkedStack<T, K, Allocator>::end() noexcept
+	{
+		return iterator(top, top ? size_type(cursor - top->elements()) : 0);
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline typename ChunkedStack<T, K, Allocator>::const_iterator ChunkedStack<T, K, Allocator>::end() const noexcept
+	{
+		return const_iterator(top, top ? size_type(cursor - top->elements()) : 0);
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline typename ChunkedStack<T, K, Allocator>::const_iterator ChunkedStack<T, K, Allocator>::cend() const noexcept
+	{
+		return const_iterator(top, top ? size_type(cursor - top->elements()) : 0);
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline bool ChunkedStack<T, K, Allocator>::empty() const noexcept
+	{
+		return element_count == 0;
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline typename ChunkedStack<T, K, Allocator>::size_type ChunkedStack<T, K, Allocator>::size() const noexcept
+	{
+		return element_count;
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline void ChunkedStack<T, K, Allocator>::shrink_to_fit() noexcept
+	{
+		if (spare)
+			_destroy_chunk(spare);
+		spare = nullptr;
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline void ChunkedStack<T, K, Allocator>::clear() noexcept
+	{
+		if (!top)
+			return;
+		while (true)
+		{
+			for (T* elem = top->elements(); elem != cursor; ++elem)
+				chunk_traits::destroy(allocator, elem);
+			if (top == bottom)
+				break;
+			Chunk* chunk = top;
+			top = top->prev;
+			cursor = top->elements() + K;
+			_keep_spare(chunk);
+		}
+		top->next = nullptr;
+		cursor = top->elements();
+		limit = cursor + K;
+		element_count = 0;
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline void ChunkedStack<T, K, Allocator>::push_back(const T & val)
+	{
+		emplace_back(val);
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline void ChunkedStack<T, K, Allocator>::push_back(T && val)
+	{
+		emplace_back(std::move(val));
+	}
+
+	template<typename T, size_t K, class Allocator>
+	template<typename ... Args>
+	inline typename ChunkedStack<T, K, Allocator>::reference ChunkedStack<T, K, Allocator>::emplace_back(Args && ... args)
+	{
+		if (cursor == limit)
+			return _emplace_in_new_chunk(std::forward<Args>(args)...);
+		chunk_traits::construct(allocator, cursor, std::forward<Args>(args)...);
+		++element_count;
+		return *cursor++;
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline void ChunkedStack<T, K, Allocator>::pop_back()
+	{
+		chunk_traits::destroy(allocator, --cursor);
+		--element_count;
+		if (cursor == top->elements() && top->prev)
+		{
+			Chunk* chunk = top;
+			top = top->prev;
+			top->next = nullptr;
+			cursor = limit = top->elements() + K;
+			_keep_spare(chunk);
+		}
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline void ChunkedStack<T, K, Allocator>::swap(ChunkedStack & other) noexcept
+	{
+		std::swap(allocator, other.allocator);
+		std::swap(bottom, other.bottom);
+		std::swap(top, other.top);
+		std::swap(spare, other.spare);
+		std::swap(cursor, other.cursor);
+		std::swap(limit, other.limit);
+		std::swap(element_count, other.element_count);
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline typename ChunkedStack<T, K, Allocator>::Chunk * ChunkedStack<T, K, Allocator>::_create_chunk()
+	{
+		Chunk* chunk = chunk_traits::allocate(allocator, 1);
+		::new (static_cast<void*>(chunk)) Chunk;
+		return chunk;
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline void ChunkedStack<T, K, Allocator>::_destroy_chunk(Chunk * chunk) noexcept
+	{
+		chunk->~Chunk();
+		chunk_traits::deallocate(allocator, chunk, 1);
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline void ChunkedStack<T, K, Allocator>::_keep_spare(Chunk * chunk) noexcept
+	{
+		//One spare is enough to stop the thrash at a boundary, more would only hold memory of a stack that shrank
+		if (spare)
+			_destroy_chunk(spare);
+		chunk->prev = chunk->next = nullptr;
+		spare = chunk;
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline void ChunkedStack<T, K, Allocator>::_release() noexcept
+	{
+		clear();
+		if (bottom)
+			_destroy_chunk(bottom);
+		shrink_to_fit();
+		bottom = top = nullptr;
+		cursor = limit = nullptr;
+	}
+
+	template<typename T, size_t K, class Allocator>
+	template<typename ... Args>
+	inline typename ChunkedStack<T, K, Allocator>::reference ChunkedStack<T, K, Allocator>::_emplace_in_new_chunk(Args && ... args)
+	{
+		Chunk* chunk = spare ? spare : _create_chunk();
+		spare = nullptr;
+		try
+		{
+			chunk_traits::construct(allocator, chunk->elements(), std::forward<Args>(args)...);
+		}
+		catch (...)
+		{
+			spare = chunk;
+			throw;
+		}
+		chunk->prev = top;
+		if (top)
+			top->next = chunk;
+		else
+			bottom = chunk;
+		top = chunk;
+		cursor = chunk->elements() + 1;
+		limit = chunk->elements() + K;
+		++element_count;
+		return *chunk->elements();
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline bool operator==(const ChunkedStack<T, K, Allocator>& lhs, const ChunkedStack<T, K, Allocator>& rhs)
+	{
+		return lhs.size() == rhs.size() && std::equal(lhs.cbegin(), lhs.cend(), rhs.cbegin());
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline bool operator!=(const ChunkedStack<T, K, Allocator>& lhs, const ChunkedStack<T, K, Allocator>& rhs)
+	{
+		return !(lhs == rhs);
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline bool operator<(const ChunkedStack<T, K, Allocator>& lhs, const ChunkedStack<T, K, Allocator>& rhs)
+	{
+		return std::lexicographical_compare(lhs.cbegin(), lhs.cend(), rhs.cbegin(), rhs.cend());
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline bool operator<=(const ChunkedStack<T, K, Allocator>& lhs, const ChunkedStack<T, K, Allocator>& rhs)
+	{
+		return !(rhs < lhs);
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline bool operator>(const ChunkedStack<T, K, Allocator>& lhs, const ChunkedStack<T, K, Allocator>& rhs)
+	{
+		return rhs < lhs;
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline bool operator>=(const ChunkedStack<T, K, Allocator>& lhs, const ChunkedStack<T, K, Allocator>& rhs)
+	{
+		return !(lhs < rhs);
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline void swap(ChunkedStack<T, K, Allocator>& lhs, ChunkedStack<T, K, Allocator>& rhs) noexcept
+	{
+		lhs.swap(rhs);
+	}
+}
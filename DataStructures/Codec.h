@@ -0,0 +1,320 @@
+#pragma once
+#include <stdexcept>
+#include <cstring>
+#include "BasicString.h"
+#include "BasicStringView.h"
+#include "SIMD.h"
+
+namespace DataStructures
+{
+	enum class Base64Alphabet
+	{
+		Standard,	//RFC 4648 section 4, A-Z a-z 0-9 + /, padded with '='
+		UrlSafe		//RFC 4648 section 5, A-Z a-z 0-9 - _, not padded
+	};
+
+	//Base64 and hexadecimal codecs between binary data and text. The size of the output is computed exactly
+	//beforehand, so the String versions allocate once and the raw versions write into a buffer of that size.
+	//With SSSE3, base64 turns 12 bytes into 16 characters per step and back with the shuffles of W. Mula and D. Lemire,
+	//"Faster Base64 Encoding and Decoding Using AVX2 Instructions". Hexadecimal takes 16 bytes per step with SSE2.
+	//Decoding accepts base64 with or without padding in either alphabet's own characters, and hexadecimal in either case.
+	//Anything else, whitespace included, throws invalid_argument, as do base64 bits left over after the last byte
+	//that are not zero, so every byte string has exactly one encoding.
+
+	size_t base64_encoded_size(size_t n, Base64Alphabet alphabet = Base64Alphabet::Standard) noexcept;
+	size_t base64_decoded_size(StringView text) noexcept;	//Exact for valid input
+	size_t base64_encode(const void* data, size_t n, char* out, Base64Alphabet alphabet = Base64Alphabet::Standard) noexcept;	//Returns characters written
+	size_t base64_decode(const char* text, size_t n, void* out, Base64Alphabet alphabet = Base64Alphabet::Standard);			//Returns bytes written
+	String base64_encode(StringView data, Base64Alphabet alphabet = Base64Alphabet::Standard);
+	String base64_decode(StringView text, Base64Alphabet alphabet = Base64Alphabet::Standard);
+
+	size_t hex_encode(const void* data, size_t n, char* out, bool upper_case = false) noexcept;	//Writes 2 * n characters
+	size_t hex_decode(const char* text, size_t n, void* out);									//Writes n / 2 bytes
+	String hex_encode(StringView data, bool upper_case = false);
+	String hex_decode(StringView text);
+
+	/* Dividing Line ( 㧥 ;) ( 㧥 ;) ( 㧥 ;)  */
+
+	inline const char* _base64_characters(Base64Alphabet alphabet) noexcept
+	{
+		return alphabet == Base64Alphabet::Standard
+			? "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/"
+			: "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+	}
+
+	//Value of each character, 0xFF for characters outside the alphabet
+	inline const unsigned char* _base64_values(Base64Alphabet alphabet) noexcept
+	{
+		static const struct Tables
+		{
+			unsigned char values[2][256];
+
+			Tables()
+			{
+				memset(values, 0xFF, sizeof(values));
+				for (int i = 0; i < 2; i++)
+				{
+					const char* characters = _base64_characters(Base64Alphabet(i));
+					for (unsigned char value = 0; value < 64; value++)
+						values[i][static_cast<unsigned char>(characters[value])] = value;
+				}
+			}
+		} tables;
+		return tables.values[int(alphabet)];
+	}
+
+	inline size_t _base64_unpadded_size(const char* text, size_t n) noexcept
+	{
+		if (n % 4 == 0 && n && text[n - 1] == '=')
+			n -= 1 + (text[n - 2] == '=');
+		return n;
+	}
+
+#if defined(DATASTRUCTURES_SSSE3)
+	//Spreads the 4 sextets of each 3 bytes out to 4 bytes and maps them to characters. shift holds what to add to a sextet
+	//for its range: 'A' for 0-25, 'a' - 26 for 26-51, '0' - 52 for 52-61, then the two characters that differ between alphabets.
+	inline __m128i _base64_encode_block(__m128i input, __m128i shift) noexcept
+	{
+		input = _mm_shuffle_epi8(input, _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+		__m128i high = _mm_mulhi_epu16(_mm_and_si128(input, _mm_set1_epi32(0x0FC0FC00)), _mm_set1_epi32(0x04000040));
+		__m128i low = _mm_mullo_epi16(_mm_and_si128(input, _mm_set1_epi32(0x003F03F0)), _mm_set1_epi32(0x01000010));
+		__m128i sextets = _mm_or_si128(high, low);
+		//0 for 26-51, 1-12 for 52-63, 13 for 0-25
+		__m128i range = _mm_subs_epu8(sextets, _mm_set1_epi8(51));
+		range = _mm_or_si128(range, _mm_and_si128(_mm_cmpgt_epi8(_mm_set1_epi8(26), sextets), _mm_set1_epi8(13)));
+		return _mm_add_epi8(sextets, _mm_shuffle_epi8(shift, range));
+	}
+
+	//Sextets of 16 standard characters, sets error if any is outside the alphabet. A character is valid when the bits
+	//its low and high nibble select in two tables do not overlap.
+	inline __m128i _base64_decode_block(__m128i input, __m128i& error) noexcept
+	{
+		const __m128i low_table = _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+		const __m128i high_table = _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+		const __m128i roll_table = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+		const __m128i nibble = _mm_set1_epi8(0x0F);
+		__m128i high_nibbles = _mm_and_si128(_mm_srli_epi32(input, 4), nibble);
+		__m128i low_bits = _mm_shuffle_epi8(low_table, _mm_and_si128(input, nibble));
+		__m128i high_bits = _mm_shuffle_epi8(high_table, high_nibbles);
+		error = _mm_or_si128(error, _mm_and_si128(low_bits, high_bits));
+		__m128i roll = _mm_shuffle_epi8(roll_table, _mm_add_epi8(_mm_cmpeq_epi8(input, _mm_set1_epi8('/')), high_nibbles));
+		return _mm_add_epi8(input, roll);
+	}
+
+	//12 bytes from the sextets of 16 characters, in the low 12 bytes
+	inline __m128i _base64_pack_block(__m128i sextets) noexcept
+	{
+		__m128i pairs = _mm_maddubs_epi16(sextets, _mm_set1_epi32(0x01400140));
+		__m128i triples = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000));
+		return _mm_shuffle_epi8(triples, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+	}
+
+	//Decodes 16 characters at a time while at least 24 remain, so that storing 16 bytes for 12 stays inside the output
+	template<bool UrlSafe>
+	inline void _base64_decode_blocks(const unsigned char*& curr, const unsigned char* last, unsigned char*& out)
+	{
+		__m128i error = _mm_setzero_si128();
+		for (; last - curr >= 24; curr += 16, out += 12)
+		{
+			__m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(curr));
+			if (UrlSafe)
+			{
+				//'+' and '/' are not in the alphabet, '-' and '_' take their place
+				__m128i plus = _mm_cmpeq_epi8(input, _mm_set1_epi8('+'));
+				__m128i slash = _mm_cmpeq_epi8(input, _mm_set1_epi8('/'));
+				error = _mm_or_si128(error, _mm_or_si128(plus, slash));
+				__m128i minus = _mm_and_si128(_mm_cmpeq_epi8(input, _mm_set1_epi8('-')), _mm_set1_epi8('+' - '-'));
+				__m128i underscore = _mm_and_si128(_mm_cmpeq_epi8(input, _mm_set1_epi8('_')), _mm_set1_epi8('/' - '_'));
+				input = _mm_add_epi8(input, _mm_or_si128(minus, underscore));
+			}
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out), _base64_pack_block(_base64_decode_block(input, error)));
+		}
+		if (_mm_movemask_epi8(_mm_cmpeq_epi8(error, _mm_setzero_si128())) != 0xFFFF)
+			throw std::invalid_argument{ "Invalid base64 input!" };
+	}
+#endif
+
+	inline size_t base64_encoded_size(size_t n, Base64Alphabet alphabet) noexcept
+	{
+		return alphabet == Base64Alphabet::Standard ? (n + 2) / 3 * 4 : n / 3 * 4 + (n % 3 ? n % 3 + 1 : 0);
+	}
+
+	inline size_t base64_decoded_size(StringView text) noexcept
+	{
+		size_t n = _base64_unpadded_size(text.data(), text.size());
+		return n / 4 * 3 + (n % 4 > 1 ? n % 4 - 1 : 0);
+	}
+
+	inline size_t base64_encode(const void * data, size_t n, char * out, Base64Alphabet alphabet) noexcept
+	{
+		const unsigned char* curr = static_cast<const unsigned char*>(data);
+		const unsigned char* last = curr + n;
+		const char* characters = _base64_characters(alphabet);
+		char* first_out = out;
+#if defined(DATASTRUCTURES_SSSE3)
+		const __m128i shift = alphabet == Base64Alphabet::Standard
+			? _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0)
+			: _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '-' - 62, '_' - 63, 'A', 0, 0);
+		for (; last - curr >= 16; curr += 12, out += 16)	//Loads 16 bytes, uses 12
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out), _base64_encode_block(_mm_loadu_si128(reinterpret_cast<const __m128i*>(curr)), shift));
+#endif
+		for (; last - curr >= 3; curr += 3, out += 4)
+		{
+			unsigned triple = unsigned(curr[0]) << 16 | unsigned(curr[1]) << 8 | curr[2];
+			out[0] = characters[triple >> 18];
+			out[1] = characters[triple >> 12 & 0x3F];
+			out[2] = characters[triple >> 6 & 0x3F];
+			out[3] = characters[triple & 0x3F];
+		}
+		if (curr != last)
+		{
+			unsigned triple = unsigned(curr[0]) << 16 | (last - curr == 2 ? unsigned(curr[1]) << 8 : 0);
+			*out++ = characters[triple >> 18];
+			*out++ = characters[triple >> 12 & 0x3F];
+			if (last - curr == 2) *out++ = characters[triple >> 6 & 0x3F];
+			if (alphabet == Base64Alphabet::Standard)
+			{
+				if (last - curr == 1) *out++ = '=';
+				*out++ = '=';
+			}
+		}
+		return size_t(out - first_out);
+	}
+
+	inline size_t base64_decode(const char * text, size_t n, void * out, Base64Alphabet alphabet)
+	{
+		const unsigned char* curr = reinterpret_cast<const unsigned char*>(text);
+		const unsigned char* last = curr + _base64_unpadded_size(text, n);
+		if ((last - curr) % 4 == 1)
+			throw std::invalid_argument{ "Invalid base64 input!" };
+		const unsigned char* values = _base64_values(alphabet);
+		unsigned char* first_out = static_cast<unsigned char*>(out);
+		unsigned char* out_curr = first_out;
+#if defined(DATASTRUCTURES_SSSE3)
+		if (alphabet == Base64Alphabet::UrlSafe)
+			_base64_decode_blocks<true>(curr, last, out_curr);
+		else
+			_base64_decode_blocks<false>(curr, last, out_curr);
+#endif
+		unsigned invalid = 0;
+		for (; last - curr >= 4; curr += 4, out_curr += 3)
+		{
+			unsigned a = values[curr[0]], b = values[curr[1]], c = values[curr[2]], d = values[curr[3]];
+			invalid |= a | b | c | d;
+			unsigned triple = a << 18 | b << 12 | c << 6 | d;
+			out_curr[0] = static_cast<unsigned char>(triple >> 16);
+			out_curr[1] = static_cast<unsigned char>(triple >> 8);
+			out_curr[2] = static_cast<unsigned char>(triple);
+		}
+		if (curr != last)
+		{
+			unsigned a = values[curr[0]], b = values[curr[1]], c = last - curr == 3 ? values[curr[2]] : 0;
+			invalid |= a | b | c | (((last - curr == 2) ? (b & 0x0F) : (c & 0x03)) != 0) << 7;	//Bits after the last byte must be zero
+			unsigned triple = a << 18 | b << 12 | c << 6;
+			*out_curr++ = static_cast<unsigned char>(triple >> 16);
+			if (last - curr == 3) *out_curr++ = static_cast<unsigned char>(triple >> 8);
+		}
+		if (invalid & 0x80)
+			throw std::invalid_argument{ "Invalid base64 input!" };
+		return size_t(out_curr - first_out);
+	}
+
+	inline String base64_encode(StringView data, Base64Alphabet alphabet)
+	{
+		String result(base64_encoded_size(data.size(), alphabet), '\0');
+		base64_encode(data.data(), data.size(), result.data(), alphabet);
+		return result;
+	}
+
+	inline String base64_decode(StringView text, Base64Alphabet alphabet)
+	{
+		String result(base64_decoded_size(text), '\0');
+		base64_decode(text.data(), text.size(), result.data(), alphabet);
+		return result;
+	}
+
+	inline size_t hex_encode(const void * data, size_t n, char * out, bool upper_case) noexcept
+	{
+		const unsigned char* curr = static_cast<const unsigned char*>(data);
+		const unsigned char* last = curr + n;
+		const char* digits = upper_case ? "0123456789ABCDEF" : "0123456789abcdef";
+#if defined(DATASTRUCTURES_SSE2)
+		const __m128i nibble = _mm_set1_epi8(0x0F);
+		const __m128i letter_offset = _mm_set1_epi8(char(upper_case ? 'A' - '0' - 10 : 'a' - '0' - 10));
+		auto to_digits = [&](__m128i x)
+		{
+			return _mm_add_epi8(_mm_add_epi8(x, _mm_set1_epi8('0')), _mm_and_si128(_mm_cmpgt_epi8(x, _mm_set1_epi8(9)), letter_offset));
+		};
+		for (; last - curr >= 16; curr += 16, out += 32)
+		{
+			__m128i input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(curr));
+			__m128i high = to_digits(_mm_and_si128(_mm_srli_epi16(input, 4), nibble));
+			__m128i low = to_digits(_mm_and_si128(input, nibble));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_unpacklo_epi8(high, low));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16), _mm_unpackhi_epi8(high, low));
+		}
+#endif
+		for (; curr != last; ++curr, out += 2)
+		{
+			out[0] = digits[*curr >> 4];
+			out[1] = digits[*curr & 0x0F];
+		}
+		return 2 * n;
+	}
+
+	inline size_t hex_decode(const char * text, size_t n, void * out)
+	{
+		if (n % 2)
+			throw std::invalid_argument{ "Invalid hexadecimal input!" };
+		const unsigned char* curr = reinterpret_cast<const unsigned char*>(text);
+		const unsigned char* last = curr + n;
+		unsigned char* out_curr = static_cast<unsigned char*>(out);
+#if defined(DATASTRUCTURES_SSE2)
+		//Digits and letters are moved to the bottom of the signed range, where one compare tells if they fit
+		__m128i valid = _mm_set1_epi8(-1);
+		auto to_values = [&](__m128i x)
+		{
+			__m128i digit = _mm_sub_epi8(x, _mm_set1_epi8('0'));
+			__m128i is_digit = _mm_cmplt_epi8(_mm_add_epi8(digit, _mm_set1_epi8(char(0x80))), _mm_set1_epi8(char(0x80 + 10)));
+			__m128i letter = _mm_sub_epi8(_mm_or_si128(x, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+			__m128i is_letter = _mm_cmplt_epi8(_mm_add_epi8(letter, _mm_set1_epi8(char(0x80))), _mm_set1_epi8(char(0x80 + 6)));
+			valid = _mm_and_si128(valid, _mm_or_si128(is_digit, is_letter));
+			return _mm_or_si128(_mm_and_si128(is_digit, digit), _mm_and_si128(is_letter, _mm_add_epi8(letter, _mm_set1_epi8(10))));
+		};
+		const __m128i low_byte = _mm_set1_epi16(0x00FF);
+		for (; last - curr >= 32; curr += 32, out_curr += 16)
+		{
+			//Each 16-bit lane holds a high nibble in its low byte and a low nibble in its high byte
+			__m128i first = to_values(_mm_loadu_si128(reinterpret_cast<const __m128i*>(curr)));
+			__m128i second = to_values(_mm_loadu_si128(reinterpret_cast<const __m128i*>(curr + 16)));
+			first = _mm_and_si128(_mm_or_si128(_mm_slli_epi16(first, 4), _mm_srli_epi16(first, 8)), low_byte);
+			second = _mm_and_si128(_mm_or_si128(_mm_slli_epi16(second, 4), _mm_srli_epi16(second, 8)), low_byte);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out_curr), _mm_packus_epi16(first, second));
+		}
+		if (_mm_movemask_epi8(valid) != 0xFFFF)
+			throw std::invalid_argument{ "Invalid hexadecimal input!" };
+#endif
+		for (; curr != last; curr += 2)
+		{
+			unsigned high = _digit_value(curr[0]), low = _digit_value(curr[1]);
+			if (high > 15 || low > 15)
+				throw std::invalid_argument{ "Invalid hexadecimal input!" };
+			*out_curr++ = static_cast<unsigned char>(high << 4 | low);
+		}
+		return n / 2;
+	}
+
+	inline String hex_encode(StringView data, bool upper_case)
+	{
+		String result(2 * data.size(), '\0');
+		hex_encode(data.data(), data.size(), result.data(), upper_case);
+		return result;
+	}
+
+	inline String hex_decode(StringView text)
+	{
+		String result(text.size() / 2, '\0');
+		hex_decode(text.data(), text.size(), result.data());
+		return result;
+	}
+}
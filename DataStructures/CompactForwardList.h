@@ -0,0 +1,793 @@
+#pragma once
+#include <stdexcept>
+#include <memory>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <initializer_list>
+#include "Vector.h"
+
+namespace DataStructures
+{
+	//Singly linked list whose nodes are elements of one Vector and link to each other by 32-bit index. A node is the
+	//value plus 4 bytes, 8 bytes for an int where ForwardList spends 16 plus the allocator's header. There is one
+	//allocation per growth of the arena instead of one per node, and erased nodes go to a free list and are reused.
+	//The interface follows ForwardList. Iterators hold the list and an index, so growing the arena does not
+	//invalidate them. merge() and splice_after() move values between arenas, they are O(n) in the elements moved.
+	//At most 2^32 - 2 elements.
+	template<typename T, class Allocator = std::allocator<T>>
+	class CompactForwardList
+	{
+	private:
+		struct CompactForwardListNode;
+		class CompactForwardListIterator;
+		class CompactForwardListConstIterator;
+
+	public:
+		using allocator_type	= Allocator;
+		using value_type		= T;
+		using reference			= T&;
+		using const_reference	= const T&;
+		using pointer			= T*;
+		using const_pointer		= const T*;
+		using difference_type	= ptrdiff_t;
+		using size_type			= size_t;
+		using index_type		= uint32_t;
+
+		using iterator			= CompactForwardListIterator;
+		using const_iterator	= CompactForwardListConstIterator;
+
+		//Constructor, Destructor and Assignment
+		CompactForwardList();
+		explicit CompactForwardList(const Allocator& alloc);
+		CompactForwardList(size_type n, const T& val, const Allocator& alloc = Allocator());
+
+		template<typename InputIterator, typename = typename std::enable_if_t<std::_Is_iterator<InputIterator>::value>>
+		CompactForwardList(InputIterator first, InputIterator last, const Allocator& alloc = Allocator());
+
+		CompactForwardList(std::initializer_list<T> init, const Allocator& alloc = Allocator());
+		CompactForwardList(const CompactForwardList& origin);
+		CompactForwardList(CompactForwardList&& origin);
+		~CompactForwardList();
+		CompactForwardList& operator=(const CompactForwardList& origin);
+		CompactForwardList& operator=(CompactForwardList&& origin);
+		CompactForwardList& operator=(std::initializer_list<T> init);
+		allocator_type get_allocator() const;
+
+		//Element access
+		reference front();
+		const_reference front() const;
+		reference back();
+		const_reference back() const;
+
+		//Iterators
+		iterator begin() noexcept;
+		const_iterator begin() const noexcept;
+		const_iterator cbegin() const noexcept;
+		iterator end() noexcept;
+		const_iterator end() const noexcept;
+		const_iterator cend() const noexcept;
+		iterator before_begin() noexcept;
+		const_iterator before_begin() const noexcept;
+		const_iterator cbefore_begin() const noexcept;
+		iterator before_end() noexcept;
+		const_iterator before_end() const noexcept;
+		const_iterator cbefore_end() const noexcept;
+
+		//Capacity
+		bool empty() const noexcept;
+		size_type size() const noexcept;
+		size_type max_size() const noexcept;
+		void reserve(size_type n);		//Room for n elements without growing the arena
+		size_type capacity() const noexcept;
+
+		//Modifiers
+		void clear() noexcept;			//Keeps the arena
+		iterator insert_after(const_iterator pos, const T& val);
+		iterator insert_after(const_iterator pos, T&& val);
+		template <typename ... Args> iterator emplace_after(const_iterator pos, Args&& ... args);
+		iterator erase_after(const_iterator pos);	//Returns the element that followed the erased one
+		iterator erase_after(const_iterator first, const_iterator last);
+		void push_front(const T& val);
+		void push_front(T&& val);
+		template <typename ... Args> reference emplace_front(Args&& ... args);
+		void pop_front();
+		void push_back(const T& val);
+		void push_back(T&& val);
+		template <typename ... Args> reference emplace_back(Args&& ... args);
+		void swap(CompactForwardList& other);
+
+		//Operations
+		void merge(CompactForwardList& other);
+		template<typename Compare> void merge(CompactForwardList& other, Compare comp);
+		void splice_after(const_iterator pos, CompactForwardList& other);
+		void splice_after(const_iterator pos, CompactForwardList& other, const_iterator first);
+		void splice_after(const_iterator pos, CompactForwardList& other, const_iterator first, const_iterator last);
+		void remove(const T& val);	//Remove all value equal to val
+		template<typename UnaryPredicate> void remove_if(UnaryPredicate p);
+		void reverse() noexcept;
+		void unique();	//Remove all consecutive duplicate elements.
+		template<typename BinaryPredicate> void unique(BinaryPredicate p);
+		void sort();	//Stable, O(n log n), relinks indices only
+		template<typename Compare> void sort(Compare comp);
+
+		//Bulk operations, walking the arena directly
+		template<typename Function> Function for_each(Function f);
+		template<typename Function> Function for_each(Function f) const;
+		template<typename U> U accumulate(U init) const;
+		template<typename U, typename BinaryOperation> U accumulate(U init, BinaryOperation op) const;
+
+	private:
+		static constexpr index_type nil = std::numeric_limits<index_type>::max();
+
+		struct CompactForwardListNode
+		{
+			typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;	//Holds a T while the node is linked
+			index_type next = nil;
+
+			T& value() noexcept { return *reinterpret_cast<T*>(&storage); }
+			const T& value() const noexcept { return *reinterpret_cast<const T*>(&storage); }
+		};
+
+		using node_type = CompactForwardListNode;
+		using node_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<node_type>;
+
+		allocator_type allocator;
+		Vector<node_type, node_allocator> nodes;	//nodes[0] holds no value, it is before_begin()
+		index_type last = 0;						//before_end(), 0 while the list is empty
+		index_type free_head = nil;					//Erased nodes, linked through next
+		size_type element_count = 0;
+
+		//Helper functions
+		template<typename ...Args> index_type _link_after(index_type pos, Args&& ...args);
+		inline index_type _unlink_after(index_type pos) noexcept;	//Destroys the value, returns the following index
+		template<typename Compare> static index_type _merge_runs(node_type* base, index_type a, index_type b, Compare& comp);
+
+		class CompactForwardListIterator
+		{
+		public:
+			using self_type = CompactForwardListIterator;
+			using value_type = T;
+			using reference = T&;
+			using pointer = T*;
+			using difference_type = ptrdiff_t;
+			using iterator_category = std::forward_iterator_tag;
+
+			CompactForwardListIterator() {}
+
+			self_type& operator++() { index = list->nodes[index].next; return *this; }
+			self_type operator++(int) { self_type ret(*this); ++*this; return ret; }
+			bool operator==(const self_type& rhs) const { return index == rhs.index; }
+			bool operator!=(const self_type& rhs) const { return index != rhs.index; }
+			reference operator*() const { return list->nodes[index].value(); }
+			pointer operator->() const { return &**this; }
+
+		private:
+			CompactForwardListIterator(CompactForwardList* _list, index_type _index) : list(_list), index(_index) {}
+			CompactForwardListIterator(const CompactForwardListConstIterator& origin) :
+				list(const_cast<CompactForwardList*>(origin.list)), index(origin.index) {}
+
+		private:
+			friend class CompactForwardList;
+			friend class CompactForwardListConstIterator;
+			CompactForwardList* list = nullptr;
+			index_type index = nil;
+		};
+
+		class CompactForwardListConstIterator
+		{
+		public:
+			using self_type = CompactForwardListConstIterator;
+			using value_type = T;
+			using reference = const T&;
+			using pointer = const T*;
+			using difference_type = ptrdiff_t;
+			using iterator_category = std::forward_iterator_tag;
+
+			CompactForwardListConstIterator() {}
+			CompactForwardListConstIterator(const CompactForwardListIterator& origin) : list(origin.list), index(origin.index) {}
+
+			self_type& operator++() { index = list->nodes[index].next; return *this; }
+			self_type operator++(int) { self_type ret(*this); ++*this; return ret; }
+			bool operator==(const self_type& rhs) const { return index == rhs.index; }
+			bool operator!=(const self_type& rhs) const { return index != rhs.index; }
+			reference operator*() const { return list->nodes[index].value(); }
+			pointer operator->() const { return &**this; }
+
+		private:
+			CompactForwardListConstIterator(const CompactForwardList* _list, index_type _index) : list(_list), index(_index) {}
+
+		private:
+			friend class CompactForwardList;
+			friend class CompactForwardListIterator;
+			const CompactForwardList* list = nullptr;
+			index_type index = nil;
+		};
+	};
+
+	/* Dividing Line ( 㧥 ;) ( 㧥 ;) ( 㧥 ;)  */
+
+	template<typename T, class Allocator>
+	inline CompactForwardList<T, Allocator>::CompactForwardList()
+	{
+		nodes.emplace_back();
+	}
+
+	template<typename T, class Allocator>
+	inline CompactForwardList<T, Allocator>::CompactForwardList(const Allocator & alloc) : allocator(alloc), nodes(node_allocator(alloc))
+	{
+		nodes.emplace_back();
+	}
+
+	template<typename T, class Allocator>
+	inline CompactForwardList<T, Allocator>::CompactForwardList(size_type n, const T & val, const Allocator & alloc) :
+		CompactForwardList(alloc)
+	{
+		reserve(n);
+		for (size_type i = 0; i < n; i++)
+			emplace_back(val);
+	}
+
+	template<typename T, class Allocator>
+	template<typename InputIterator, typename SFINAE_MAGIC>
+	inline CompactForwardList<T, Allocator>::CompactForwardList(InputIterator first, InputIterator last, const Allocator & alloc) :
+		CompactForwardList(alloc)
+	{
+		while (first != last)
+			emplace_back(*first++);
+	}
+
+	template<typename T, class Allocator>
+	inline CompactForwardList<T, Allocator>::CompactForwardList(std::initializer_list<T> init, const Allocator & alloc) :
+		CompactForwardList(init.begin(), init.end(), alloc)
+	{
+	}
+
+	//Copies in list order, so the copy has no free nodes and its nodes are in traversal order
+	template<typename T, class Allocator>
+	inline CompactForwardList<T, Allocator>::CompactForwardList(const CompactForwardList & origin) :
+		CompactForwardList(origin.get_allocator())
+	{
+		reserve(origin.size());
+		for (const auto& elem : origin)
+			emplace_back(elem);
+	}
+
+	template<typename T, class Allocator>
+	inline CompactForwardList<T, Allocator>::CompactForwardList(CompactForwardList && origin) :
+		CompactForwardList(origin.get_allocator())
+	{
+		swap(origin);
+	}
+
+	template<typename T, class Allocator>
+	inline CompactForwardList<T, Allocator>::~CompactForwardList()
+	{
+		clear();
+	}
+
+	template<typename T, class Allocator>
+	inline CompactForwardList<T, Allocator> & CompactForwardList<T, Allocator>::operator=(const CompactForwardList & origin)
+	{
+		CompactForwardList temp(origin);
+		swap(temp);
+		return *this;
+	}
+
+	template<typename T, class Allocator>
+	inline CompactForwardList<T, Allocator> & CompactForwardList<T, Allocator>::operator=(CompactForwardList && origin)
+	{
+		swap(origin);
+		return *this;
+	}
+
+	template<typename T, class Allocator>
+	inline CompactForwardList<T, Allocator> & CompactForwardList<T, Allocator>::operator=(std::initializer_list<T> init)
+	{
+		CompactForwardList temp(init, get_allocator());
+		swap(temp);
+		return *this;
+	}
+
+	template<typename T, class Allocator>
+	inline typename CompactForwardList<T, Allocator>::allocator_type CompactForwardList<T, Allocator>::get_allocator() const
+	{
+		return allocator;
+	}
+
+	template<typename T, class Allocator>
+	inline typename CompactForwardList<T, Allocator>::reference CompactForwardList<T, Allocator>::front()
+	{
+		return nodes[nodes[0].next].value();
+	}
+
+	template<typename T, class Allocator>
+	inline typename CompactForwardList<T, Allocator>::const_reference CompactForwardList<T, Allocator>::front() const
+	{
+		return nodes[nodes[0].next].value();
+	}
+
+	template<typename T, class Allocator>
+	inline typename CompactForwardList<T, Allocator>::reference CompactForwardList<T, Allocator>::back()
+	{
+		return nodes[last].value();
+	}
+
+	template<typename T, class Allocator>
+	inline typename CompactForwardList<T, Allocator>::const_reference CompactForwardList<T, Allocator>::back() const
+	{
+		return nodes[last].value();
+	}
+
+	template<typename T, class Allocator>
+	inline typename CompactForwardList<T, Allocator>::iterator CompactForwardList<T, Allocator>::begin() noexcept
+	{
+		return iterator(this, nodes[0].next);
+	}
+
+	template<typename T, class Allocator>
+	inline typename CompactForwardList<T, Allocator>::const_iterator CompactForwardList<T, Allocator>::begin() const noexcept
+	{
+		return const_iterator(this, nodes[0].next);
+	}
+
+	template<typename T, class Allocator>
+	inline typename CompactForwardList<T, Allocator>::const_iterator CompactForwardList<T, Allocator>::cbegin() const noexcept
+	{
+		return const_iterator(this, nodes[0].next);
+	}
+
+	template<typename T, class Allocator>
+	inline typename CompactForwardList<T, Allocator>::iterator CompactForwardList<T, Allocator>::end() noexcept
+	{
+		return iterator(this, nil);
+	}
+
+	template<typename T, class Allocator>
+	inline typename CompactForwardList<T, Allocator>::const_iterator CompactForwardList<T, Allocator>::end() const noexcept
+	{
+		return const_iterator(this, nil);
+	}
+
+	template<typename T, class Allocator>
+	inline typename CompactForwardList<T, Allocator>::const_iterator CompactForwardList<T, Allocator>::cend() const noexcept
+	{
+		return const_iterator(this, nil);
+	}
+
+	template<typename T, class Allocator>
+	inline typename CompactForwardList<T, Allocator>::iterator CompactForwardList<T, Allocator>::before_begin() noexcept
+	{
+		return iterator(this, 0);
+	}
+
+	template<typename T, class Allocator>
+	inline typename CompactForwardList<T, Allocator>::const_iterator CompactForwardList<T, Allocator>::before_begin() const noexcept
+	{
+		return const_iterator(this, 0);
+	}
+
+	template<typename T, class Allocator>
+	inline typename CompactForwardList<T, Allocator>::const_iterator CompactForwardList<T, Allocator>::cbefore_begin() const noexcept
+	{
+		return const_iterator(this, 0);
+	}
+
+	template<typename T, class Allocator>
+	inline typename CompactForwardList<T, Allocator>::iterator CompactForwardList<T, Allocator>::before_end() noexcept
+	{
+		return iterator(this, last);
+	}
+
+	template<typename T, class Allocator>
+	inline typename CompactForwardList<T, Allocator>::const_iterator CompactForwardList<T, Allocator>::before_end() const noexcept
+	{
+		return const_iterator(this, last);
+	}
+
+	template<typename T, class Allocator>
+	inline typename CompactForwardList<T, Allocator>::const_iterator CompactForwardList<T, Allocator>::cbefore_end() const noexcept
+	{
+		return const_iterator(this, last);
+	}
+
+	template<typename T, class Allocator>
+	inline bool CompactForwardList<T, Allocator>::empty() const noexcept
+	{
+		return element_count == 0;
+	}
+
+	template<typename T, class Allocator>
+	inline typename CompactForwardList<T, Allocator>::size_type CompactForwardList<T, Allocator>::size() const noexcept
+	{
+		return element_count;
+	}
+
+	template<typename T, class Allocator>
+	inline typename CompactForwardList<T, Allocator>::size_type CompactForwardList<T, Allocator>::max_size() const noexcept
+	{
+		return size_type(nil) - 1;
+	}
+
+	template<typename T, class Allocator>
+	inline void CompactForwardList<T, Allocator>::reserve(size_type n)
+	{
+		if (n > max_size())
+			throw std::length_error{ "CompactForwardList cannot hold that many elements!" };
+		nodes.reserve(n + 1);
+	}
+
+	template<typename T, class Allocator>
+	inline typename CompactForwardList<T, Allocator>::size_type CompactForwardList<T, Allocator>::capacity() const noexcept
+	{
+		return nodes.capacity() - 1;
+	}
+
+	template<typename T, class Allocator>
+	inline void CompactForwardList<T, Allocator>::clear() noexcept
+	{
+		while (nodes[0].next != nil)
+			_unlink_after(0);
+	}
+
+	template<typename T, class Allocator>
+	inline typename CompactForwardList<T, Allocator>::iterator CompactForwardList<T, Allocator>::insert_after(const_iterator pos, const T & val)
+	{
+		return emplace_after(pos, val);
+	}
+
+	template<typename T, class Allocator>
+	inline typename CompactForwardList<T, Allocator>::iterator CompactForwardList<T, Allocator>::insert_after(const_iterator pos, T && val)
+	{
+		return emplace_after(pos, std::move(val));
+	}
+
+	template<typename T, class Allocator>
+	template<typename ...Args>
+	inline typename CompactForwardList<T, Allocator>::iterator CompactForwardList<T, Allocator>::emplace_after(const_iterator pos, Args && ...args)
+	{
+		return iterator(this, _link_after(pos.index, std::forward<Args>(args) ...));
+	}
+
+	template<typename T, class Allocator>
+	inline typename CompactForwardList<T, Allocator>::iterator CompactForwardList<T, Allocator>::erase_after(const_iterator pos)
+	{
+		return iterator(this, _unlink_after(pos.index));
+	}
+
+	template<typename T, class Allocator>
+	inline typename CompactForwardList<T, Allocator>::iterator CompactForwardList<T, Allocator>::erase_after(const_iterator first, const_iterator last)
+	{
+		while (nodes[first.index].next != last.index)
+			_unlink_after(first.index);
+		return iterator(this, last.index);
+	}
+
+	template<typename T, class Allocator>
+	inline void CompactForwardList<T, Allocator>::push_front(const T & val)
+	{
+		_link_after(0, val);
+	}
+
+	template<typename T, class Allocator>
+	inline void CompactForwardList<T, Allocator>::push_front(T && val)
+	{
+		_link_after(0, std::move(val));
+	}
+
+	template<typename T, class Allocator>
+	template<typename ...Args>
+	inline typename CompactForwardList<T, Allocator>::reference CompactForwardList<T, Allocator>::emplace_front(Args && ...args)
+	{
+		return nodes[_link_after(0, std::forward<Args>(args) ...)].value();
+	}
+
+	template<typename T, class Allocator>
+	inline void CompactForwardList<T, Allocator>::pop_front()
+	{
+		_unlink_after(0);
+	}
+
+	template<typename T, class Allocator>
+	inline void CompactForwardList<T, Allocator>::push_back(const T & val)
+	{
+		_link_after(last, val);
+	}
+
+	template<typename T, class Allocator>
+	inline void CompactForwardList<T, Allocator>::push_back(T && val)
+	{
+		_link_after(last, std::move(val));
+	}
+
+	template<typename T, class Allocator>
+	template<typename ...Args>
+	inline typename CompactForwardList<T, Allocator>::reference CompactForwardList<T, Allocator>::emplace_back(Args && ...args)
+	{
+		return nodes[_link_after(last, std::forward<Args>(args) ...)].value();
+	}
+
+	template<typename T, class Allocator>
+	inline void CompactForwardList<T, Allocator>::swap(CompactForwardList & other)
+	{
+		std::swap(allocator, other.allocator);
+		nodes.swap(other.nodes);
+		std::swap(last, other.last);
+		std::swap(free_head, other.free_head);
+		std::swap(element_count, other.element_count);
+	}
+
+	template<typename T, class Allocator>
+	inline void CompactForwardList<T, Allocator>::merge(CompactForwardList & other)
+	{
+		merge(other, std::less<T>());
+	}
+
+	template<typename T, class Allocator>
+	template<typename Compare>
+	inline void CompactForwardList<T, Allocator>::merge(CompactForwardList & other, Compare comp)
+	{
+		if (this == &other) return;
+		if (other.empty()) return;
+		//The values of other are moved into nodes of *this linked after the current last one, then the two runs merged
+		index_type first = last;
+		for (auto& elem : other)
+			_link_after(last, std::move(elem));
+		other.clear();
+		node_type* base = nodes.data();
+		index_type b = base[first].next;
+		base[first].next = nil;
+		base[0].next = _merge_runs(base, base[0].next, b, comp);
+		while (base[last].next != nil)
+			last = base[last].next;
+	}
+
+	template<typename T, class Allocator>
+	inline void CompactForwardList<T, Allocator>::splice_after(const_iterator pos, CompactForwardList & other)
+	{
+		if (this == &other) return;
+		splice_after(pos, other, other.cbefore_begin(), other.cend());
+	}
+
+	template<typename T, class Allocator>
+	inline void CompactForwardList<T, Allocator>::splice_after(const_iterator pos, CompactForwardList & other, const_iterator first)
+	{
+		const_iterator next = first;
+		++next;
+		if (this == &other && (pos == first || pos == next)) return;	//Iterators compare by index only
+		splice_after(pos, other, first, other.cend());
+	}
+
+	template<typename T, class Allocator>
+	inline void CompactForwardList<T, Allocator>::splice_after(const_iterator pos, CompactForwardList & other, const_iterator first, const_iterator last)
+	{
+		index_type curr = pos.index;
+		if (this == &other)
+		{
+			//Within one arena the nodes are relinked
+			index_type tail = first.index;
+			if (nodes[tail].next == last.index) return;
+			while (nodes[tail].next != last.index)
+				tail = nodes[tail].next;
+			index_type moved = nodes[first.index].next;
+			nodes[first.index].next = last.index;
+			if (tail == this->last)
+				this->last = first.index;
+			nodes[tail].next = nodes[curr].next;
+			nodes[curr].next = moved;
+			if (curr == this->last)
+				this->last = tail;
+			return;
+		}
+		while (other.nodes[first.index].next != last.index)
+		{
+			curr = _link_after(curr, std::move(other.nodes[other.nodes[first.index].next].value()));
+			other._unlink_after(first.index);
+		}
+	}
+
+	template<typename T, class Allocator>
+	inline void CompactForwardList<T, Allocator>::remove(const T & val)
+	{
+		remove_if([&val](const T& elem) { return std::equal_to<T>()(val, elem); });
+	}
+
+	template<typename T, class Allocator>
+	template<typename UnaryPredicate>
+	inline void CompactForwardList<T, Allocator>::remove_if(UnaryPredicate p)
+	{
+		index_type prev = 0;
+		while (nodes[prev].next != nil)
+		{
+			if (p(nodes[nodes[prev].next].value()))
+				_unlink_after(prev);
+			else
+				prev = nodes[prev].next;
+		}
+	}
+
+	template<typename T, class Allocator>
+	inline void CompactForwardList<T, Allocator>::reverse() noexcept
+	{
+		node_type* base = nodes.data();
+		index_type reversed = nil;
+		index_type curr = base[0].next;
+		last = curr == nil ? 0 : curr;
+		while (curr != nil)
+		{
+			index_type next = base[curr].next;
+			base[curr].next = reversed;
+			reversed = curr;
+			curr = next;
+		}
+		base[0].next = reversed;
+	}
+
+	template<typename T, class Allocator>
+	inline void CompactForwardList<T, Allocator>::unique()
+	{
+		unique(std::equal_to<T>());
+	}
+
+	template<typename T, class Allocator>
+	template<typename BinaryPredicate>
+	inline void CompactForwardList<T, Allocator>::unique(BinaryPredicate p)
+	{
+		if (empty()) return;
+		index_type prev = nodes[0].next;
+		while (nodes[prev].next != nil)
+		{
+			if (p(nodes[nodes[prev].next].value(), nodes[prev].value()))
+				_unlink_after(prev);
+			else
+				prev = nodes[prev].next;
+		}
+	}
+
+	template<typename T, class Allocator>
+	inline void CompactForwardList<T, Allocator>::sort()
+	{
+		sort(std::less<T>());
+	}
+
+	template<typename T, class Allocator>
+	template<typename Compare>
+	inline void CompactForwardList<T, Allocator>::sort(Compare comp)
+	{
+		if (element_count < 2) return;
+		//Bottom-up like ForwardList: runs[i] is empty or holds 2^i sorted nodes that came before those in lower runs
+		node_type* base = nodes.data();
+		index_type runs[64];
+		for (auto& run : runs)
+			run = nil;
+		index_type curr = base[0].next;
+		while (curr != nil)
+		{
+			index_type run = curr;
+			curr = base[curr].next;
+			base[run].next = nil;
+			size_t i = 0;
+			for (; runs[i] != nil; i++)
+			{
+				run = _merge_runs(base, runs[i], run, comp);
+				runs[i] = nil;
+			}
+			runs[i] = run;
+		}
+		index_type sorted = nil;
+		for (size_t i = 0; i < 64; i++)
+			if (runs[i] != nil)
+				sorted = sorted != nil ? _merge_runs(base, runs[i], sorted, comp) : runs[i];
+		base[0].next = sorted;
+		while (base[sorted].next != nil)
+			sorted = base[sorted].next;
+		last = sorted;
+	}
+
+	template<typename T, class Allocator>
+	template<typename Function>
+	inline Function CompactForwardList<T, Allocator>::for_each(Function f)
+	{
+		node_type* base = nodes.data();
+		for (index_type curr = base[0].next; curr != nil; curr = base[curr].next)
+			f(base[curr].value());
+		return f;
+	}
+
+	template<typename T, class Allocator>
+	template<typename Function>
+	inline Function CompactForwardList<T, Allocator>::for_each(Function f) const
+	{
+		const node_type* base = nodes.data();
+		for (index_type curr = base[0].next; curr != nil; curr = base[curr].next)
+			f(base[curr].value());
+		return f;
+	}
+
+	template<typename T, class Allocator>
+	template<typename U>
+	inline U CompactForwardList<T, Allocator>::accumulate(U init) const
+	{
+		return accumulate(std::move(init), [](U&& sum, const T& elem) { return std::move(sum) + elem; });
+	}
+
+	template<typename T, class Allocator>
+	template<typename U, typename BinaryOperation>
+	inline U CompactForwardList<T, Allocator>::accumulate(U init, BinaryOperation op) const
+	{
+		const node_type* base = nodes.data();
+		for (index_type curr = base[0].next; curr != nil; curr = base[curr].next)
+			init = op(std::move(init), base[curr].value());
+		return init;
+	}
+
+	template<typename T, class Allocator>
+	template<typename ...Args>
+	inline typename CompactForwardList<T, Allocator>::index_type CompactForwardList<T, Allocator>::_link_after(index_type pos, Args && ...args)
+	{
+		index_type index = free_head;
+		if (index != nil)
+		{
+			::new (static_cast<void*>(&nodes[index].storage)) T(std::forward<Args>(args) ...);
+			free_head = nodes[index].next;
+		}
+		else
+		{
+			if (nodes.size() >= size_type(nil))
+				throw std::length_error{ "CompactForwardList cannot hold that many elements!" };
+			//args may refer to an element, construct before growing the arena moves it
+			T value(std::forward<Args>(args) ...);
+			index = index_type(nodes.size());
+			nodes.emplace_back();
+			::new (static_cast<void*>(&nodes[index].storage)) T(std::move(value));
+		}
+		nodes[index].next = nodes[pos].next;
+		nodes[pos].next = index;
+		if (pos == last)
+			last = index;
+		++element_count;
+		return index;
+	}
+
+	template<typename T, class Allocator>
+	inline typename CompactForwardList<T, Allocator>::index_type CompactForwardList<T, Allocator>::_unlink_after(index_type pos) noexcept
+	{
+		index_type index = nodes[pos].next;
+		nodes[index].value().~T();
+		nodes[pos].next = nodes[index].next;
+		if (index == last)
+			last = pos;
+		nodes[index].next = free_head;
+		free_head = index;
+		--element_count;
+		return nodes[pos].next;
+	}
+
+	template<typename T, class Allocator>
+	template<typename Compare>
+	inline typename CompactForwardList<T, Allocator>::index_type CompactForwardList<T, Allocator>::_merge_runs(node_type * base, index_type a, index_type b, Compare & comp)
+	{
+		//Stable: a node of b goes first only if it is strictly less
+		index_type first = nil;
+		index_type* link = &first;
+		while (a != nil && b != nil)
+		{
+			if (comp(base[b].value(), base[a].value()))
+			{
+				*link = b;
+				b = base[b].next;
+			}
+			else
+			{
+				*link = a;
+				a = base[a].next;
+			}
+			link = &base[*link].next;
+		}
+		*link = a != nil ? a : b;
+		return first;
+	}
+}
@@ -0,0 +1,537 @@
+#pragma once
+#include <stdexcept>
+#include <iterator>
+#include <atomic>
+#include <functional>
+#include <initializer_list>
+#include <new>
+#include <utility>
+#include <cstdint>
+#include "EpochReclaimer.h"
+#include "SIMD.h"
+
+constexpr int SKIP_LIST_MAX_LEVEL = 32;	//Enough for 2^32 elements with a level probability of 1/2
+
+namespace DataStructures
+{
+	template<typename Key, typename T>
+	struct _SkipListMapTraits
+	{
+		using key_type = Key;
+		using value_type = std::pair<const Key, T>;
+		static const Key& key_of(const value_type& value) noexcept { return value.first; }
+	};
+
+	template<typename Key>
+	struct _SkipListSetTraits
+	{
+		using key_type = Key;
+		using value_type = Key;
+		static const Key& key_of(const value_type& value) noexcept { return value; }
+	};
+
+	template<typename Traits, typename Compare> class ConcurrentSkipList;
+	template<typename Key, typename T, typename Compare = std::less<Key>>
+	using ConcurrentSkipListMap = ConcurrentSkipList<_SkipListMapTraits<Key, T>, Compare>;
+	template<typename Key, typename Compare = std::less<Key>>
+	using ConcurrentSkipListSet = ConcurrentSkipList<_SkipListSetTraits<Key>, Compare>;
+
+	//Ordered map or set that any number of threads may read and modify at once without locks.
+	//Every node carries a tower of links, one per level it takes part in, and each link is a pointer whose low bit
+	//marks the node as being erased. An insert is decided by one CAS on the bottom level and an erase by marking the
+	//bottom link, after which any thread that walks past the node unlinks it. Unlinked nodes go to EpochReclaimer.
+	//Elements are immutable once inserted. Iterators are weakly consistent: they never dangle and see every element
+	//that was there for their whole lifetime, but may or may not see concurrent changes. An iterator keeps an
+	//EpochReclaimer::Guard open, so it belongs to the thread that made it and should not be kept for long.
+	//Only the destructor and clear() must not run concurrently with anything else.
+	template<typename Traits, typename Compare>
+	class ConcurrentSkipList
+	{
+	private:
+		struct Node;
+		class ConcurrentSkipListIterator;
+
+	public:
+		using key_type = typename Traits::key_type;
+		using value_type = typename Traits::value_type;
+		using key_compare = Compare;
+		using size_type = size_t;
+		using difference_type = ptrdiff_t;
+		using reference = const value_type&;
+		using const_reference = const value_type&;
+		using pointer = const value_type*;
+		using const_pointer = const value_type*;
+		using iterator = ConcurrentSkipListIterator;
+		using const_iterator = ConcurrentSkipListIterator;
+
+		//Constructor, Destructor and Assignment
+		ConcurrentSkipList() : ConcurrentSkipList(Compare()) {}
+		explicit ConcurrentSkipList(const Compare& _comp);
+		ConcurrentSkipList(std::initializer_list<value_type> init, const Compare& _comp = Compare());
+		ConcurrentSkipList(const ConcurrentSkipList&) = delete;
+		ConcurrentSkipList& operator=(const ConcurrentSkipList&) = delete;
+		~ConcurrentSkipList();
+
+		//Iterators
+		iterator begin() const;
+		iterator end() const noexcept;
+		const_iterator cbegin() const;
+		const_iterator cend() const noexcept;
+
+		//Capacity
+		bool empty() const noexcept;
+		size_type size() const noexcept;					//Exact only while nobody modifies the list
+
+		//Lookup
+		bool contains(const key_type& key) const;
+		iterator find(const key_type& key) const;
+		iterator lower_bound(const key_type& key) const;	//First element not less than key
+		iterator upper_bound(const key_type& key) const;	//First element greater than key
+		key_compare key_comp() const;
+
+		//Modifiers
+		bool insert(const value_type& val);					//false if the key is already there
+		bool insert(value_type&& val);
+		template<typename... Args>
+		bool emplace(Args&&... args);
+		bool erase(const key_type& key);					//false if the key is not there
+		void clear() noexcept;								//Not concurrently with anything else
+
+	private:
+		enum NodeState : int { _linked = 1, _removed = 2 };	//The thread that sets the second one retires the node
+
+		struct Node
+		{
+			value_type value;
+			int height;
+			std::atomic<int> state;
+			std::atomic<uintptr_t> next[1];					//height links, allocated past the end
+
+			template<typename... Args>
+			Node(int _height, Args&&... args) : value(std::forward<Args>(args)...), height(_height), state(0) {}
+			std::atomic<uintptr_t>* links() noexcept { return next; }
+		};
+
+		mutable std::atomic<uintptr_t> head[SKIP_LIST_MAX_LEVEL];
+		std::atomic<int> top_height;							//No node is taller, searches start there
+		std::atomic<size_type> element_count;
+		Compare comp;
+
+		inline static Node* _pointer(uintptr_t link) noexcept;
+		inline static bool _marked(uintptr_t link) noexcept;
+		inline static int _random_height() noexcept;
+		template<typename... Args>
+		inline static Node* _create_node(int height, Args&&... args);
+		inline static void _destroy_node(void* p) noexcept;
+
+		//Fills preds and succs with the links around key on every level, unlinking marked nodes on the way.
+		//With past_equal it stops after the nodes equal to key instead of before them. Returns whether succs[0] equals key.
+		bool _find(const key_type& key, std::atomic<uintptr_t>** preds, Node** succs, bool past_equal = false) const;
+		bool _search(const key_type& key, std::atomic<uintptr_t>** preds, Node** succs, bool past_equal) const;	//false if a CAS lost and it has to start over
+		bool _insert_node(Node* node);						//Takes ownership of node
+		void _finish(Node* node, NodeState state);
+
+	private:
+		class ConcurrentSkipListIterator
+		{
+			friend class ConcurrentSkipList;
+		public:
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = typename ConcurrentSkipList::value_type;
+			using difference_type = ptrdiff_t;
+			using pointer = const value_type*;
+			using reference = const value_type&;
+
+			ConcurrentSkipListIterator() noexcept : node(nullptr), guard(nullptr) {}
+
+			reference operator*() const { return node->value; }
+			pointer operator->() const { return &node->value; }
+			ConcurrentSkipListIterator& operator++();
+			ConcurrentSkipListIterator operator++(int);
+			bool operator==(const ConcurrentSkipListIterator& rhs) const noexcept { return node == rhs.node; }
+			bool operator!=(const ConcurrentSkipListIterator& rhs) const noexcept { return node != rhs.node; }
+
+		private:
+			Node* node;
+			EpochReclaimer::Guard guard;					//Active while node is not null
+
+			explicit ConcurrentSkipListIterator(Node* _node);
+			void _skip_marked() noexcept;
+		};
+	};
+}
+
+
+namespace DataStructures
+{
+	/* Dividing Line ( 㧥 ;) ( 㧥 ;) ( 㧥 ;)  */
+
+	template<typename Traits, typename Compare>
+	inline ConcurrentSkipList<Traits, Compare>::ConcurrentSkipList(const Compare& _comp) : top_height(1), element_count(0), comp(_comp)
+	{
+		for (int i = 0; i < SKIP_LIST_MAX_LEVEL; i++)
+			head[i].store(0, std::memory_order_relaxed);
+	}
+
+	template<typename Traits, typename Compare>
+	inline ConcurrentSkipList<Traits, Compare>::ConcurrentSkipList(std::initializer_list<value_type> init, const Compare& _comp) : ConcurrentSkipList(_comp)
+	{
+		for (const value_type& val : init)
+			insert(val);
+	}
+
+	template<typename Traits, typename Compare>
+	inline ConcurrentSkipList<Traits, Compare>::~ConcurrentSkipList()
+	{
+		clear();
+	}
+
+	template<typename Traits, typename Compare>
+	inline typename ConcurrentSkipList<Traits, Compare>::iterator ConcurrentSkipList<Traits, Compare>::begin() const
+	{
+		EpochReclaimer::Guard guard;
+		iterator it(_pointer(head[0].load(std::memory_order_acquire)));
+		it._skip_marked();
+		if (!it.node)
+			it.guard.reset();
+		return it;
+	}
+
+	template<typename Traits, typename Compare>
+	inline typename ConcurrentSkipList<Traits, Compare>::iterator ConcurrentSkipList<Traits, Compare>::end() const noexcept
+	{
+		return iterator();
+	}
+
+	template<typename Traits, typename Compare>
+	inline typename ConcurrentSkipList<Traits, Compare>::const_iterator ConcurrentSkipList<Traits, Compare>::cbegin() const
+	{
+		return begin();
+	}
+
+	template<typename Traits, typename Compare>
+	inline typename ConcurrentSkipList<Traits, Compare>::const_iterator ConcurrentSkipList<Traits, Compare>::cend() const noexcept
+	{
+		return end();
+	}
+
+	template<typename Traits, typename Compare>
+	inline bool ConcurrentSkipList<Traits, Compare>::empty() const noexcept
+	{
+		return element_count.load(std::memory_order_relaxed) == 0;
+	}
+
+	template<typename Traits, typename Compare>
+	inline typename ConcurrentSkipList<Traits, Compare>::size_type ConcurrentSkipList<Traits, Compare>::size() const noexcept
+	{
+		return element_count.load(std::memory_order_relaxed);
+	}
+
+	template<typename Traits, typename Compare>
+	inline bool ConcurrentSkipList<Traits, Compare>::contains(const key_type& key) const
+	{
+		EpochReclaimer::Guard guard;
+		std::atomic<uintptr_t>* preds[SKIP_LIST_MAX_LEVEL];
+		Node* succs[SKIP_LIST_MAX_LEVEL];
+		return _find(key, preds, succs);
+	}
+
+	template<typename Traits, typename Compare>
+	inline typename ConcurrentSkipList<Traits, Compare>::iterator ConcurrentSkipList<Traits, Compare>::find(const key_type& key) const
+	{
+		EpochReclaimer::Guard guard;
+		std::atomic<uintptr_t>* preds[SKIP_LIST_MAX_LEVEL];
+		Node* succs[SKIP_LIST_MAX_LEVEL];
+		return _find(key, preds, succs) ? iterator(succs[0]) : iterator();
+	}
+
+	template<typename Traits, typename Compare>
+	inline typename ConcurrentSkipList<Traits, Compare>::iterator ConcurrentSkipList<Traits, Compare>::lower_bound(const key_type& key) const
+	{
+		EpochReclaimer::Guard guard;
+		std::atomic<uintptr_t>* preds[SKIP_LIST_MAX_LEVEL];
+		Node* succs[SKIP_LIST_MAX_LEVEL];
+		_find(key, preds, succs);
+		return iterator(succs[0]);
+	}
+
+	template<typename Traits, typename Compare>
+	inline typename ConcurrentSkipList<Traits, Compare>::iterator ConcurrentSkipList<Traits, Compare>::upper_bound(const key_type& key) const
+	{
+		EpochReclaimer::Guard guard;
+		std::atomic<uintptr_t>* preds[SKIP_LIST_MAX_LEVEL];
+		Node* succs[SKIP_LIST_MAX_LEVEL];
+		_find(key, preds, succs, true);
+		return iterator(succs[0]);
+	}
+
+	template<typename Traits, typename Compare>
+	inline typename ConcurrentSkipList<Traits, Compare>::key_compare ConcurrentSkipList<Traits, Compare>::key_comp() const
+	{
+		return comp;
+	}
+
+	template<typename Traits, typename Compare>
+	inline bool ConcurrentSkipList<Traits, Compare>::insert(const value_type& val)
+	{
+		return _insert_node(_create_node(_random_height(), val));
+	}
+
+	template<typename Traits, typename Compare>
+	inline bool ConcurrentSkipList<Traits, Compare>::insert(value_type&& val)
+	{
+		return _insert_node(_create_node(_random_height(), std::move(val)));
+	}
+
+	template<typename Traits, typename Compare>
+	template<typename... Args>
+	inline bool ConcurrentSkipList<Traits, Compare>::emplace(Args&&... args)
+	{
+		return _insert_node(_create_node(_random_height(), std::forward<Args>(args)...));
+	}
+
+	template<typename Traits, typename Compare>
+	inline bool ConcurrentSkipList<Traits, Compare>::erase(const key_type& key)
+	{
+		EpochReclaimer::Guard guard;
+		std::atomic<uintptr_t>* preds[SKIP_LIST_MAX_LEVEL];
+		Node* succs[SKIP_LIST_MAX_LEVEL];
+		if (!_find(key, preds, succs))
+			return false;
+		Node* node = succs[0];
+
+		//Mark the upper levels first so no new link to node can be made above the bottom
+		for (int level = node->height - 1; level > 0; level--)
+		{
+			uintptr_t next = node->links()[level].load(std::memory_order_acquire);
+			while (!_marked(next) && !node->links()[level].compare_exchange_weak(next, next | 1, std::memory_order_acq_rel, std::memory_order_acquire))
+				;
+		}
+		//Whoever marks the bottom level erased the element
+		uintptr_t next = node->links()[0].load(std::memory_order_acquire);
+		while (true)
+		{
+			if (_marked(next))
+				return false;
+			if (node->links()[0].compare_exchange_weak(next, next | 1, std::memory_order_acq_rel, std::memory_order_acquire))
+				break;
+		}
+		element_count.fetch_sub(1, std::memory_order_relaxed);
+		_find(Traits::key_of(node->value), preds, succs, true);	//Unlinks node on every level
+		_finish(node, _removed);
+		return true;
+	}
+
+	template<typename Traits, typename Compare>
+	inline void ConcurrentSkipList<Traits, Compare>::clear() noexcept
+	{
+		Node* curr = _pointer(head[0].load(std::memory_order_acquire));
+		while (curr)
+		{
+			Node* next = _pointer(curr->links()[0].load(std::memory_order_relaxed));
+			_destroy_node(curr);
+			curr = next;
+		}
+		for (int i = 0; i < SKIP_LIST_MAX_LEVEL; i++)
+			head[i].store(0, std::memory_order_relaxed);
+		top_height.store(1, std::memory_order_relaxed);
+		element_count.store(0, std::memory_order_relaxed);
+	}
+
+	template<typename Traits, typename Compare>
+	inline typename ConcurrentSkipList<Traits, Compare>::Node* ConcurrentSkipList<Traits, Compare>::_pointer(uintptr_t link) noexcept
+	{
+		return reinterpret_cast<Node*>(link & ~uintptr_t(1));
+	}
+
+	template<typename Traits, typename Compare>
+	inline bool ConcurrentSkipList<Traits, Compare>::_marked(uintptr_t link) noexcept
+	{
+		return (link & 1) != 0;
+	}
+
+	template<typename Traits, typename Compare>
+	inline int ConcurrentSkipList<Traits, Compare>::_random_height() noexcept
+	{
+		//xorshift32 per thread, each further level taken with probability 1/2
+		static thread_local uint32_t seed = 0;
+		if (seed == 0)
+			seed = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(&seed) >> 4) | 1;
+		seed ^= seed << 13;
+		seed ^= seed >> 17;
+		seed ^= seed << 5;
+		return static_cast<int>(_count_trailing_zeros(seed | (1U << (SKIP_LIST_MAX_LEVEL - 1)))) + 1;
+	}
+
+	template<typename Traits, typename Compare>
+	template<typename... Args>
+	inline typename ConcurrentSkipList<Traits, Compare>::Node* ConcurrentSkipList<Traits, Compare>::_create_node(int height, Args&&... args)
+	{
+		void* p = ::operator new(sizeof(Node) + (height - 1) * sizeof(std::atomic<uintptr_t>));
+		Node* node;
+		try
+		{
+			node = ::new (p) Node(height, std::forward<Args>(args)...);
+		}
+		catch (...)
+		{
+			::operator delete(p);
+			throw;
+		}
+		for (int i = 0; i < height; i++)
+			::new (node->links() + i) std::atomic<uintptr_t>(0);
+		return node;
+	}
+
+	template<typename Traits, typename Compare>
+	inline void ConcurrentSkipList<Traits, Compare>::_destroy_node(void* p) noexcept
+	{
+		Node* node = static_cast<Node*>(p);
+		node->~Node();
+		::operator delete(p);
+	}
+
+	template<typename Traits, typename Compare>
+	bool ConcurrentSkipList<Traits, Compare>::_find(const key_type& key, std::atomic<uintptr_t>** preds, Node** succs, bool past_equal) const
+	{
+		while (!_search(key, preds, succs, past_equal))
+			;
+		return succs[0] && !past_equal && !comp(key, Traits::key_of(succs[0]->value));
+	}
+
+	template<typename Traits, typename Compare>
+	bool ConcurrentSkipList<Traits, Compare>::_search(const key_type& key, std::atomic<uintptr_t>** preds, Node** succs, bool past_equal) const
+	{
+		std::atomic<uintptr_t>* pred = head;
+		int top = top_height.load(std::memory_order_acquire);
+		for (int level = SKIP_LIST_MAX_LEVEL - 1; level >= top; level--)
+		{
+			preds[level] = head;
+			succs[level] = _pointer(head[level].load(std::memory_order_acquire));
+		}
+		for (int level = top - 1; level >= 0; level--)
+		{
+			Node* curr = _pointer(pred[level].load(std::memory_order_acquire));
+			while (curr)
+			{
+				uintptr_t succ = curr->links()[level].load(std::memory_order_acquire);
+				if (_marked(succ))
+				{
+					//curr is being erased, take it out of this level before going on
+					uintptr_t expected = reinterpret_cast<uintptr_t>(curr);
+					if (!pred[level].compare_exchange_strong(expected, succ & ~uintptr_t(1), std::memory_order_acq_rel, std::memory_order_acquire))
+						return false;
+					curr = _pointer(succ);
+					continue;
+				}
+				if (past_equal ? comp(key, Traits::key_of(curr->value)) : !comp(Traits::key_of(curr->value), key))
+					break;
+				pred = curr->links();
+				curr = _pointer(succ);
+			}
+			preds[level] = pred;
+			succs[level] = curr;
+		}
+		return true;
+	}
+
+	template<typename Traits, typename Compare>
+	bool ConcurrentSkipList<Traits, Compare>::_insert_node(Node* node)
+	{
+		EpochReclaimer::Guard guard;
+		std::atomic<uintptr_t>* preds[SKIP_LIST_MAX_LEVEL];
+		Node* succs[SKIP_LIST_MAX_LEVEL];
+		const key_type& key = Traits::key_of(node->value);
+		const int height = node->height;
+		int top = top_height.load(std::memory_order_relaxed);
+		while (top < height && !top_height.compare_exchange_weak(top, height, std::memory_order_acq_rel, std::memory_order_relaxed))
+			;
+
+		//The CAS on the bottom level decides the insert
+		while (true)
+		{
+			if (_find(key, preds, succs))
+			{
+				_destroy_node(node);
+				return false;
+			}
+			for (int level = 0; level < height; level++)
+				node->links()[level].store(reinterpret_cast<uintptr_t>(succs[level]), std::memory_order_relaxed);
+			uintptr_t expected = reinterpret_cast<uintptr_t>(succs[0]);
+			if (preds[0][0].compare_exchange_strong(expected, reinterpret_cast<uintptr_t>(node), std::memory_order_acq_rel, std::memory_order_acquire))
+				break;
+		}
+		element_count.fetch_add(1, std::memory_order_relaxed);
+
+		//The upper levels only speed up searches, stop linking them once node is being erased
+		bool linking = true;
+		for (int level = 1; linking && level < height; level++)
+		{
+			while (true)
+			{
+				uintptr_t next = node->links()[level].load(std::memory_order_acquire);
+				if (_marked(next))
+				{
+					linking = false;
+					break;
+				}
+				if (_pointer(next) != succs[level] &&
+					!node->links()[level].compare_exchange_strong(next, reinterpret_cast<uintptr_t>(succs[level]), std::memory_order_acq_rel, std::memory_order_acquire))
+					continue;
+				uintptr_t expected = reinterpret_cast<uintptr_t>(succs[level]);
+				if (preds[level][level].compare_exchange_strong(expected, reinterpret_cast<uintptr_t>(node), std::memory_order_acq_rel, std::memory_order_acquire))
+					break;
+				_find(key, preds, succs);
+				if (succs[0] != node)
+				{
+					linking = false;
+					break;
+				}
+			}
+		}
+		//An erase may have finished unlinking before one of the links above was made, take node out again
+		if (_marked(node->links()[0].load(std::memory_order_acquire)))
+			_find(key, preds, succs, true);
+		_finish(node, _linked);
+		return true;
+	}
+
+	template<typename Traits, typename Compare>
+	inline void ConcurrentSkipList<Traits, Compare>::_finish(Node* node, NodeState state)
+	{
+		int other = state == _linked ? _removed : _linked;
+		if (node->state.fetch_or(state, std::memory_order_acq_rel) & other)
+			EpochReclaimer::retire(node, &_destroy_node);
+	}
+
+	template<typename Traits, typename Compare>
+	inline ConcurrentSkipList<Traits, Compare>::ConcurrentSkipListIterator::ConcurrentSkipListIterator(Node* _node) :
+		node(_node), guard(_node ? EpochReclaimer::Guard() : EpochReclaimer::Guard(nullptr))
+	{
+	}
+
+	template<typename Traits, typename Compare>
+	inline typename ConcurrentSkipList<Traits, Compare>::ConcurrentSkipListIterator& ConcurrentSkipList<Traits, Compare>::ConcurrentSkipListIterator::operator++()
+	{
+		node = _pointer(node->links()[0].load(std::memory_order_acquire));
+		_skip_marked();
+		if (!node)
+			guard.reset();
+		return *this;
+	}
+
+	template<typename Traits, typename Compare>
+	inline typename ConcurrentSkipList<Traits, Compare>::ConcurrentSkipListIterator ConcurrentSkipList<Traits, Compare>::ConcurrentSkipListIterator::operator++(int)
+	{
+		ConcurrentSkipListIterator temp(*this);
+		++*this;
+		return temp;
+	}
+
+	template<typename Traits, typename Compare>
+	inline void ConcurrentSkipList<Traits, Compare>::ConcurrentSkipListIterator::_skip_marked() noexcept
+	{
+		while (node && _marked(node->links()[0].load(std::memory_order_acquire)))
+			node = _pointer(node->links()[0].load(std::memory_order_acquire));
+	}
+}
@@ -0,0 +1,200 @@
+#pragma once
+#include <cstring>
+#include "BasicString.h"
+#include "BasicStringView.h"
+#include "Vector.h"
+
+namespace DataStructures
+{
+	class LevenshteinMatcher;
+
+	struct EditMatch
+	{
+		size_t index;				//Position of the candidate in the range searched
+		size_t distance;
+	};
+
+	//Levenshtein distance with the bit-parallel algorithm of G. Myers, "A Fast Bit-Vector Algorithm for Approximate String
+	//Matching Based on Dynamic Programming", in the form of H. Hyyro for the distance between whole strings. A column of
+	//the DP table is kept as bit vectors of +1 and -1 steps, so each character of the text costs a handful of word operations
+	//for every 64 characters of the pattern. A pattern of up to 64 characters takes one word, longer ones are split into
+	//blocks of 64 rows that pass their carries down. The shorter string is the pattern.
+	//With max_distance, a pair is given up as soon as the remaining characters can no longer bring it within the bound,
+	//and any result above the bound is returned as max_distance + 1. Characters are compared as bytes, not code points.
+	size_t levenshtein_distance(StringView a, StringView b);
+	size_t levenshtein_distance(StringView a, StringView b, size_t max_distance);
+
+	//One query against many candidates: the query's bit masks are built once
+	class LevenshteinMatcher
+	{
+	public:
+		explicit LevenshteinMatcher(StringView query);
+
+		size_t size() const noexcept;				//Length of the query
+		size_t distance(StringView candidate) const;
+		size_t distance(StringView candidate, size_t max_distance) const;
+
+		//Candidates within max_distance of the query, in order. InputIterator yields anything convertible to StringView.
+		template<typename InputIterator>
+		Vector<EditMatch> matches(InputIterator first, InputIterator last, size_t max_distance) const;
+
+	private:
+		Vector<unsigned long long> masks;			//Bit i of masks[c * blocks + b] set if query[64 * b + i] is c
+		size_t query_length;
+		size_t blocks;
+
+		inline size_t _distance(StringView candidate, size_t max_distance, unsigned long long* state) const;
+	};
+
+	/* Dividing Line ( 㧥 ;) ( 㧥 ;) ( 㧥 ;)  */
+
+	//Distance between the pattern described by masks and text, or max_distance + 1 if it is larger
+	inline size_t _myers_distance(const unsigned long long* masks, size_t m, const unsigned char* text, size_t n, size_t max_distance) noexcept
+	{
+		unsigned long long vp = m == 64 ? ~0ULL : (1ULL << m) - 1, vn = 0;
+		const unsigned long long last_row = 1ULL << (m - 1);
+		size_t score = m;
+		for (size_t j = 0; j < n; j++)
+		{
+			unsigned long long eq = masks[text[j]];
+			unsigned long long x = eq | vn;
+			unsigned long long d0 = (((x & vp) + vp) ^ vp) | x;
+			unsigned long long hp = vn | ~(d0 | vp);
+			unsigned long long hn = vp & d0;
+			score += (hp & last_row) != 0;
+			score -= (hn & last_row) != 0;
+			if (score > max_distance + (n - j - 1)) return max_distance + 1;	//Each remaining column lowers it by one at most
+			hp = hp << 1 | 1;		//The top row grows by one every column
+			hn <<= 1;
+			vp = hn | ~(d0 | hp);
+			vn = hp & d0;
+		}
+		return score;
+	}
+
+	//The same over blocks of 64 rows, masks holds blocks words per character and state 2 * blocks words.
+	//A block's bottom row step enters the next block as hin, -1, 0 or +1.
+	inline size_t _myers_distance_blocks(const unsigned long long* masks, size_t m, size_t blocks, const unsigned char* text, size_t n,
+		size_t max_distance, unsigned long long* state) noexcept
+	{
+		unsigned long long* vp = state;
+		unsigned long long* vn = state + blocks;
+		for (size_t b = 0; b < blocks; b++)
+		{
+			vp[b] = ~0ULL;
+			vn[b] = 0;
+		}
+		const unsigned long long last_row = 1ULL << ((m - 1) % 64);
+		const unsigned long long high_row = 1ULL << 63;
+		size_t score = m;
+		for (size_t j = 0; j < n; j++)
+		{
+			const unsigned long long* column = masks + size_t(text[j]) * blocks;
+			int hin = 1;
+			for (size_t b = 0; b < blocks; b++)
+			{
+				unsigned long long eq = column[b];
+				unsigned long long negative_in = hin < 0;
+				unsigned long long xv = eq | vn[b];
+				eq |= negative_in;
+				unsigned long long xh = (((eq & vp[b]) + vp[b]) ^ vp[b]) | eq;
+				unsigned long long hp = vn[b] | ~(xh | vp[b]);
+				unsigned long long hn = vp[b] & xh;
+				unsigned long long bottom = b + 1 == blocks ? last_row : high_row;
+				int hout = int((hp & bottom) != 0) - int((hn & bottom) != 0);
+				hp = hp << 1 | (hin > 0);
+				hn = hn << 1 | negative_in;
+				vp[b] = hn | ~(xv | hp);
+				vn[b] = hp & xv;
+				hin = hout;
+			}
+			score += hin;
+			if (score > max_distance + (n - j - 1)) return max_distance + 1;
+		}
+		return score;
+	}
+
+	inline size_t levenshtein_distance(StringView a, StringView b)
+	{
+		return levenshtein_distance(a, b, a.size() + b.size());
+	}
+
+	inline size_t levenshtein_distance(StringView a, StringView b, size_t max_distance)
+	{
+		if (a.size() > b.size())
+		{
+			StringView longer = a;
+			a = b;
+			b = longer;
+		}
+		if (b.size() - a.size() > max_distance) return max_distance + 1;
+		if (a.empty()) return b.size();
+		if (max_distance > b.size()) max_distance = b.size();	//The distance never exceeds the longer length
+		const unsigned char* pattern = reinterpret_cast<const unsigned char*>(a.data());
+		const unsigned char* text = reinterpret_cast<const unsigned char*>(b.data());
+		if (a.size() <= 64)
+		{
+			unsigned long long masks[256] = {};
+			for (size_t i = 0; i < a.size(); i++)
+				masks[pattern[i]] |= 1ULL << i;
+			return _myers_distance(masks, a.size(), text, b.size(), max_distance);
+		}
+		LevenshteinMatcher matcher(a);
+		return matcher.distance(b, max_distance);
+	}
+
+	inline LevenshteinMatcher::LevenshteinMatcher(StringView query) : query_length(query.size()), blocks((query.size() + 63) / 64)
+	{
+		masks.resize(256 * blocks, 0);
+		const unsigned char* pattern = reinterpret_cast<const unsigned char*>(query.data());
+		for (size_t i = 0; i < query_length; i++)
+			masks[size_t(pattern[i]) * blocks + i / 64] |= 1ULL << (i % 64);
+	}
+
+	inline size_t LevenshteinMatcher::size() const noexcept
+	{
+		return query_length;
+	}
+
+	inline size_t LevenshteinMatcher::distance(StringView candidate) const
+	{
+		return distance(candidate, query_length + candidate.size());
+	}
+
+	inline size_t LevenshteinMatcher::distance(StringView candidate, size_t max_distance) const
+	{
+		Vector<unsigned long long> state;
+		if (blocks > 1)
+			state.resize(2 * blocks);
+		return _distance(candidate, max_distance, state.data());
+	}
+
+	template<typename InputIterator>
+	inline Vector<EditMatch> LevenshteinMatcher::matches(InputIterator first, InputIterator last, size_t max_distance) const
+	{
+		Vector<EditMatch> found;
+		Vector<unsigned long long> state;
+		if (blocks > 1)
+			state.resize(2 * blocks);
+		for (size_t index = 0; first != last; ++first, ++index)
+		{
+			size_t d = _distance(StringView(*first), max_distance, state.data());
+			if (d <= max_distance)
+				found.push_back(EditMatch{ index, d });
+		}
+		return found;
+	}
+
+	inline size_t LevenshteinMatcher::_distance(StringView candidate, size_t max_distance, unsigned long long * state) const
+	{
+		size_t difference = candidate.size() > query_length ? candidate.size() - query_length : query_length - candidate.size();
+		if (difference > max_distance) return max_distance + 1;
+		if (query_length == 0) return candidate.size();
+		size_t longer = candidate.size() > query_length ? candidate.size() : query_length;
+		if (max_distance > longer) max_distance = longer;
+		const unsigned char* text = reinterpret_cast<const unsigned char*>(candidate.data());
+		if (blocks == 1)
+			return _myers_distance(masks.data(), query_length, text, candidate.size(), max_distance);
+		return _myers_distance_blocks(masks.data(), query_length, blocks, text, candidate.size(), max_distance, state);
+	}
+}
@@ -0,0 +1,239 @@
+#pragma once
+#include <stdexcept>
+#include <atomic>
+#include <cstddef>
+#include "Vector.h"
+
+constexpr size_t EPOCH_MAX_THREADS = 256;		//Threads that may be inside a Guard at the same time
+constexpr size_t EPOCH_RECLAIM_BATCH = 64;		//Retired objects a thread collects before it tries to free some
+
+namespace DataStructures
+{
+	//Epoch-based reclamation for lock-free containers, which cannot free a node the moment it is unlinked because
+	//other threads may still be reading it. Every access to shared nodes happens inside a Guard, which publishes the
+	//global epoch the thread saw on entry. An unlinked node is retired with the epoch of its removal and only freed
+	//once the global epoch has moved two steps further, which cannot happen while any Guard entered before the
+	//removal is still alive. A Guard is cheap to nest, but a thread that stays inside one holds back every free.
+	class EpochReclaimer
+	{
+	private:
+		struct ThreadRecord;
+
+	public:
+		using deleter_type = void(*)(void*);
+
+		class Guard
+		{
+		public:
+			Guard();
+			explicit Guard(std::nullptr_t) noexcept;			//Not entered, e.g. for an end iterator
+			Guard(const Guard& origin);						//Entered if origin is
+			Guard& operator=(const Guard& origin);
+			~Guard();
+
+			bool active() const noexcept;
+			void reset() noexcept;								//Leave before destruction
+
+		private:
+			ThreadRecord* record;
+		};
+
+		//Hands p to deleter once no thread can reach it any more. Must be called inside a Guard,
+		//after p has been unlinked from everything a new reader could start from.
+		static void retire(void* p, deleter_type deleter);
+		static size_t pending();								//Objects the calling thread has retired but not yet freed
+
+	private:
+		struct Retired
+		{
+			void* p;
+			deleter_type deleter;
+			size_t epoch;
+		};
+
+		struct alignas(64) ThreadRecord
+		{
+			std::atomic<size_t> state{ 0 };		//(epoch << 1) | 1 while inside a Guard, 0 outside
+			std::atomic<bool> in_use{ false };
+			size_t nesting = 0;
+			size_t reclaim_at = EPOCH_RECLAIM_BATCH;	//Twice what survived the last reclaim, so a stalled epoch costs O(1) per retire
+			Vector<Retired> limbo;				//Left behind when the thread exits, the next owner frees it
+		};
+
+		struct ThreadHandle
+		{
+			ThreadRecord* record = nullptr;
+			~ThreadHandle();
+		};
+
+		struct Domain
+		{
+			std::atomic<size_t> epoch{ 1 };
+			std::atomic<size_t> record_count{ 0 };	//Records ever claimed, the rest need not be scanned
+			ThreadRecord records[EPOCH_MAX_THREADS];
+			~Domain();
+		};
+
+		inline static Domain& _domain();
+		inline static ThreadRecord* _record();				//The calling thread's, claimed on first use
+		inline static ThreadRecord* _enter();
+		inline static void _exit(ThreadRecord* record) noexcept;
+		inline static bool _try_advance() noexcept;			//Moves the epoch on if every thread inside a Guard has seen it
+		inline static void _reclaim(ThreadRecord* record);	//Frees what is two epochs old
+	};
+}
+
+
+namespace DataStructures
+{
+	/* Dividing Line ( 㧥 ;) ( 㧥 ;) ( 㧥 ;)  */
+
+	inline EpochReclaimer::Guard::Guard() : record(_enter())
+	{
+	}
+
+	inline EpochReclaimer::Guard::Guard(std::nullptr_t) noexcept : record(nullptr)
+	{
+	}
+
+	inline EpochReclaimer::Guard::Guard(const Guard& origin) : record(origin.record ? _enter() : nullptr)
+	{
+	}
+
+	inline EpochReclaimer::Guard& EpochReclaimer::Guard::operator=(const Guard& origin)
+	{
+		if (origin.record && !record)
+			record = _enter();
+		else if (!origin.record)
+			reset();
+		return *this;
+	}
+
+	inline EpochReclaimer::Guard::~Guard()
+	{
+		reset();
+	}
+
+	inline bool EpochReclaimer::Guard::active() const noexcept
+	{
+		return record != nullptr;
+	}
+
+	inline void EpochReclaimer::Guard::reset() noexcept
+	{
+		if (record)
+			_exit(record);
+		record = nullptr;
+	}
+
+	inline void EpochReclaimer::retire(void* p, deleter_type deleter)
+	{
+		ThreadRecord* record = _record();
+		record->limbo.push_back(Retired{ p, deleter, _domain().epoch.load(std::memory_order_acquire) });
+		if (record->limbo.size() >= record->reclaim_at)
+		{
+			_try_advance();
+			_reclaim(record);
+		}
+	}
+
+	inline size_t EpochReclaimer::pending()
+	{
+		return _record()->limbo.size();
+	}
+
+	inline EpochReclaimer::ThreadHandle::~ThreadHandle()
+	{
+		if (record)
+			record->in_use.store(false, std::memory_order_release);
+	}
+
+	inline EpochReclaimer::Domain::~Domain()
+	{
+		for (ThreadRecord& record : records)
+			for (size_t i = 0; i < record.limbo.size(); i++)
+				record.limbo[i].deleter(record.limbo[i].p);
+	}
+
+	inline EpochReclaimer::Domain& EpochReclaimer::_domain()
+	{
+		static Domain domain;
+		return domain;
+	}
+
+	inline EpochReclaimer::ThreadRecord* EpochReclaimer::_record()
+	{
+		static thread_local ThreadHandle handle;
+		if (handle.record)
+			return handle.record;
+
+		Domain& domain = _domain();
+		for (size_t i = 0; i < EPOCH_MAX_THREADS; i++)
+		{
+			ThreadRecord& record = domain.records[i];
+			bool expected = false;
+			if (!record.in_use.load(std::memory_order_relaxed) &&
+				record.in_use.compare_exchange_strong(expected, true, std::memory_order_acquire))
+			{
+				size_t count = domain.record_count.load(std::memory_order_relaxed);
+				while (count <= i && !domain.record_count.compare_exchange_weak(count, i + 1, std::memory_order_acq_rel, std::memory_order_relaxed))
+					;
+				handle.record = &record;
+				return handle.record;
+			}
+		}
+		throw std::runtime_error{ "Too many threads use EpochReclaimer!" };
+	}
+
+	inline EpochReclaimer::ThreadRecord* EpochReclaimer::_enter()
+	{
+		ThreadRecord* record = _record();
+		if (record->nesting++ == 0)
+		{
+			//A stale epoch only holds the next advance back, so reading it before publishing is fine
+			record->state.store((_domain().epoch.load(std::memory_order_relaxed) << 1) | 1, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+		}
+		return record;
+	}
+
+	inline void EpochReclaimer::_exit(ThreadRecord* record) noexcept
+	{
+		if (--record->nesting == 0)
+			record->state.store(0, std::memory_order_release);
+	}
+
+	inline bool EpochReclaimer::_try_advance() noexcept
+	{
+		Domain& domain = _domain();
+		size_t epoch = domain.epoch.load(std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		size_t count = domain.record_count.load(std::memory_order_acquire);
+		for (size_t i = 0; i < count; i++)
+		{
+			ThreadRecord& record = domain.records[i];
+			if (!record.in_use.load(std::memory_order_acquire))	//Orders the reads of a thread that left before the frees
+				continue;
+			size_t state = record.state.load(std::memory_order_acquire);
+			if ((state & 1) && (state >> 1) != epoch)
+				return false;
+		}
+		return domain.epoch.compare_exchange_strong(epoch, epoch + 1, std::memory_order_acq_rel);
+	}
+
+	inline void EpochReclaimer::_reclaim(ThreadRecord* record)
+	{
+		size_t epoch = _domain().epoch.load(std::memory_order_acquire);
+		size_t kept = 0;
+		for (size_t i = 0; i < record->limbo.size(); i++)
+		{
+			if (record->limbo[i].epoch + 2 <= epoch)
+				record->limbo[i].deleter(record->limbo[i].p);
+			else
+				record->limbo[kept++] = record->limbo[i];
+		}
+		while (record->limbo.size() > kept)
+			record->limbo.pop_back();
+		record->reclaim_at = kept * 2 > EPOCH_RECLAIM_BATCH ? kept * 2 : EPOCH_RECLAIM_BATCH;
+	}
+}
@@ -0,0 +1,441 @@
+#pragma once
+#include <stdexcept>
+#include <cstdio>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+#include "BasicString.h"
+#include "BasicStringView.h"
+#include "NumericConversion.h"
+
+//Wraps a string literal into a type, so format() can parse it at compile time: format(DATASTRUCTURES_FORMAT("{} of {}"), i, n)
+#define DATASTRUCTURES_FORMAT(s) [] { struct _FormatString { static constexpr const char* value() { return s; } }; return _FormatString{}; }()
+
+namespace DataStructures
+{
+	//A subset of std::format for char, with the format string parsed and checked against the arguments at compile time.
+	//A malformed format string, a wrong number of arguments or a specification that does not suit an argument's type
+	//fails to compile. At run time only the literal text and the arguments are written, straight into the output.
+	//Fields are replaced in order: {} or {:[[fill]align][0][width][.precision][type]}, and {{ and }} are literal braces.
+	//	align		'<' left, '>' right, '^' centered. Numbers are right aligned by default, everything else left.
+	//	0			Pads numbers with zeros after the sign.
+	//	width		Minimum number of characters, not code points.
+	//	precision	Digits after the decimal point of a float (at most 100), or most characters taken from a string.
+	//	type		Integers: d x X o b. Floats: f e g. Characters: c. Strings and bools: s.
+	//Integers are printed two digits at a time and floats without type or precision in their shortest round-trip form,
+	//both by to_chars. Floats with a type or precision go through snprintf, so they follow the C locale's decimal point.
+	struct FormatSpec
+	{
+		char fill = ' ';
+		char align = 0;				//0 for the default of the argument's type
+		bool zero_pad = false;
+		unsigned width = 0;
+		int precision = -1;			//-1 if not given
+		char type = 0;				//0 if not given
+	};
+
+	struct FormatToResult
+	{
+		char* ptr;					//One past the last character written
+		size_t size;				//Characters the whole output needs, more than were written if it was truncated
+	};
+
+	template<class FormatString, typename... Args>
+	String format(FormatString fmt, const Args&... args);
+	template<class FormatString, typename Traits, class Allocator, typename... Args>
+	BasicString<char, Traits, Allocator>& format_to(BasicString<char, Traits, Allocator>& out, FormatString fmt, const Args&... args);	//Appends
+	template<class FormatString, typename... Args>
+	FormatToResult format_to(char* first, char* last, FormatString fmt, const Args&... args);	//Truncates, no null character
+	template<class FormatString, typename... Args>
+	size_t formatted_size(FormatString fmt, const Args&... args);
+
+	/* Dividing Line ( 㧥 ;) ( 㧥 ;) ( 㧥 ;)  */
+
+	enum class _FormatCategory { None, Integer, Float, Char, Bool, String };
+
+	struct _FormatField
+	{
+		size_t text_end;			//The literal text before this field ends here
+		FormatSpec spec;
+	};
+
+	template<size_t TextSize, size_t FieldCount>
+	struct _ParsedFormat
+	{
+		char text[TextSize] = {};	//Literal text of the whole format string with the braces unescaped
+		size_t text_length = 0;
+		_FormatField fields[FieldCount] = {};	//One more than the fields, so it is never empty
+		size_t field_count = 0;
+
+		constexpr void on_text(char c) { text[text_length++] = c; }
+		constexpr void on_field(const FormatSpec& spec) { fields[field_count++] = _FormatField{ text_length, spec }; }
+	};
+
+	struct _FormatFieldCounter
+	{
+		size_t field_count = 0;
+
+		constexpr void on_text(char) {}
+		constexpr void on_field(const FormatSpec&) { field_count++; }
+	};
+
+	constexpr size_t _format_length(const char* s)
+	{
+		size_t n = 0;
+		while (s[n]) n++;
+		return n;
+	}
+
+	constexpr bool _is_format_digit(char c)
+	{
+		return c >= '0' && c <= '9';
+	}
+
+	constexpr bool _is_format_align(char c)
+	{
+		return c == '<' || c == '>' || c == '^';
+	}
+
+	//Parses the specification after ':' up to the closing brace, which s[i] is left at
+	constexpr FormatSpec _parse_format_spec(const char* s, size_t& i)
+	{
+		FormatSpec spec;
+		if (s[i] && s[i] != '}' && _is_format_align(s[i + 1]))
+		{
+			if (s[i] == '{')
+				throw std::invalid_argument{ "Format string has '{' as a fill character!" };
+			spec.fill = s[i];
+			spec.align = s[i + 1];
+			i += 2;
+		}
+		else if (_is_format_align(s[i]))
+			spec.align = s[i++];
+		if (s[i] == '0')
+		{
+			spec.zero_pad = true;
+			i++;
+		}
+		for (; _is_format_digit(s[i]); i++)
+		{
+			if (spec.width > 100000)
+				throw std::invalid_argument{ "Format string has a field width too large!" };
+			spec.width = spec.width * 10 + unsigned(s[i] - '0');
+		}
+		if (s[i] == '.')
+		{
+			if (!_is_format_digit(s[++i]))
+				throw std::invalid_argument{ "Format string has a precision without digits!" };
+			spec.precision = 0;
+			for (; _is_format_digit(s[i]); i++)
+			{
+				if (spec.precision > 100000)
+					throw std::invalid_argument{ "Format string has a precision too large!" };
+				spec.precision = spec.precision * 10 + (s[i] - '0');
+			}
+		}
+		if (s[i] && s[i] != '}')
+			spec.type = s[i++];
+		if (s[i] != '}')
+			throw std::invalid_argument{ "Format string has an unterminated or invalid field!" };
+		return spec;
+	}
+
+	//Walks the format string, calling builder.on_text() for each literal character and builder.on_field() for each field.
+	//A builder object rather than lambdas, which cannot be used in constant expressions before C++17.
+	template<class Builder>
+	constexpr void _scan_format(const char* s, Builder& builder)
+	{
+		for (size_t i = 0; s[i]; i++)
+		{
+			if (s[i] == '}')
+			{
+				if (s[i + 1] != '}')
+					throw std::invalid_argument{ "Format string has an unmatched '}'!" };
+				builder.on_text(s[i++]);
+			}
+			else if (s[i] != '{')
+				builder.on_text(s[i]);
+			else if (s[i + 1] == '{')
+				builder.on_text(s[i++]);
+			else
+			{
+				FormatSpec spec;
+				if (s[++i] == ':')
+					spec = _parse_format_spec(s, ++i);
+				else if (!s[i])
+					throw std::invalid_argument{ "Format string has an unterminated or invalid field!" };
+				else if (s[i] != '}')
+					throw std::invalid_argument{ "Format string has a field with an argument index or name!" };
+				builder.on_field(spec);
+			}
+		}
+	}
+
+	constexpr size_t _count_format_fields(const char* s)
+	{
+		_FormatFieldCounter counter;
+		_scan_format(s, counter);
+		return counter.field_count;
+	}
+
+	template<size_t TextSize, size_t FieldCount>
+	constexpr _ParsedFormat<TextSize, FieldCount> _parse_format(const char* s)
+	{
+		_ParsedFormat<TextSize, FieldCount> parsed;
+		_scan_format(s, parsed);
+		return parsed;
+	}
+
+	template<typename T>
+	constexpr _FormatCategory _format_category()
+	{
+		using Type = std::decay_t<T>;
+		return
+			std::is_same<Type, bool>::value							? _FormatCategory::Bool :
+			std::is_same<Type, char>::value							? _FormatCategory::Char :
+			std::is_integral<Type>::value							? _FormatCategory::Integer :
+			std::is_floating_point<Type>::value						? _FormatCategory::Float :
+			std::is_convertible<const Type&, StringView>::value		? _FormatCategory::String :
+			_FormatCategory::None;
+	}
+
+	constexpr bool _all_formattable(const _FormatCategory* categories, size_t n)
+	{
+		for (size_t i = 0; i < n; i++)
+			if (categories[i] == _FormatCategory::None)
+				return false;
+		return true;
+	}
+
+	template<size_t TextSize, size_t FieldCount>
+	constexpr bool _check_format_arguments(const _ParsedFormat<TextSize, FieldCount>& parsed, const _FormatCategory* categories)
+	{
+		for (size_t i = 0; i < parsed.field_count; i++)
+		{
+			const FormatSpec& spec = parsed.fields[i].spec;
+			bool numeric = categories[i] == _FormatCategory::Integer || categories[i] == _FormatCategory::Float;
+			if (spec.zero_pad && !numeric)
+				throw std::invalid_argument{ "Format string pads an argument that is not a number with zeros!" };
+			if (spec.precision >= 0 && categories[i] != _FormatCategory::Float && categories[i] != _FormatCategory::String)
+				throw std::invalid_argument{ "Format string gives a precision to an argument that is not a float or string!" };
+			if (spec.precision > 100 && categories[i] == _FormatCategory::Float)
+				throw std::invalid_argument{ "Format string gives a float a precision above 100!" };
+			char t = spec.type;
+			bool valid = t == 0;
+			switch (categories[i])
+			{
+			case _FormatCategory::Integer: valid = valid || t == 'd' || t == 'x' || t == 'X' || t == 'o' || t == 'b'; break;
+			case _FormatCategory::Float: valid = valid || t == 'f' || t == 'e' || t == 'g'; break;
+			case _FormatCategory::Char: valid = valid || t == 'c'; break;
+			case _FormatCategory::Bool:
+			case _FormatCategory::String: valid = valid || t == 's'; break;
+			default: break;
+			}
+			if (!valid)
+				throw std::invalid_argument{ "Format string has a type that does not suit the argument!" };
+		}
+		return true;
+	}
+
+	template<class FormatString>
+	struct _CompiledFormat
+	{
+		static constexpr size_t text_size = _format_length(FormatString::value()) + 1;
+		static constexpr size_t field_count = _count_format_fields(FormatString::value());
+		static constexpr _ParsedFormat<text_size, field_count + 1> parsed = _parse_format<text_size, field_count + 1>(FormatString::value());
+	};
+
+	template<class FormatString>
+	constexpr _ParsedFormat<_CompiledFormat<FormatString>::text_size, _CompiledFormat<FormatString>::field_count + 1> _CompiledFormat<FormatString>::parsed;
+
+	template<class FormatString, typename... Args>
+	struct _CheckedFormat : _CompiledFormat<FormatString>
+	{
+		static_assert(_CompiledFormat<FormatString>::field_count == sizeof...(Args), "Format string has a different number of fields than arguments!");
+		static constexpr _FormatCategory categories[] = { _format_category<Args>()..., _FormatCategory::None };
+		static_assert(_all_formattable(categories, sizeof...(Args)), "Argument cannot be formatted!");
+		static_assert(_check_format_arguments(_CompiledFormat<FormatString>::parsed, categories), "");
+	};
+
+	template<class FormatString, typename... Args>
+	constexpr _FormatCategory _CheckedFormat<FormatString, Args...>::categories[];
+
+	template<class String>
+	struct _StringFormatSink
+	{
+		String& out;
+
+		void write(const char* s, size_t n) { out.append(s, n); }
+		void fill(char c, size_t n) { out.append(n, c); }
+	};
+
+	struct _BufferFormatSink
+	{
+		char* curr;
+		char* last;
+		size_t size;
+
+		void write(const char* s, size_t n)
+		{
+			size_t room = size_t(last - curr);
+			size_t written = n < room ? n : room;
+			memcpy(curr, s, written);
+			curr += written;
+			size += n;
+		}
+		void fill(char c, size_t n)
+		{
+			size_t room = size_t(last - curr);
+			size_t written = n < room ? n : room;
+			memset(curr, c, written);
+			curr += written;
+			size += n;
+		}
+	};
+
+	struct _CountingFormatSink
+	{
+		size_t size = 0;
+
+		void write(const char*, size_t n) { size += n; }
+		void fill(char, size_t n) { size += n; }
+	};
+
+	//sign is the length of a leading sign that zero padding goes after
+	template<class Sink>
+	inline void _write_padded(Sink& sink, const FormatSpec& spec, const char* s, size_t n, char default_align, size_t sign = 0)
+	{
+		if (spec.width <= n)
+		{
+			sink.write(s, n);
+			return;
+		}
+		size_t padding = spec.width - n;
+		if (spec.zero_pad && !spec.align)
+		{
+			sink.write(s, sign);
+			sink.fill('0', padding);
+			sink.write(s + sign, n - sign);
+			return;
+		}
+		char align = spec.align ? spec.align : default_align;
+		size_t before = align == '>' ? padding : align == '^' ? padding / 2 : 0;
+		sink.fill(spec.fill, before);
+		sink.write(s, n);
+		sink.fill(spec.fill, padding - before);
+	}
+
+	template<class Sink, typename Integer>
+	inline void _format_value(Sink& sink, const FormatSpec& spec, Integer value, std::integral_constant<_FormatCategory, _FormatCategory::Integer>)
+	{
+		using Unsigned = std::make_unsigned_t<Integer>;
+		char buffer[72];
+		char* curr = buffer;
+		Unsigned magnitude = Unsigned(value);
+		bool negative = value < 0;
+		if (negative)
+		{
+			*curr++ = '-';
+			magnitude = Unsigned(0) - magnitude;
+		}
+		if (spec.type == 0 || spec.type == 'd')
+			curr = to_chars(curr, buffer + sizeof(buffer), magnitude).ptr;
+		else
+		{
+			unsigned shift = spec.type == 'b' ? 1 : spec.type == 'o' ? 3 : 4;
+			const char* digits = spec.type == 'X' ? "0123456789ABCDEF" : "0123456789abcdef";
+			unsigned n = 1;
+			while (n * shift < sizeof(Unsigned) * 8 && (magnitude >> (n * shift)) != 0) n++;
+			for (unsigned i = n; i-- > 0; magnitude >>= shift)
+				curr[i] = digits[magnitude & ((1U << shift) - 1)];
+			curr += n;
+		}
+		_write_padded(sink, spec, buffer, size_t(curr - buffer), '>', negative);
+	}
+
+	template<class Sink, typename Float>
+	inline void _format_value(Sink& sink, const FormatSpec& spec, Float value, std::integral_constant<_FormatCategory, _FormatCategory::Float>)
+	{
+		char buffer[512];	//A precision of at most 100 leaves room for %f of the largest double
+		size_t n;
+		if (spec.type == 0 && spec.precision < 0)
+			n = size_t(to_chars(buffer, buffer + sizeof(buffer), value).ptr - buffer);
+		else
+		{
+			const char* conversion = spec.type == 'e' ? "%.*e" : spec.type == 'g' ? "%.*g" : "%.*f";
+			n = size_t(snprintf(buffer, sizeof(buffer), conversion, spec.precision < 0 ? 6 : spec.precision, double(value)));
+		}
+		if (spec.zero_pad && !(value - value == value - value))	//inf and nan are not padded with zeros
+		{
+			FormatSpec unpadded = spec;
+			unpadded.zero_pad = false;
+			_write_padded(sink, unpadded, buffer, n, '>');
+		}
+		else
+			_write_padded(sink, spec, buffer, n, '>', buffer[0] == '-');
+	}
+
+	template<class Sink>
+	inline void _format_value(Sink& sink, const FormatSpec& spec, char value, std::integral_constant<_FormatCategory, _FormatCategory::Char>)
+	{
+		_write_padded(sink, spec, &value, 1, '<');
+	}
+
+	template<class Sink>
+	inline void _format_value(Sink& sink, const FormatSpec& spec, bool value, std::integral_constant<_FormatCategory, _FormatCategory::Bool>)
+	{
+		_write_padded(sink, spec, value ? "true" : "false", value ? 4 : 5, '<');
+	}
+
+	template<class Sink>
+	inline void _format_value(Sink& sink, const FormatSpec& spec, StringView value, std::integral_constant<_FormatCategory, _FormatCategory::String>)
+	{
+		size_t n = spec.precision >= 0 && size_t(spec.precision) < value.size() ? size_t(spec.precision) : value.size();
+		_write_padded(sink, spec, value.data(), n, '<');
+	}
+
+	template<class Format, class Sink, size_t... I, typename... Args>
+	inline void _format(Sink& sink, std::index_sequence<I...>, const Args&... args)
+	{
+		const auto& parsed = Format::parsed;
+		size_t text_begin = 0;
+		int in_order[] = { 0, (sink.write(parsed.text + text_begin, parsed.fields[I].text_end - text_begin),
+			_format_value(sink, parsed.fields[I].spec, args, std::integral_constant<_FormatCategory, _format_category<Args>()>{}),
+			text_begin = parsed.fields[I].text_end, 0)... };	//A braced list is evaluated left to right
+		(void)in_order;
+		sink.write(parsed.text + text_begin, parsed.text_length - text_begin);
+	}
+
+	template<class FormatString, typename... Args>
+	inline String format(FormatString fmt, const Args&... args)
+	{
+		String result;
+		result.reserve(_CompiledFormat<FormatString>::parsed.text_length + 16 * sizeof...(Args));
+		format_to(result, fmt, args...);
+		return result;
+	}
+
+	template<class FormatString, typename Traits, class Allocator, typename... Args>
+	inline BasicString<char, Traits, Allocator>& format_to(BasicString<char, Traits, Allocator>& out, FormatString, const Args&... args)
+	{
+		_StringFormatSink<BasicString<char, Traits, Allocator>> sink{ out };
+		_format<_CheckedFormat<FormatString, Args...>>(sink, std::index_sequence_for<Args...>{}, args...);
+		return out;
+	}
+
+	template<class FormatString, typename... Args>
+	inline FormatToResult format_to(char* first, char* last, FormatString, const Args&... args)
+	{
+		_BufferFormatSink sink{ first, last, 0 };
+		_format<_CheckedFormat<FormatString, Args...>>(sink, std::index_sequence_for<Args...>{}, args...);
+		return { sink.curr, sink.size };
+	}
+
+	template<class FormatString, typename... Args>
+	inline size_t formatted_size(FormatString, const Args&... args)
+	{
+		_CountingFormatSink sink;
+		_format<_CheckedFormat<FormatString, Args...>>(sink, std::index_sequence_for<Args...>{}, args...);
+		return sink.size;
+	}
+}
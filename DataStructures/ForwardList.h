@@ -1,11 +1,59 @@
 #pragma once
 #include <stdexcept>
+#include <memory>
+#include <algorithm>
+#include <new>
+#include <utility>
+#include <thread>
+#include <vector>
+#include "SIMD.h"
 
 #define MAX_FORWARDLIST_SIZE 1073741824U;	//1GB
+constexpr size_t FORWARDLIST_SORT_GATHER_MIN = 1U << 19;	//From this length on sort() sorts an array of node pointers
+constexpr size_t FORWARDLIST_PARALLEL_SORT_MIN = 1U << 16;	//Shorter lists, or pieces of a list, are not worth a thread
 
 namespace DataStructures
 {
-	template<typename T>
+	//Nodes come from Allocator rebound to the node type. With a PoolAllocator, nodes are carved one after another from
+	//the slabs of a NodePool, so nodes inserted in a row are adjacent in memory and inserting or erasing costs no malloc.
+	//merge() and splice_after() relink nodes, both lists must use allocators that compare equal.
+	//Policies of ForwardList. With UntrackedSize the list holds nothing but its nodes, and size() and back() traverse it.
+	//With TrackedSize every mutator keeps an element count and the last node up to date, so size(), back() and
+	//push_back() are O(1), e.g. for a list used as a queue whose length is reported.
+	struct UntrackedSize {};
+	struct TrackedSize {};
+
+	template<typename Policy, typename Node> class _ForwardListTracking;
+
+	template<typename Node>
+	class _ForwardListTracking<UntrackedSize, Node>
+	{
+	public:
+		static constexpr bool enabled = false;
+		size_t count() const noexcept { return 0; }
+		Node* last() const noexcept { return nullptr; }
+		void set(size_t, Node*) noexcept {}
+		void set_last(Node*) noexcept {}
+		void add(ptrdiff_t) noexcept {}
+	};
+
+	template<typename Node>
+	class _ForwardListTracking<TrackedSize, Node>
+	{
+	public:
+		static constexpr bool enabled = true;
+		size_t count() const noexcept { return node_count; }
+		Node* last() const noexcept { return last_node; }
+		void set(size_t n, Node* p) noexcept { node_count = n; last_node = p; }
+		void set_last(Node* p) noexcept { last_node = p; }
+		void add(ptrdiff_t n) noexcept { node_count += n; }
+
+	private:
+		size_t node_count = 0;
+		Node* last_node = nullptr;		//Null while the list is empty
+	};
+
+	template<typename T, class Allocator = std::allocator<T>, class SizePolicy = UntrackedSize>
 	class ForwardList
 	{
 	private:
@@ -14,6 +62,7 @@ namespace DataStructures
 		class ForwardListConstIterator;
 
 	public:
+		using allocator_type	= Allocator;
 		using value_type		= T;
 		using reference			= T&;
 		using const_reference	= const T&;
@@ -27,24 +76,27 @@ namespace DataStructures
 
 		//Constructor, Destructor and Assignment
 		ForwardList() noexcept;
-		explicit ForwardList(size_type n);
-		ForwardList(size_type n, const T& val);
+		explicit ForwardList(const Allocator& alloc) noexcept;
+		explicit ForwardList(size_type n, const Allocator& alloc = Allocator());
+		ForwardList(size_type n, const T& val, const Allocator& alloc = Allocator());
 
 		template<typename InputIterator, typename = typename std::enable_if_t<std::_Is_iterator<InputIterator>::value>>
-		ForwardList(InputIterator first, InputIterator last);
+		ForwardList(InputIterator first, InputIterator last, const Allocator& alloc = Allocator());
 
-		ForwardList(std::initializer_list<T> init);
-		ForwardList(const ForwardList<T>& origin);
-		ForwardList(ForwardList<T> && origin) noexcept;
+		ForwardList(std::initializer_list<T> init, const Allocator& alloc = Allocator());
+		ForwardList(const ForwardList<T, Allocator, SizePolicy>& origin);
+		ForwardList(const ForwardList<T, Allocator, SizePolicy>& origin, const Allocator& alloc);
+		ForwardList(ForwardList<T, Allocator, SizePolicy> && origin) noexcept;
 		~ForwardList();
-		ForwardList<T>& operator=(const ForwardList<T>& origin);
-		ForwardList<T>& operator=(ForwardList<T>&& origin);
-		ForwardList<T>& operator=(std::initializer_list<T> origin);
+		ForwardList<T, Allocator, SizePolicy>& operator=(const ForwardList<T, Allocator, SizePolicy>& origin);
+		ForwardList<T, Allocator, SizePolicy>& operator=(ForwardList<T, Allocator, SizePolicy>&& origin);
+		ForwardList<T, Allocator, SizePolicy>& operator=(std::initializer_list<T> origin);
 		void assign(size_type n, const T& val);
 		void assign(std::initializer_list<T> list);
 
 		template<typename InputIterator, typename = typename std::enable_if_t<std::_Is_iterator<InputIterator>::value>>
 		void assign(InputIterator first, InputIterator last);	//last not included
+		allocator_type get_allocator() const;
 
 		//Element access
 		reference front();
@@ -82,7 +134,7 @@ namespace DataStructures
 		void pop_front();
 		void resize(size_type n);
 		void resize(size_type n, const T& val);
-		void swap(ForwardList<T>& other);
+		void swap(ForwardList<T, Allocator, SizePolicy>& other);
 		//Standard does not provide insert() to avoid overhead.
 
 		//Operations
@@ -101,11 +153,11 @@ namespace DataStructures
 		void reverse() noexcept;
 		void unique();	//Remove all consecutive duplicate elements.
 		template<typename BinaryPredicate> void unique(BinaryPredicate p);
-		void sort();
+		void sort();	//Stable, O(n log n)
 		template<typename Compare> void sort(Compare comp);
 
 		//Non-Standard Functions
-		size_type size();	//O(n) algorithm. Traverse the list.
+		size_type size() const noexcept;	//O(1) with TrackedSize, otherwise traverses the list
 		iterator insert(const_iterator pos, const T& val);
 		iterator insert(const_iterator pos, T&& val);
 		iterator insert(const_iterator pos, size_type n, T& val);
@@ -118,24 +170,44 @@ namespace DataStructures
 		void push_back(const T& val);
 		void push_back(T&& val);
 		template <typename ... Args> void emplace_back(Args&& ... args);
-		void pop_back();
-		reference back();	//O(n)
+		void pop_back();	//O(n), the node before the last is found by traversal
+		reference back();	//O(1) with TrackedSize, otherwise O(n)
 		iterator before_end() noexcept;
 		const_iterator before_end() const noexcept;
 		const_iterator cbefore_end() const noexcept;
+		//Bulk operations. The next node is prefetched before the current value is handed out, so its load overlaps the work.
+		template<typename Function> Function for_each(Function f);
+		template<typename Function> Function for_each(Function f) const;
+		template<typename U> U accumulate(U init) const;
+		template<typename U, typename BinaryOperation> U accumulate(U init, BinaryOperation op) const;
+		iterator find(const T& val);
+		const_iterator find(const T& val) const;
+		template<typename UnaryPredicate> iterator find_if(UnaryPredicate p);
+		template<typename UnaryPredicate> const_iterator find_if(UnaryPredicate p) const;
+		void compact();	//Moves the values so that traversal order is address order, invalidates iterators
+		//Stable sort on up to thread_count threads, 0 for one per hardware thread. The list is cut into pieces that are
+		//sorted concurrently and then merged in pairs, each round of merges running concurrently. Nodes are relinked,
+		//never copied or allocated. As with the parallel algorithms of the standard library, a throwing comp terminates.
+		void parallel_sort();
+		template<typename Compare> void parallel_sort(Compare comp, size_type thread_count = 0);
 
 		//Non-Member Functions
-		template<typename T> friend bool operator==(const ForwardList<T>& lhs, const ForwardList<T>& rhs);
-		template<typename T> friend bool operator!=(const ForwardList<T>& lhs, const ForwardList<T>& rhs);
-		template<typename T> friend bool operator<(const ForwardList<T>& lhs, const ForwardList<T>& rhs);
-		template<typename T> friend bool operator<=(const ForwardList<T>& lhs, const ForwardList<T>& rhs);
-		template<typename T> friend bool operator>(const ForwardList<T>& lhs, const ForwardList<T>& rhs);
-		template<typename T> friend bool operator>=(const ForwardList<T>& lhs, const ForwardList<T>& rhs);
-		template<typename T> friend void swap(ForwardList<T>& lhs, ForwardList<T>& rhs);
+		template<typename T, class Allocator, class SizePolicy> friend bool operator==(const ForwardList<T, Allocator, SizePolicy>& lhs, const ForwardList<T, Allocator, SizePolicy>& rhs);
+		template<typename T, class Allocator, class SizePolicy> friend bool operator!=(const ForwardList<T, Allocator, SizePolicy>& lhs, const ForwardList<T, Allocator, SizePolicy>& rhs);
+		template<typename T, class Allocator, class SizePolicy> friend bool operator<(const ForwardList<T, Allocator, SizePolicy>& lhs, const ForwardList<T, Allocator, SizePolicy>& rhs);
+		template<typename T, class Allocator, class SizePolicy> friend bool operator<=(const ForwardList<T, Allocator, SizePolicy>& lhs, const ForwardList<T, Allocator, SizePolicy>& rhs);
+		template<typename T, class Allocator, class SizePolicy> friend bool operator>(const ForwardList<T, Allocator, SizePolicy>& lhs, const ForwardList<T, Allocator, SizePolicy>& rhs);
+		template<typename T, class Allocator, class SizePolicy> friend bool operator>=(const ForwardList<T, Allocator, SizePolicy>& lhs, const ForwardList<T, Allocator, SizePolicy>& rhs);
+		template<typename T, class Allocator, class SizePolicy> friend void swap(ForwardList<T, Allocator, SizePolicy>& lhs, ForwardList<T, Allocator, SizePolicy>& rhs);
 		
 
 	private:
 		using node_type = ForwardListNode;
+		using node_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<ForwardListNode>;
+		using node_traits = std::allocator_traits<node_allocator>;
+		node_allocator allocator;
+		static constexpr bool tracked = _ForwardListTracking<SizePolicy, ForwardListNode>::enabled;
+		_ForwardListTracking<SizePolicy, ForwardListNode> tracking;
 		//fore->first->...->last->end
 		node_type head;
 		node_type tail;	
@@ -147,6 +219,14 @@ namespace DataStructures
 	private:
 		void move_after(iterator& from, iterator& to);	//Moves the node after "from" to after "to".
 		void move_front(iterator& from);				//No check for from
+		template<typename ...Args> node_type* create_node(Args&& ...args);
+		template<typename Compare> static node_type* merge_runs(node_type* a, node_type* b, const node_type* end, Compare& comp);
+		//The chain sorts take the n nodes from first up to end and return them sorted, ending at null, with their last node in last
+		template<typename Compare> static node_type* sort_chain(node_type* first, const node_type* end, size_type n, Compare& comp, node_type*& last);
+		template<typename Compare> static node_type* sort_runs(node_type* first, const node_type* end, Compare& comp, node_type*& last);	//Bottom-up merge sort, no allocation
+		template<typename Compare> static node_type* sort_gathered(node_type* first, const node_type* end, size_type n, Compare& comp, node_type*& last);	//Sorts node pointers, null if no buffer could be had
+		void destroy_node(node_type* p) noexcept;
+		static void destroy_values(T* values, size_type n) noexcept;	//Destroys n values and frees their raw storage
 
 	private:
 		struct ForwardListNode
@@ -192,7 +272,7 @@ namespace DataStructures
 			ForwardListIterator(const ForwardListConstIterator& origin) : p(const_cast<ForwardListNode*>(origin.p)) {}
 
 		private:
-			template<typename T> friend class ForwardList;
+			template<typename T, class Allocator, class SizePolicy> friend class ForwardList;
 			ForwardListNode* p = nullptr;
 		};
 
@@ -223,21 +303,27 @@ namespace DataStructures
 			pointer operator->() const { return &p->value; }	//So does this?
 
 		private:
-			template<typename T> friend class ForwardList;
+			template<typename T, class Allocator, class SizePolicy> friend class ForwardList;
 			const ForwardListNode* p = nullptr;
 		};
 	};
 
 	/* Dividing Line ( 㧥 ;) ( 㧥 ;) ( 㧥 ;)  */
 
-	template<typename T>
-	inline ForwardList<T>::ForwardList() noexcept 
+	template<typename T, class Allocator, class SizePolicy>
+	inline ForwardList<T, Allocator, SizePolicy>::ForwardList() noexcept 
 	{
 		head.next = &tail;
 	}
 
-	template<typename T>
-	inline ForwardList<T>::ForwardList(size_type n) : ForwardList<T>()
+	template<typename T, class Allocator, class SizePolicy>
+	inline ForwardList<T, Allocator, SizePolicy>::ForwardList(const Allocator & alloc) noexcept : allocator(alloc)
+	{
+		head.next = &tail;
+	}
+
+	template<typename T, class Allocator, class SizePolicy>
+	inline ForwardList<T, Allocator, SizePolicy>::ForwardList(size_type n, const Allocator & alloc) : ForwardList<T, Allocator, SizePolicy>(alloc)
 	{
 		//node_type* curr = &head;
 		//for (size_t i = 0; i < n; i++)
@@ -249,14 +335,15 @@ namespace DataStructures
 		iterator curr = before_begin();
 		for (size_t i = 0; i < n; i++)
 		{
-			curr.p->next = new node_type(T());
+			curr.p->next = create_node(T());
 			++curr;
 		}
 		curr.p->next = end().p;
+		tracking.set(n, n ? curr.p : nullptr);
 	}
 
-	template<typename T>
-	inline ForwardList<T>::ForwardList(size_type n, const T & val) : ForwardList<T>()
+	template<typename T, class Allocator, class SizePolicy>
+	inline ForwardList<T, Allocator, SizePolicy>::ForwardList(size_type n, const T & val, const Allocator & alloc) : ForwardList<T, Allocator, SizePolicy>(alloc)
 	{
 		//node_type* curr = &head;
 		//for (size_t i = 0; i < n; i++)
@@ -268,15 +355,16 @@ namespace DataStructures
 		iterator curr = before_begin();
 		for (size_t i = 0; i < n; i++)
 		{
-			curr.p->next = new node_type(val);
+			curr.p->next = create_node(val);
 			++curr;
 		}
 		curr.p->next = end().p;
+		tracking.set(n, n ? curr.p : nullptr);
 	}
 
-	template<typename T>
+	template<typename T, class Allocator, class SizePolicy>
 	template<typename InputIterator, typename SFINAE_MAGIC>
-	inline ForwardList<T>::ForwardList(InputIterator first, InputIterator last) : ForwardList<T>()
+	inline ForwardList<T, Allocator, SizePolicy>::ForwardList(InputIterator first, InputIterator last, const Allocator & alloc) : ForwardList<T, Allocator, SizePolicy>(alloc)
 	{
 		//node_type* curr = &head;
 		//while (first != last)
@@ -286,146 +374,161 @@ namespace DataStructures
 		//}
 		//curr->next = &tail;
 		iterator curr = before_begin();
+		size_type n = 0;
 		while (first != last)
 		{
-			curr.p->next = new node_type(*first++);
+			curr.p->next = create_node(*first++);
 			++curr;
+			++n;
 		}		
 		curr.p->next = end().p;
+		tracking.set(n, n ? curr.p : nullptr);
+	}
+
+	template<typename T, class Allocator, class SizePolicy>
+	inline ForwardList<T, Allocator, SizePolicy>::ForwardList(std::initializer_list<T> list, const Allocator & alloc) : 
+		ForwardList(list.begin(), list.end(), alloc)
+	{
 	}
 
-	template<typename T>
-	inline ForwardList<T>::ForwardList(std::initializer_list<T> list) : 
-		ForwardList(list.begin(), list.end())
+	template<typename T, class Allocator, class SizePolicy>
+	inline ForwardList<T, Allocator, SizePolicy>::ForwardList(const ForwardList<T, Allocator, SizePolicy>& origin) : 
+		ForwardList(origin.cbegin(), origin.cend(), origin.get_allocator())
 	{
 	}
 
-	template<typename T>
-	inline ForwardList<T>::ForwardList(const ForwardList<T>& origin) : 
-		ForwardList(origin.cbegin(), origin.cend())
+	template<typename T, class Allocator, class SizePolicy>
+	inline ForwardList<T, Allocator, SizePolicy>::ForwardList(const ForwardList<T, Allocator, SizePolicy>& origin, const Allocator & alloc) : 
+		ForwardList(origin.cbegin(), origin.cend(), alloc)
 	{
 	}
 
-	template<typename T>
-	inline ForwardList<T>::ForwardList(ForwardList<T>&& origin) noexcept
+	template<typename T, class Allocator, class SizePolicy>
+	inline ForwardList<T, Allocator, SizePolicy>::ForwardList(ForwardList<T, Allocator, SizePolicy>&& origin) noexcept : allocator(origin.allocator)
 	{
 		head.next = &tail;
 		swap(origin);
 	}
 
-	template<typename T>
-	inline ForwardList<T>::~ForwardList()
+	template<typename T, class Allocator, class SizePolicy>
+	inline ForwardList<T, Allocator, SizePolicy>::~ForwardList()
 	{
 		clear();
 	}
 
-	template<typename T>
-	inline ForwardList<T>& ForwardList<T>::operator=(const ForwardList<T>& origin)
+	template<typename T, class Allocator, class SizePolicy>
+	inline ForwardList<T, Allocator, SizePolicy>& ForwardList<T, Allocator, SizePolicy>::operator=(const ForwardList<T, Allocator, SizePolicy>& origin)
 	{
-		swap(ForwardList<T>(origin));
+		swap(ForwardList<T, Allocator, SizePolicy>(origin));
 		return *this;
 	}
 
-	template<typename T>
-	inline ForwardList<T>& ForwardList<T>::operator=(ForwardList<T>&& origin)
+	template<typename T, class Allocator, class SizePolicy>
+	inline ForwardList<T, Allocator, SizePolicy>& ForwardList<T, Allocator, SizePolicy>::operator=(ForwardList<T, Allocator, SizePolicy>&& origin)
 	{
 		swap(origin);
 		return *this;
 	}
 
-	template<typename T>
-	inline ForwardList<T>& ForwardList<T>::operator=(std::initializer_list<T> origin)
+	template<typename T, class Allocator, class SizePolicy>
+	inline ForwardList<T, Allocator, SizePolicy>& ForwardList<T, Allocator, SizePolicy>::operator=(std::initializer_list<T> origin)
 	{
-		swap(ForwardList<T>(origin));
+		swap(ForwardList<T, Allocator, SizePolicy>(origin, get_allocator()));
 		return *this;
 	}
 
-	template<typename T>
-	inline void ForwardList<T>::assign(size_type n, const T & val)
+	template<typename T, class Allocator, class SizePolicy>
+	inline void ForwardList<T, Allocator, SizePolicy>::assign(size_type n, const T & val)
+	{
+		swap(ForwardList<T, Allocator, SizePolicy>(n, val, get_allocator()));
+	}
+
+	template<typename T, class Allocator, class SizePolicy>
+	inline void ForwardList<T, Allocator, SizePolicy>::assign(std::initializer_list<T> init)
 	{
-		swap(ForwardList<T>(n, val));
+		swap(ForwardList<T, Allocator, SizePolicy>(init, get_allocator()));
 	}
 
-	template<typename T>
-	inline void ForwardList<T>::assign(std::initializer_list<T> init)
+	template<typename T, class Allocator, class SizePolicy>
+	inline typename ForwardList<T, Allocator, SizePolicy>::allocator_type ForwardList<T, Allocator, SizePolicy>::get_allocator() const
 	{
-		swap(ForwardList<T>(init));
+		return allocator_type(allocator);
 	}
 
-	template<typename T>
-	inline typename ForwardList<T>::reference ForwardList<T>::front()
+	template<typename T, class Allocator, class SizePolicy>
+	inline typename ForwardList<T, Allocator, SizePolicy>::reference ForwardList<T, Allocator, SizePolicy>::front()
 	{
 		return *begin();
 	}
 
-	template<typename T>
-	inline typename ForwardList<T>::iterator ForwardList<T>::begin() noexcept
+	template<typename T, class Allocator, class SizePolicy>
+	inline typename ForwardList<T, Allocator, SizePolicy>::iterator ForwardList<T, Allocator, SizePolicy>::begin() noexcept
 	{
 		return iterator(head.next);
 	}
 
-	template<typename T>
-	inline typename ForwardList<T>::const_iterator ForwardList<T>::begin() const noexcept
+	template<typename T, class Allocator, class SizePolicy>
+	inline typename ForwardList<T, Allocator, SizePolicy>::const_iterator ForwardList<T, Allocator, SizePolicy>::begin() const noexcept
 	{
 		return const_iterator(head.next);
 	}
 
-	template<typename T>
-	inline typename ForwardList<T>::const_iterator ForwardList<T>::cbegin() const noexcept
+	template<typename T, class Allocator, class SizePolicy>
+	inline typename ForwardList<T, Allocator, SizePolicy>::const_iterator ForwardList<T, Allocator, SizePolicy>::cbegin() const noexcept
 	{
 		return const_iterator(head.next);
 	}
 
-	template<typename T>
-	inline typename ForwardList<T>::iterator ForwardList<T>::end() noexcept
+	template<typename T, class Allocator, class SizePolicy>
+	inline typename ForwardList<T, Allocator, SizePolicy>::iterator ForwardList<T, Allocator, SizePolicy>::end() noexcept
 	{
 		return iterator(&tail);
 	}
 
-	template<typename T>
-	inline typename ForwardList<T>::const_iterator ForwardList<T>::end() const noexcept
+	template<typename T, class Allocator, class SizePolicy>
+	inline typename ForwardList<T, Allocator, SizePolicy>::const_iterator ForwardList<T, Allocator, SizePolicy>::end() const noexcept
 	{
 		return const_iterator(&tail);
 	}
 
-	template<typename T>
-	inline typename ForwardList<T>::const_iterator ForwardList<T>::cend() const noexcept
+	template<typename T, class Allocator, class SizePolicy>
+	inline typename ForwardList<T, Allocator, SizePolicy>::const_iterator ForwardList<T, Allocator, SizePolicy>::cend() const noexcept
 	{
 		return const_iterator(&tail);
 	}
 
-	template<typename T>
-	inline typename ForwardList<T>::iterator ForwardList<T>::before_begin() noexcept
+	template<typename T, class Allocator, class SizePolicy>
+	inline typename ForwardList<T, Allocator, SizePolicy>::iterator ForwardList<T, Allocator, SizePolicy>::before_begin() noexcept
 	{
 		return iterator(&head);
 	}
 
-	template<typename T>
-	inline typename ForwardList<T>::const_iterator ForwardList<T>::before_begin() const noexcept
+	template<typename T, class Allocator, class SizePolicy>
+	inline typename ForwardList<T, Allocator, SizePolicy>::const_iterator ForwardList<T, Allocator, SizePolicy>::before_begin() const noexcept
 	{
 		return const_iterator(&head);
 	}
 
-	template<typename T>
-	inline typename ForwardList<T>::const_iterator ForwardList<T>::cbefore_begin() const noexcept
+	template<typename T, class Allocator, class SizePolicy>
+	inline typename ForwardList<T, Allocator, SizePolicy>::const_iterator ForwardList<T, Allocator, SizePolicy>::cbefore_begin() const noexcept
 	{
 		return const_iterator(&head);
 	}
 
-	template<typename T>
-	inline bool ForwardList<T>::empty() const noexcept
+	template<typename T, class Allocator, class SizePolicy>
+	inline bool ForwardList<T, Allocator, SizePolicy>::empty() const noexcept
 	{
 		return begin() == end();
 	}
 
-	template<typename T>
-	inline typename ForwardList<T>::size_type ForwardList<T>::max_size() const noexcept
+	template<typename T, class Allocator, class SizePolicy>
+	inline typename ForwardList<T, Allocator, SizePolicy>::size_type ForwardList<T, Allocator, SizePolicy>::max_size() const noexcept
 	{
 		return MAX_FORWARDLIST_SIZE;
 	}
 
-	template<typename T>
-	inline void ForwardList<T>::clear() noexcept
+	template<typename T, class Allocator, class SizePolicy>
+	inline void ForwardList<T, Allocator, SizePolicy>::clear() noexcept
 	{
 		//for (node_type* prev = head.next, *curr = prev->next; 
 		//	curr->next != nullptr; prev = curr, curr = curr->next)
@@ -434,25 +537,26 @@ namespace DataStructures
 		for (iterator prev = begin(), curr = begin(); curr != end(); prev = curr)
 		{
 			curr++;
-			delete prev.p;
+			destroy_node(prev.p);
 		}
 		head.next = &tail;
+		tracking.set(0, nullptr);
 	}
 
-	template<typename T>
-	inline typename ForwardList<T>::iterator ForwardList<T>::insert_after(const_iterator pos, const T & val)
+	template<typename T, class Allocator, class SizePolicy>
+	inline typename ForwardList<T, Allocator, SizePolicy>::iterator ForwardList<T, Allocator, SizePolicy>::insert_after(const_iterator pos, const T & val)
 	{
 		return emplace_after(pos, val);
 	}
 
-	template<typename T>
-	inline typename ForwardList<T>::iterator ForwardList<T>::insert_after(const_iterator pos, T && val)
+	template<typename T, class Allocator, class SizePolicy>
+	inline typename ForwardList<T, Allocator, SizePolicy>::iterator ForwardList<T, Allocator, SizePolicy>::insert_after(const_iterator pos, T && val)
 	{
 		return emplace_after(pos, std::move(val));
 	}
 
-	template<typename T>
-	inline typename ForwardList<T>::iterator ForwardList<T>::insert_after(const_iterator pos, size_type n, const T & val)
+	template<typename T, class Allocator, class SizePolicy>
+	inline typename ForwardList<T, Allocator, SizePolicy>::iterator ForwardList<T, Allocator, SizePolicy>::insert_after(const_iterator pos, size_type n, const T & val)
 	{
 		iterator ret(pos);
 		for (size_t i = 0; i < n; i++)
@@ -460,8 +564,8 @@ namespace DataStructures
 		return ret;
 	}
 
-	template<typename T>
-	inline typename ForwardList<T>::iterator ForwardList<T>::insert_after(const_iterator pos, std::initializer_list<T> list)
+	template<typename T, class Allocator, class SizePolicy>
+	inline typename ForwardList<T, Allocator, SizePolicy>::iterator ForwardList<T, Allocator, SizePolicy>::insert_after(const_iterator pos, std::initializer_list<T> list)
 	{
 		iterator ret(pos);
 		for (const T& elem : list)
@@ -469,18 +573,24 @@ namespace DataStructures
 		return ret;
 	}
 
-	template<typename T>
-	inline typename ForwardList<T>::iterator ForwardList<T>::erase_after(const_iterator pos)
+	template<typename T, class Allocator, class SizePolicy>
+	inline typename ForwardList<T, Allocator, SizePolicy>::iterator ForwardList<T, Allocator, SizePolicy>::erase_after(const_iterator pos)
 	{
 		iterator _next(pos);
 		iterator _curr = _next++;
 		_curr.p->next = _next.p->next;
-		delete _next.p;
+		if (tracked)
+		{
+			tracking.add(-1);
+			if (_next.p == tracking.last())
+				tracking.set_last(_curr.p == &head ? nullptr : _curr.p);
+		}
+		destroy_node(_next.p);
 		return _curr;
 	}
 
-	template<typename T>
-	inline typename ForwardList<T>::iterator ForwardList<T>::erase_after(const_iterator first, const_iterator last)
+	template<typename T, class Allocator, class SizePolicy>
+	inline typename ForwardList<T, Allocator, SizePolicy>::iterator ForwardList<T, Allocator, SizePolicy>::erase_after(const_iterator first, const_iterator last)
 	{
 		iterator ret(first);
 		iterator _last(last);
@@ -489,26 +599,26 @@ namespace DataStructures
 		return ret;
 	}
 
-	template<typename T>
-	inline void ForwardList<T>::push_front(const T & val)
+	template<typename T, class Allocator, class SizePolicy>
+	inline void ForwardList<T, Allocator, SizePolicy>::push_front(const T & val)
 	{
 		emplace_front(val);
 	}
 
-	template<typename T>
-	inline void ForwardList<T>::push_front(T && val)
+	template<typename T, class Allocator, class SizePolicy>
+	inline void ForwardList<T, Allocator, SizePolicy>::push_front(T && val)
 	{
 		emplace_front(std::move(val));
 	}
 
-	template<typename T>
-	inline void ForwardList<T>::pop_front()
+	template<typename T, class Allocator, class SizePolicy>
+	inline void ForwardList<T, Allocator, SizePolicy>::pop_front()
 	{
 		erase_after(before_begin());
 	}
 
-	template<typename T>
-	inline void ForwardList<T>::resize(size_type n)
+	template<typename T, class Allocator, class SizePolicy>
+	inline void ForwardList<T, Allocator, SizePolicy>::resize(size_type n)
 	{
 		size_type cnt = 0;
 		iterator curr = begin();
@@ -523,8 +633,8 @@ namespace DataStructures
 			curr = emplace_after(curr);
 	}
 
-	template<typename T>
-	inline void ForwardList<T>::resize(size_type n, const T & val)
+	template<typename T, class Allocator, class SizePolicy>
+	inline void ForwardList<T, Allocator, SizePolicy>::resize(size_type n, const T & val)
 	{
 		size_type cnt = 0;
 		iterator curr = before_begin();
@@ -543,16 +653,16 @@ namespace DataStructures
 		insert_after(curr, n - cnt, val);
 	}
 
-	template<typename T>
+	template<typename T, class Allocator, class SizePolicy>
 	template<typename InputIterator, typename SFINAE_MAGIC>
-	inline void ForwardList<T>::assign(InputIterator first, InputIterator last)
+	inline void ForwardList<T, Allocator, SizePolicy>::assign(InputIterator first, InputIterator last)
 	{
-		swap(ForwardList<T>(first, last));
+		swap(ForwardList<T, Allocator, SizePolicy>(first, last, get_allocator()));
 	}
 
-	template<typename T>
+	template<typename T, class Allocator, class SizePolicy>
 	template<typename InputIterator, typename SFINAE_MAGIC>
-	inline typename ForwardList<T>::iterator ForwardList<T>::insert_after(const_iterator pos, InputIterator first, InputIterator last)
+	inline typename ForwardList<T, Allocator, SizePolicy>::iterator ForwardList<T, Allocator, SizePolicy>::insert_after(const_iterator pos, InputIterator first, InputIterator last)
 	{
 		iterator ret(pos);
 		while (first != last)
@@ -560,116 +670,97 @@ namespace DataStructures
 		return ret;
 	}
 
-	template<typename T>
+	template<typename T, class Allocator, class SizePolicy>
 	template<typename ...Args>
-	inline typename ForwardList<T>::iterator ForwardList<T>::emplace_after(const_iterator pos, Args && ...args)
+	inline typename ForwardList<T, Allocator, SizePolicy>::iterator ForwardList<T, Allocator, SizePolicy>::emplace_after(const_iterator pos, Args && ...args)
 	{
 		iterator _iter(pos);
-		return _iter.p->next = new ForwardListNode(_iter.p->next, std::forward<Args>(args) ...);
-		return _iter;
+		node_type* node = _iter.p->next = create_node(_iter.p->next, std::forward<Args>(args) ...);
+		if (tracked)
+		{
+			tracking.add(1);
+			if (node->next == &tail)
+				tracking.set_last(node);
+		}
+		return iterator(node);
 	}
 
-	template<typename T>
+	template<typename T, class Allocator, class SizePolicy>
 	template<typename ...Args>
-	inline typename ForwardList<T>::reference ForwardList<T>::emplace_front(Args && ...args)
+	inline typename ForwardList<T, Allocator, SizePolicy>::reference ForwardList<T, Allocator, SizePolicy>::emplace_front(Args && ...args)
 	{
-		return (head.next = new ForwardListNode(head.next, std::forward<Args>(args) ...))->value;
+		node_type* node = head.next = create_node(head.next, std::forward<Args>(args) ...);
+		if (tracked)
+		{
+			tracking.add(1);
+			if (node->next == &tail)
+				tracking.set_last(node);
+		}
+		return node->value;
 	}
 
-	template<typename T>
+	template<typename T, class Allocator, class SizePolicy>
 	template<typename Compare>
-	inline void ForwardList<T>::merge(ForwardList & other, Compare comp)
+	inline void ForwardList<T, Allocator, SizePolicy>::merge(ForwardList & other, Compare comp)
 	{
 		if (this == &other) return;
 		if (other.empty()) return;
-		if (empty())
-		{
-			swap(other);
-			return;
-		}
-
-		iterator next_this = begin();
-		iterator curr_this = next_this++;
-		iterator curr_other = other.before_begin();
-		iterator prev_other = curr_other++;
-
-		//After this step, comp(*curr_other, *curr_this) == false is guaranteed.
-		if (comp(*curr_other, *curr_this))
-		{
-			other.merge(*this, comp);
-			swap(other);
-			return;
-		}
-
-		while (next_this != end() && curr_other != other.end())
-		{
-			if (comp(*curr_other, *next_this))
-			{
-				++curr_other;
-				move_after(prev_other, curr_this);
-				++curr_this;
-			}
-			else
-			{
-				++curr_this;
-				++next_this;
-				continue;
-			}
-		}
-		while (curr_other != other.end())
-		{
-			++curr_other;
-			move_after(prev_other, curr_this);
-			++curr_this;
-		}
+		//The last node of other ends up last unless it goes before the last node of *this
+		node_type* last = other.tracking.last();
+		if (tracked && !empty() && comp(last->value, tracking.last()->value))
+			last = tracking.last();
+		//Both chains end at tail, nodes of *this go first among equal elements
+		other.before_end().p->next = &tail;
+		head.next = merge_runs(head.next, other.head.next, &tail, comp);
+		other.head.next = &other.tail;
+		tracking.set(tracking.count() + other.tracking.count(), last);
+		other.tracking.set(0, nullptr);
 	}
 
-	template<typename T>
+	template<typename T, class Allocator, class SizePolicy>
 	template<typename Compare>
-	inline void ForwardList<T>::merge(ForwardList && other, Compare comp)
+	inline void ForwardList<T, Allocator, SizePolicy>::merge(ForwardList && other, Compare comp)
 	{
 		merge(other, comp);
 	}
 
-	template<typename T>
+	template<typename T, class Allocator, class SizePolicy>
 	template<typename UnaryPredicate>
-	inline void ForwardList<T>::remove_if(UnaryPredicate p)
+	inline void ForwardList<T, Allocator, SizePolicy>::remove_if(UnaryPredicate p)
 	{
-		iterator curr = before_begin();
-		iterator prev = curr++;
-		while (curr != end())
+		node_type* prev = &head;
+		while (prev->next != &tail)
 		{
-			if (p(*curr))
-			{
-				curr = erase_after(prev);
-				prev = curr++;
-			}
+			node_type* curr = prev->next;
+			_prefetch(curr->next);
+			if (p(curr->value))
+				erase_after(iterator(prev));
 			else
-			{
-				++curr;
-				++prev;
-			}
+				prev = curr;
 		}
 	}
 
-	template<typename T>
+	template<typename T, class Allocator, class SizePolicy>
 	template<typename BinaryPredicate>
-	inline void ForwardList<T>::unique(BinaryPredicate p)
+	inline void ForwardList<T, Allocator, SizePolicy>::unique(BinaryPredicate p)
 	{
 		if (empty()) return;
-		iterator curr = begin();
-		iterator prev = curr++;
-		while (curr != end())
+		node_type* prev = head.next;
+		while (prev->next != &tail)
 		{
-			if (p(*curr, *prev))
-				curr = erase_after(prev);
-			prev = curr++;
+			node_type* curr = prev->next;
+			_prefetch(curr->next);
+			if (p(curr->value, prev->value))
+				erase_after(iterator(prev));
+			else
+				prev = curr;
 		}
 	}
 
-	template<typename T>
-	inline void ForwardList<T>::swap(ForwardList<T>& other)
+	template<typename T, class Allocator, class SizePolicy>
+	inline void ForwardList<T, Allocator, SizePolicy>::swap(ForwardList<T, Allocator, SizePolicy>& other)
 	{
+		std::swap(allocator, other.allocator);	//Nodes change hands, so must the allocator that frees them
 		if (!empty() && !other.empty())
 		{
 			//Swap the tail first, finding the before tail node needs the head!
@@ -692,47 +783,54 @@ namespace DataStructures
 			other.head.next = head.next;
 			head.next = &tail;
 		}
+		std::swap(tracking, other.tracking);	//Last, before_end() uses it
 	}
 
-	template<typename T>
-	inline void ForwardList<T>::merge(ForwardList & other)
+	template<typename T, class Allocator, class SizePolicy>
+	inline void ForwardList<T, Allocator, SizePolicy>::merge(ForwardList & other)
 	{
 		merge(other, std::less<T>());
 	}
 
-	template<typename T>
-	inline void ForwardList<T>::merge(ForwardList && other)
+	template<typename T, class Allocator, class SizePolicy>
+	inline void ForwardList<T, Allocator, SizePolicy>::merge(ForwardList && other)
 	{
 		merge(other, std::less<T>());
 	}
 
-	template<typename T>
-	inline typename ForwardList<T>::iterator ForwardList<T>::before_end() noexcept
+	template<typename T, class Allocator, class SizePolicy>
+	inline typename ForwardList<T, Allocator, SizePolicy>::iterator ForwardList<T, Allocator, SizePolicy>::before_end() noexcept
 	{
+		if (tracked)
+			return iterator(tracking.last() ? tracking.last() : &head);
 		iterator curr = before_begin();
 		while (curr.p->next != end().p) 
 			++curr;
 		return curr;
 	}
 
-	template<typename T>
-	inline typename ForwardList<T>::const_iterator ForwardList<T>::before_end() const noexcept
+	template<typename T, class Allocator, class SizePolicy>
+	inline typename ForwardList<T, Allocator, SizePolicy>::const_iterator ForwardList<T, Allocator, SizePolicy>::before_end() const noexcept
 	{
+		if (tracked)
+			return const_iterator(tracking.last() ? tracking.last() : &head);
 		const_iterator curr = cbefore_begin();
 		while (curr.p->next != cend().p) ++curr;
 		return curr;
 	}
 
-	template<typename T>
-	inline typename ForwardList<T>::const_iterator ForwardList<T>::cbefore_end() const noexcept
+	template<typename T, class Allocator, class SizePolicy>
+	inline typename ForwardList<T, Allocator, SizePolicy>::const_iterator ForwardList<T, Allocator, SizePolicy>::cbefore_end() const noexcept
 	{
+		if (tracked)
+			return const_iterator(tracking.last() ? tracking.last() : &head);
 		const_iterator curr = cbefore_begin();
 		while (curr.p->next != cend().p) ++curr;
 		return curr;
 	}
 
-	template<typename T>
-	inline void ForwardList<T>::move_after(iterator & from, iterator & to)
+	template<typename T, class Allocator, class SizePolicy>
+	inline void ForwardList<T, Allocator, SizePolicy>::move_after(iterator & from, iterator & to)
 	{
 		iterator temp(from.p->next->next);
 		from.p->next->next = to.p->next;
@@ -741,8 +839,8 @@ namespace DataStructures
 		//from and to still at original position
 	}
 
-	template<typename T>
-	inline void ForwardList<T>::move_front(iterator & from)
+	template<typename T, class Allocator, class SizePolicy>
+	inline void ForwardList<T, Allocator, SizePolicy>::move_front(iterator & from)
 	{
 		iterator temp(from.p->next->next);
 		from.p->next->next = begin().p;
@@ -750,69 +848,476 @@ namespace DataStructures
 		from.p->next = temp.p;
 	}
 
-	template<typename T>
-	inline void ForwardList<T>::splice_after(const_iterator pos, ForwardList & other)
+	template<typename T, class Allocator, class SizePolicy>
+	template<typename ...Args>
+	inline typename ForwardList<T, Allocator, SizePolicy>::node_type * ForwardList<T, Allocator, SizePolicy>::create_node(Args && ...args)
+	{
+		node_type* p = node_traits::allocate(allocator, 1);
+		try
+		{
+			node_traits::construct(allocator, p, std::forward<Args>(args) ...);
+		}
+		catch (...)
+		{
+			node_traits::deallocate(allocator, p, 1);
+			throw;
+		}
+		return p;
+	}
+
+	template<typename T, class Allocator, class SizePolicy>
+	inline void ForwardList<T, Allocator, SizePolicy>::destroy_node(node_type * p) noexcept
+	{
+		node_traits::destroy(allocator, p);
+		node_traits::deallocate(allocator, p, 1);
+	}
+
+	template<typename T, class Allocator, class SizePolicy>
+	template<typename Compare>
+	inline typename ForwardList<T, Allocator, SizePolicy>::node_type * ForwardList<T, Allocator, SizePolicy>::merge_runs(node_type * a, node_type * b, const node_type * end, Compare & comp)
+	{
+		//Stable: a node of b goes first only if it is strictly less
+		node_type* first = nullptr;
+		node_type** link = &first;
+		while (a != end && b != end)
+		{
+			if (comp(b->value, a->value))
+			{
+				*link = b;
+				b = b->next;
+			}
+			else
+			{
+				*link = a;
+				a = a->next;
+			}
+			link = &(*link)->next;
+		}
+		*link = a != end ? a : b;
+		return first;
+	}
+
+	template<typename T, class Allocator, class SizePolicy>
+	template<typename Compare>
+	inline typename ForwardList<T, Allocator, SizePolicy>::node_type * ForwardList<T, Allocator, SizePolicy>::sort_chain(node_type * first, const node_type * end, size_type n, Compare & comp, node_type *& last)
+	{
+		//Merging long runs jumps between nodes scattered over memory, sorting pointers in an array misses the cache less
+		if (n >= FORWARDLIST_SORT_GATHER_MIN)
+			if (node_type* sorted = sort_gathered(first, end, n, comp, last))
+				return sorted;
+		return sort_runs(first, end, comp, last);
+	}
+
+	template<typename T, class Allocator, class SizePolicy>
+	template<typename Compare>
+	inline typename ForwardList<T, Allocator, SizePolicy>::node_type * ForwardList<T, Allocator, SizePolicy>::sort_runs(node_type * first, const node_type * end, Compare & comp, node_type *& last)
+	{
+		//runs[i] is empty or holds 2^i nodes sorted, and nodes in higher runs came earlier in the list.
+		//Each node is merged in as a run of one, carrying upwards like a binary counter.
+		node_type* runs[64] = {};
+		node_type* curr = first;
+		while (curr != end)
+		{
+			node_type* run = curr;
+			curr = curr->next;
+			run->next = nullptr;
+			size_t i = 0;
+			for (; runs[i]; i++)
+			{
+				run = merge_runs(runs[i], run, nullptr, comp);
+				runs[i] = nullptr;
+			}
+			runs[i] = run;
+		}
+		node_type* sorted = nullptr;
+		for (size_t i = 0; i < 64; i++)
+			if (runs[i])
+				sorted = sorted ? merge_runs(runs[i], sorted, nullptr, comp) : runs[i];
+		last = sorted;
+		while (last->next)
+			last = last->next;
+		return sorted;
+	}
+
+	template<typename T, class Allocator, class SizePolicy>
+	template<typename Compare>
+	inline typename ForwardList<T, Allocator, SizePolicy>::node_type * ForwardList<T, Allocator, SizePolicy>::sort_gathered(node_type * first, const node_type * end, size_type n, Compare & comp, node_type *& last)
+	{
+		std::unique_ptr<node_type*[]> nodes(new (std::nothrow) node_type*[n]);
+		if (!nodes) return nullptr;
+		node_type** back = nodes.get();
+		for (node_type* curr = first; curr != end; curr = curr->next)
+			*back++ = curr;
+		std::stable_sort(nodes.get(), back, [&comp](const node_type* a, const node_type* b) { return comp(a->value, b->value); });
+		for (node_type** curr = nodes.get(); curr != back - 1; ++curr)
+			(*curr)->next = *(curr + 1);
+		last = *(back - 1);
+		last->next = nullptr;
+		return nodes[0];
+	}
+
+	template<typename T, class Allocator, class SizePolicy>
+	inline void ForwardList<T, Allocator, SizePolicy>::splice_after(const_iterator pos, ForwardList & other)
 	{
 		if (this == &other) return;
 		splice_after(pos, other, other.before_begin());
 	}
 
-	template<typename T>
-	inline void ForwardList<T>::splice_after(const_iterator pos, ForwardList && other)
+	template<typename T, class Allocator, class SizePolicy>
+	inline void ForwardList<T, Allocator, SizePolicy>::splice_after(const_iterator pos, ForwardList && other)
 	{
 		splice_after(pos, other);
 	}
 
-	template<typename T>
-	inline void ForwardList<T>::splice_after(const_iterator pos, ForwardList & other, const_iterator first)
+	template<typename T, class Allocator, class SizePolicy>
+	inline void ForwardList<T, Allocator, SizePolicy>::splice_after(const_iterator pos, ForwardList & other, const_iterator first)
 	{
 		if (pos == first || pos == ++(const_iterator(first))) return;
 		splice_after(pos, other, first, other.cend());
 	}
 
-	template<typename T>
-	inline void ForwardList<T>::splice_after(const_iterator pos, ForwardList && other, const_iterator first)
+	template<typename T, class Allocator, class SizePolicy>
+	inline void ForwardList<T, Allocator, SizePolicy>::splice_after(const_iterator pos, ForwardList && other, const_iterator first)
 	{
 		splice_after(pos, other, first);
 	}
 
-	template<typename T>
-	inline void ForwardList<T>::splice_after(const_iterator pos, ForwardList & other, const_iterator first, const_iterator last)
+	template<typename T, class Allocator, class SizePolicy>
+	inline void ForwardList<T, Allocator, SizePolicy>::splice_after(const_iterator pos, ForwardList & other, const_iterator first, const_iterator last)
 	{
 		iterator _next(pos);
 		iterator _curr = _next++;
 		iterator _first(first);
 		iterator _last(last);
+		const bool after_last = _next.p == &tail;			//Spliced nodes become the last ones
+		const bool to_other_end = _last.p == &other.tail;	//other loses its last nodes
+		size_type n = 0;
 		_curr.p->next = _first.p->next;
-		while (_curr.p->next != _last.p) ++_curr;
+		while (_curr.p->next != _last.p)
+		{
+			++_curr;
+			++n;
+		}
 		_curr.p->next = _next.p;
 		_first.p->next = _last.p;
+		if (tracked)
+		{
+			other.tracking.add(-ptrdiff_t(n));
+			tracking.add(ptrdiff_t(n));
+			if (to_other_end)
+				other.tracking.set_last(_first.p == &other.head ? nullptr : _first.p);
+			if (after_last)
+				tracking.set_last(_curr.p == &head ? nullptr : _curr.p);
+		}
 	}
 
-	template<typename T>
-	inline void ForwardList<T>::splice_after(const_iterator pos, ForwardList && other, const_iterator first, const_iterator last)
+	template<typename T, class Allocator, class SizePolicy>
+	inline void ForwardList<T, Allocator, SizePolicy>::splice_after(const_iterator pos, ForwardList && other, const_iterator first, const_iterator last)
 	{
 		splice_after(pos, other, first, last);
 	}
 
-	template<typename T>
-	inline void ForwardList<T>::remove(const T & val)
+	template<typename T, class Allocator, class SizePolicy>
+	inline void ForwardList<T, Allocator, SizePolicy>::remove(const T & val)
 	{
 		remove_if([&val](const T& elem) { return std::equal_to<T>()(val, elem); });
 	}
 
-	template<typename T>
-	inline void ForwardList<T>::reverse() noexcept
+	template<typename T, class Allocator, class SizePolicy>
+	inline void ForwardList<T, Allocator, SizePolicy>::reverse() noexcept
 	{
 		if (empty()) return;
 		iterator curr = begin();
+		tracking.set_last(curr.p);
 		while (curr.p->next != end().p)
 			move_front(curr);
 	}
 
-	template<typename T>
-	inline void ForwardList<T>::unique()
+	template<typename T, class Allocator, class SizePolicy>
+	inline void ForwardList<T, Allocator, SizePolicy>::unique()
 	{
 		unique(std::equal_to<T>());
 	}
+
+	template<typename T, class Allocator, class SizePolicy>
+	inline void ForwardList<T, Allocator, SizePolicy>::sort()
+	{
+		sort(std::less<T>());
+	}
+
+	template<typename T, class Allocator, class SizePolicy>
+	template<typename Compare>
+	inline void ForwardList<T, Allocator, SizePolicy>::sort(Compare comp)
+	{
+		if (head.next == &tail || head.next->next == &tail) return;
+		size_type n = 0;
+		for (node_type* curr = head.next; curr != &tail; curr = curr->next) ++n;
+		node_type* last;
+		head.next = sort_chain(head.next, &tail, n, comp, last);
+		last->next = &tail;
+		tracking.set_last(last);
+	}
+
+	template<typename T, class Allocator, class SizePolicy>
+	inline void ForwardList<T, Allocator, SizePolicy>::parallel_sort()
+	{
+		parallel_sort(std::less<T>());
+	}
+
+	template<typename T, class Allocator, class SizePolicy>
+	template<typename Compare>
+	inline void ForwardList<T, Allocator, SizePolicy>::parallel_sort(Compare comp, size_type thread_count)
+	{
+		if (thread_count == 0)
+			thread_count = std::max<size_type>(std::thread::hardware_concurrency(), 1);
+		size_type n = size();
+		thread_count = std::min(thread_count, n / FORWARDLIST_PARALLEL_SORT_MIN);
+		if (thread_count < 2)
+		{
+			sort(comp);
+			return;
+		}
+
+		//The pieces are sorted in place without being cut apart, each ends where the next one starts
+		struct Chain
+		{
+			node_type* first;
+			const node_type* end;
+			node_type* last;
+			size_type count;
+		};
+		std::vector<Chain> chains(thread_count);
+		node_type* curr = head.next;
+		for (size_type i = 0; i < thread_count; i++)
+		{
+			chains[i].first = curr;
+			chains[i].count = n / thread_count + (i < n % thread_count);
+			for (size_type j = 0; j < chains[i].count; j++)
+				curr = curr->next;
+			chains[i].end = curr;
+		}
+
+		//Runs task(0) to task(count - 1) concurrently, task(0) on this thread and the others wherever a thread can be had
+		std::vector<std::thread> threads;
+		threads.reserve(thread_count);
+		auto run = [&threads](auto task, size_type count)
+		{
+			threads.clear();
+			for (size_type k = 1; k < count; k++)
+			{
+				try
+				{
+					threads.emplace_back(task, k);
+				}
+				catch (...)
+				{
+					task(k);
+				}
+			}
+			task(0);
+			for (std::thread& thread : threads)
+				thread.join();
+		};
+
+		run([&chains, &comp](size_type i)
+		{
+			chains[i].first = sort_chain(chains[i].first, chains[i].end, chains[i].count, comp, chains[i].last);
+		}, thread_count);
+
+		//Neighbours are merged, the left one first among equal elements, until one chain is left
+		for (size_type width = 1; width < thread_count; width *= 2)
+		{
+			run([&chains, &comp, width](size_type k)
+			{
+				Chain& a = chains[2 * width * k];
+				Chain& b = chains[2 * width * k + width];
+				node_type* last = comp(b.last->value, a.last->value) ? a.last : b.last;
+				a.first = merge_runs(a.first, b.first, nullptr, comp);
+				a.last = last;
+				a.count += b.count;
+			}, (thread_count + width - 1) / (2 * width));
+		}
+		head.next = chains[0].first;
+		chains[0].last->next = &tail;
+		tracking.set_last(chains[0].last);
+	}
+
+	template<typename T, class Allocator, class SizePolicy>
+	inline typename ForwardList<T, Allocator, SizePolicy>::size_type ForwardList<T, Allocator, SizePolicy>::size() const noexcept
+	{
+		if (tracked)
+			return tracking.count();
+		size_type n = 0;
+		for (const node_type* curr = head.next; curr != &tail; curr = curr->next)
+			++n;
+		return n;
+	}
+
+	template<typename T, class Allocator, class SizePolicy>
+	inline void ForwardList<T, Allocator, SizePolicy>::push_back(const T & val)
+	{
+		emplace_after(before_end(), val);
+	}
+
+	template<typename T, class Allocator, class SizePolicy>
+	inline void ForwardList<T, Allocator, SizePolicy>::push_back(T && val)
+	{
+		emplace_after(before_end(), std::move(val));
+	}
+
+	template<typename T, class Allocator, class SizePolicy>
+	template<typename ...Args>
+	inline void ForwardList<T, Allocator, SizePolicy>::emplace_back(Args && ...args)
+	{
+		emplace_after(before_end(), std::forward<Args>(args) ...);
+	}
+
+	template<typename T, class Allocator, class SizePolicy>
+	inline void ForwardList<T, Allocator, SizePolicy>::pop_back()
+	{
+		iterator prev = before_begin();
+		while (prev.p->next->next != &tail)
+			++prev;
+		erase_after(prev);
+	}
+
+	template<typename T, class Allocator, class SizePolicy>
+	inline typename ForwardList<T, Allocator, SizePolicy>::reference ForwardList<T, Allocator, SizePolicy>::back()
+	{
+		return *before_end();
+	}
+
+	template<typename T, class Allocator, class SizePolicy>
+	template<typename Function>
+	inline Function ForwardList<T, Allocator, SizePolicy>::for_each(Function f)
+	{
+		for (node_type* curr = head.next; curr != &tail; curr = curr->next)
+		{
+			_prefetch(curr->next);
+			f(curr->value);
+		}
+		return f;
+	}
+
+	template<typename T, class Allocator, class SizePolicy>
+	template<typename Function>
+	inline Function ForwardList<T, Allocator, SizePolicy>::for_each(Function f) const
+	{
+		for (const node_type* curr = head.next; curr != &tail; curr = curr->next)
+		{
+			_prefetch(curr->next);
+			f(curr->value);
+		}
+		return f;
+	}
+
+	template<typename T, class Allocator, class SizePolicy>
+	template<typename U>
+	inline U ForwardList<T, Allocator, SizePolicy>::accumulate(U init) const
+	{
+		return accumulate(std::move(init), [](U&& sum, const T& elem) { return std::move(sum) + elem; });
+	}
+
+	template<typename T, class Allocator, class SizePolicy>
+	template<typename U, typename BinaryOperation>
+	inline U ForwardList<T, Allocator, SizePolicy>::accumulate(U init, BinaryOperation op) const
+	{
+		for (const node_type* curr = head.next; curr != &tail; curr = curr->next)
+		{
+			_prefetch(curr->next);
+			init = op(std::move(init), curr->value);
+		}
+		return init;
+	}
+
+	template<typename T, class Allocator, class SizePolicy>
+	inline typename ForwardList<T, Allocator, SizePolicy>::iterator ForwardList<T, Allocator, SizePolicy>::find(const T & val)
+	{
+		return find_if([&val](const T& elem) { return std::equal_to<T>()(val, elem); });
+	}
+
+	template<typename T, class Allocator, class SizePolicy>
+	inline typename ForwardList<T, Allocator, SizePolicy>::const_iterator ForwardList<T, Allocator, SizePolicy>::find(const T & val) const
+	{
+		return find_if([&val](const T& elem) { return std::equal_to<T>()(val, elem); });
+	}
+
+	template<typename T, class Allocator, class SizePolicy>
+	template<typename UnaryPredicate>
+	inline typename ForwardList<T, Allocator, SizePolicy>::iterator ForwardList<T, Allocator, SizePolicy>::find_if(UnaryPredicate p)
+	{
+		node_type* curr = head.next;
+		for (; curr != &tail; curr = curr->next)
+		{
+			_prefetch(curr->next);
+			if (p(curr->value)) break;
+		}
+		return iterator(curr);
+	}
+
+	template<typename T, class Allocator, class SizePolicy>
+	template<typename UnaryPredicate>
+	inline typename ForwardList<T, Allocator, SizePolicy>::const_iterator ForwardList<T, Allocator, SizePolicy>::find_if(UnaryPredicate p) const
+	{
+		const node_type* curr = head.next;
+		for (; curr != &tail; curr = curr->next)
+		{
+			_prefetch(curr->next);
+			if (p(curr->value)) break;
+		}
+		return const_iterator(curr);
+	}
+
+	template<typename T, class Allocator, class SizePolicy>
+	inline void ForwardList<T, Allocator, SizePolicy>::destroy_values(T * values, size_type n) noexcept
+	{
+		for (size_type i = 0; i < n; i++)
+			values[i].~T();
+		::operator delete(values);
+	}
+
+	template<typename T, class Allocator, class SizePolicy>
+	inline void ForwardList<T, Allocator, SizePolicy>::compact()
+	{
+		//Prefetching hides one load at a time, but a list whose nodes were allocated in another order than they are
+		//linked misses the cache on every node. Instead of allocating new nodes, the values are moved out in list order
+		//and back in address order, and the nodes relinked in address order. A traversal then sweeps memory forwards,
+		//which the hardware prefetcher follows. Only the first pass chases pointers.
+		const size_type n = size();
+		if (n < 2) return;
+		std::unique_ptr<node_type*[]> nodes(new (std::nothrow) node_type*[n]);
+		T* values = static_cast<T*>(::operator new(n * sizeof(T), std::nothrow));
+		if (!nodes || !values)	//Nothing changes, compact() is only an optimization
+		{
+			::operator delete(values);
+			return;
+		}
+		size_type moved = 0;
+		try
+		{
+			for (node_type* curr = head.next; curr != &tail; curr = curr->next, ++moved)
+			{
+				_prefetch(curr->next);
+				nodes[moved] = curr;
+				::new (static_cast<void*>(values + moved)) T(std::move(curr->value));
+			}
+			std::sort(nodes.get(), nodes.get() + n, std::less<node_type*>());
+			for (size_type i = 0; i < n; i++)
+				nodes[i]->value = std::move(values[i]);
+		}
+		catch (...)
+		{
+			//The links are untouched, the list keeps its nodes in their old order
+			destroy_values(values, moved);
+			throw;
+		}
+		destroy_values(values, n);
+
+		//Every value is in place before the first link changes, and relinking cannot throw
+		node_type* prev = &head;
+		for (size_type i = 0; i < n; i++)
+			prev = prev->next = nodes[i];
+		prev->next = &tail;
+		tracking.set_last(prev);
+	}
 }
\ No newline at end of file
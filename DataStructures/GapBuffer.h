@@ -0,0 +1,608 @@
+#pragma once
+#include <stdexcept>
+#include <iterator>
+#include <utility>
+#include "BasicString.h"
+#include "SIMD.h"
+
+constexpr size_t GAP_BUFFER_MIN_GAP = 64U;	//Room left for insertions after the buffer grows
+
+namespace DataStructures
+{
+	template<typename CharT = char, typename Traits = std::char_traits<CharT>> class BasicGapBuffer;
+	using GapBuffer = BasicGapBuffer<char>;
+	using WGapBuffer = BasicGapBuffer<wchar_t>;
+
+	//Gap buffer: one array holding the text before the cursor at its front and the text after it at its back, with the free
+	//space in between. An edit first moves the gap to its position, copying only the characters between the old and the new
+	//position, then fills or widens the gap. Edits that stay near each other, as an editor's do, are O(1) amortized
+	//however large the text is. Reading is as with BasicString, each position is mapped around the gap.
+	template<typename CharT, typename Traits>
+	class BasicGapBuffer
+	{
+	public:
+		class GapBufferConstIterator;
+
+		using traits_type		= Traits;
+		using value_type		= CharT;
+		using size_type			= size_t;
+		using difference_type	= ptrdiff_t;
+		using reference			= CharT&;
+		using const_reference	= const CharT&;
+		using string_type		= BasicString<CharT, Traits>;
+
+		using const_iterator	= GapBufferConstIterator;
+		using iterator			= GapBufferConstIterator;	//Characters are changed through operator[]
+
+		static const size_type npos = -1;
+
+		//Constructor, Destructor and Assignment
+		BasicGapBuffer() noexcept;
+		BasicGapBuffer(size_type n, CharT ch);
+		BasicGapBuffer(const CharT* s, size_type n);
+		BasicGapBuffer(const CharT* s);
+		BasicGapBuffer(const string_type& str);
+		BasicGapBuffer(const BasicGapBuffer& origin);
+		BasicGapBuffer(BasicGapBuffer&& origin) noexcept;
+		~BasicGapBuffer();
+
+		BasicGapBuffer& operator=(const BasicGapBuffer& origin);
+		BasicGapBuffer& operator=(BasicGapBuffer&& origin) noexcept;
+
+		//Element access
+		reference at(size_type index);				//Check and throw out_of_range exception
+		const_reference at(size_type index) const;
+		reference operator[](size_type index);		//No check
+		const_reference operator[](size_type index) const;
+		reference front();
+		const_reference front() const;
+		reference back();
+		const_reference back() const;
+
+		//Iterators
+		const_iterator begin() const;
+		const_iterator cbegin() const;
+		const_iterator end() const;
+		const_iterator cend() const;
+
+		//Capacity
+		bool empty() const noexcept;
+		size_type size() const noexcept;
+		size_type length() const noexcept;
+		size_type capacity() const noexcept;
+		size_type gap_position() const noexcept;	//Where the last edit left the gap
+		void reserve(size_type n);
+		void shrink_to_fit();
+
+		//Modifiers
+		void clear() noexcept;
+		BasicGapBuffer& insert(size_type pos, const CharT* s, size_type n);
+		BasicGapBuffer& insert(size_type pos, const CharT* s);
+		BasicGapBuffer& insert(size_type pos, const string_type& str);
+		BasicGapBuffer& insert(size_type pos, size_type n, CharT ch);
+		BasicGapBuffer& erase(size_type pos = 0, size_type n = npos);
+		BasicGapBuffer& replace(size_type pos, size_type n, const CharT* s, size_type count);
+		BasicGapBuffer& append(const CharT* s, size_type n);
+		BasicGapBuffer& append(const CharT* s);
+		BasicGapBuffer& append(const string_type& str);
+		void push_back(CharT ch);
+		void pop_back();
+		void swap(BasicGapBuffer& other) noexcept;
+
+		//Operations
+		string_type substr(size_type pos = 0, size_type n = npos) const;
+		size_type copy(CharT* dest, size_type n, size_type pos = 0) const;
+		string_type flatten() const;				//Allocates the result only once
+		int compare(const BasicGapBuffer& other) const;
+		size_type find(const CharT* s, size_type pos, size_type count) const;
+		size_type find(const CharT* s, size_type pos = 0) const;
+		size_type find(const string_type& str, size_type pos = 0) const;
+		size_type find(CharT ch, size_type pos = 0) const;
+		template<typename Function> void for_each_chunk(Function f) const;	//Calls f(const CharT* chunk, size_type n) on both sides of the gap
+
+	private:
+		CharT* buffer = nullptr;
+		size_type buffer_size = 0;
+		size_type gap_begin = 0;
+		size_type gap_end = 0;						//Text after the gap occupies [gap_end, buffer_size)
+
+		//Helper functions
+		inline size_type _physical(size_type index) const noexcept;
+		inline void _move_gap(size_type pos) noexcept;
+		inline void _reallocate(size_type n);		//Capacity for n characters, the gap stays where it is
+		inline void _make_room(size_type pos, size_type n);	//Moves the gap to pos and widens it to at least n
+		inline bool _matches_at(size_type pos, const CharT* s, size_type count) const;
+
+	public:
+		class GapBufferConstIterator
+		{
+		public:
+			using self_type = GapBufferConstIterator;
+			using value_type = CharT;
+			using reference = const CharT&;
+			using pointer = const CharT*;
+			using difference_type = ptrdiff_t;
+			using iterator_category = std::random_access_iterator_tag;
+
+			GapBufferConstIterator() {}
+
+			reference operator*() const { return (*gap_buffer)[pos]; }
+			pointer operator->() const { return &(*gap_buffer)[pos]; }
+			reference operator[](difference_type n) const { return (*gap_buffer)[pos + n]; }
+			self_type& operator++() { ++pos; return *this; }
+			self_type operator++(int) { self_type ret(*this); ++pos; return ret; }
+			self_type& operator--() { --pos; return *this; }
+			self_type operator--(int) { self_type ret(*this); --pos; return ret; }
+			self_type& operator+=(difference_type n) { pos += n; return *this; }
+			self_type& operator-=(difference_type n) { pos -= n; return *this; }
+			self_type operator+(difference_type n) const { return self_type(gap_buffer, pos + n); }
+			self_type operator-(difference_type n) const { return self_type(gap_buffer, pos - n); }
+			difference_type operator-(const self_type& rhs) const { return difference_type(pos - rhs.pos); }
+			bool operator==(const self_type& rhs) const { return pos == rhs.pos; }
+			bool operator!=(const self_type& rhs) const { return pos != rhs.pos; }
+			bool operator<(const self_type& rhs) const { return pos < rhs.pos; }
+			bool operator<=(const self_type& rhs) const { return pos <= rhs.pos; }
+			bool operator>(const self_type& rhs) const { return pos > rhs.pos; }
+			bool operator>=(const self_type& rhs) const { return pos >= rhs.pos; }
+
+		private:
+			GapBufferConstIterator(const BasicGapBuffer* _gap_buffer, size_type _pos) : gap_buffer(_gap_buffer), pos(_pos) {}
+
+		private:
+			friend class BasicGapBuffer;
+			const BasicGapBuffer* gap_buffer = nullptr;
+			size_type pos = 0;
+		};
+	};
+
+	/* Dividing Line ( 㧥 ;) ( 㧥 ;) ( 㧥 ;)  */
+
+	template<typename CharT, typename Traits>
+	inline BasicGapBuffer<CharT, Traits>::BasicGapBuffer() noexcept
+	{
+	}
+
+	template<typename CharT, typename Traits>
+	inline BasicGapBuffer<CharT, Traits>::BasicGapBuffer(size_type n, CharT ch)
+	{
+		insert(0, n, ch);
+	}
+
+	template<typename CharT, typename Traits>
+	inline BasicGapBuffer<CharT, Traits>::BasicGapBuffer(const CharT * s, size_type n)
+	{
+		insert(0, s, n);
+	}
+
+	template<typename CharT, typename Traits>
+	inline BasicGapBuffer<CharT, Traits>::BasicGapBuffer(const CharT * s)
+	{
+		insert(0, s, Traits::length(s));
+	}
+
+	template<typename CharT, typename Traits>
+	inline BasicGapBuffer<CharT, Traits>::BasicGapBuffer(const string_type & str)
+	{
+		insert(0, str.data(), str.size());
+	}
+
+	template<typename CharT, typename Traits>
+	inline BasicGapBuffer<CharT, Traits>::BasicGapBuffer(const BasicGapBuffer & origin)
+	{
+		reserve(origin.size());
+		origin.for_each_chunk([this](const CharT* chunk, size_type n) { append(chunk, n); });
+	}
+
+	template<typename CharT, typename Traits>
+	inline BasicGapBuffer<CharT, Traits>::BasicGapBuffer(BasicGapBuffer && origin) noexcept
+	{
+		swap(origin);
+	}
+
+	template<typename CharT, typename Traits>
+	inline BasicGapBuffer<CharT, Traits>::~BasicGapBuffer()
+	{
+		delete[] buffer;
+	}
+
+	template<typename CharT, typename Traits>
+	inline BasicGapBuffer<CharT, Traits> & BasicGapBuffer<CharT, Traits>::operator=(const BasicGapBuffer & origin)
+	{
+		BasicGapBuffer temp(origin);
+		swap(temp);
+		return *this;
+	}
+
+	template<typename CharT, typename Traits>
+	inline BasicGapBuffer<CharT, Traits> & BasicGapBuffer<CharT, Traits>::operator=(BasicGapBuffer && origin) noexcept
+	{
+		swap(origin);
+		return *this;
+	}
+
+	template<typename CharT, typename Traits>
+	inline typename BasicGapBuffer<CharT, Traits>::size_type BasicGapBuffer<CharT, Traits>::_physical(size_type index) const noexcept
+	{
+		return index < gap_begin ? index : index + (gap_end - gap_begin);
+	}
+
+	template<typename CharT, typename Traits>
+	inline void BasicGapBuffer<CharT, Traits>::_move_gap(size_type pos) noexcept
+	{
+		if (pos < gap_begin)
+		{
+			size_type n = gap_begin - pos;
+			Traits::move(buffer + gap_end - n, buffer + pos, n);
+			gap_begin -= n;
+			gap_end -= n;
+		}
+		else if (pos > gap_begin)
+		{
+			size_type n = pos - gap_begin;
+			Traits::move(buffer + gap_begin, buffer + gap_end, n);
+			gap_begin += n;
+			gap_end += n;
+		}
+	}
+
+	template<typename CharT, typename Traits>
+	inline void BasicGapBuffer<CharT, Traits>::_reallocate(size_type n)
+	{
+		size_type after = buffer_size - gap_end;
+		CharT* grown = new CharT[n];
+		if (buffer)
+		{
+			Traits::copy(grown, buffer, gap_begin);
+			Traits::copy(grown + n - after, buffer + gap_end, after);
+		}
+		delete[] buffer;
+		buffer = grown;
+		buffer_size = n;
+		gap_end = n - after;
+	}
+
+	template<typename CharT, typename Traits>
+	inline void BasicGapBuffer<CharT, Traits>::_make_room(size_type pos, size_type n)
+	{
+		if (pos > size())
+			throw std::out_of_range{ "Accessed position is out of range!" };
+		if (gap_end - gap_begin < n)
+		{
+			size_type needed = size() + n + GAP_BUFFER_MIN_GAP;
+			_reallocate(needed > buffer_size * 2 ? needed : buffer_size * 2);
+		}
+		_move_gap(pos);
+	}
+
+	template<typename CharT, typename Traits>
+	inline typename BasicGapBuffer<CharT, Traits>::reference BasicGapBuffer<CharT, Traits>::at(size_type index)
+	{
+		if (index < size())
+			return (*this)[index];
+		throw std::out_of_range{ "Accessed position is out of range!" };
+	}
+
+	template<typename CharT, typename Traits>
+	inline typename BasicGapBuffer<CharT, Traits>::const_reference BasicGapBuffer<CharT, Traits>::at(size_type index) const
+	{
+		if (index < size())
+			return (*this)[index];
+		throw std::out_of_range{ "Accessed position is out of range!" };
+	}
+
+	template<typename CharT, typename Traits>
+	inline typename BasicGapBuffer<CharT, Traits>::reference BasicGapBuffer<CharT, Traits>::operator[](size_type index)
+	{
+		return buffer[_physical(index)];
+	}
+
+	template<typename CharT, typename Traits>
+	inline typename BasicGapBuffer<CharT, Traits>::const_reference BasicGapBuffer<CharT, Traits>::operator[](size_type index) const
+	{
+		return buffer[_physical(index)];
+	}
+
+	template<typename CharT, typename Traits>
+	inline typename BasicGapBuffer<CharT, Traits>::reference BasicGapBuffer<CharT, Traits>::front()
+	{
+		return (*this)[0];
+	}
+
+	template<typename CharT, typename Traits>
+	inline typename BasicGapBuffer<CharT, Traits>::const_reference BasicGapBuffer<CharT, Traits>::front() const
+	{
+		return (*this)[0];
+	}
+
+	template<typename CharT, typename Traits>
+	inline typename BasicGapBuffer<CharT, Traits>::reference BasicGapBuffer<CharT, Traits>::back()
+	{
+		return (*this)[size() - 1];
+	}
+
+	template<typename CharT, typename Traits>
+	inline typename BasicGapBuffer<CharT, Traits>::const_reference BasicGapBuffer<CharT, Traits>::back() const
+	{
+		return (*this)[size() - 1];
+	}
+
+	template<typename CharT, typename Traits>
+	inline typename BasicGapBuffer<CharT, Traits>::const_iterator BasicGapBuffer<CharT, Traits>::begin() const
+	{
+		return const_iterator(this, 0);
+	}
+
+	template<typename CharT, typename Traits>
+	inline typename BasicGapBuffer<CharT, Traits>::const_iterator BasicGapBuffer<CharT, Traits>::cbegin() const
+	{
+		return begin();
+	}
+
+	template<typename CharT, typename Traits>
+	inline typename BasicGapBuffer<CharT, Traits>::const_iterator BasicGapBuffer<CharT, Traits>::end() const
+	{
+		return const_iterator(this, size());
+	}
+
+	template<typename CharT, typename Traits>
+	inline typename BasicGapBuffer<CharT, Traits>::const_iterator BasicGapBuffer<CharT, Traits>::cend() const
+	{
+		return end();
+	}
+
+	template<typename CharT, typename Traits>
+	inline bool BasicGapBuffer<CharT, Traits>::empty() const noexcept
+	{
+		return size() == 0;
+	}
+
+	template<typename CharT, typename Traits>
+	inline typename BasicGapBuffer<CharT, Traits>::size_type BasicGapBuffer<CharT, Traits>::size() const noexcept
+	{
+		return buffer_size - (gap_end - gap_begin);
+	}
+
+	template<typename CharT, typename Traits>
+	inline typename BasicGapBuffer<CharT, Traits>::size_type BasicGapBuffer<CharT, Traits>::length() const noexcept
+	{
+		return size();
+	}
+
+	template<typename CharT, typename Traits>
+	inline typename BasicGapBuffer<CharT, Traits>::size_type BasicGapBuffer<CharT, Traits>::capacity() const noexcept
+	{
+		return buffer_size;
+	}
+
+	template<typename CharT, typename Traits>
+	inline typename BasicGapBuffer<CharT, Traits>::size_type BasicGapBuffer<CharT, Traits>::gap_position() const noexcept
+	{
+		return gap_begin;
+	}
+
+	template<typename CharT, typename Traits>
+	inline void BasicGapBuffer<CharT, Traits>::reserve(size_type n)
+	{
+		if (n > buffer_size)
+			_reallocate(n);
+	}
+
+	template<typename CharT, typename Traits>
+	inline void BasicGapBuffer<CharT, Traits>::shrink_to_fit()
+	{
+		if (empty())
+		{
+			clear();
+			delete[] buffer;
+			buffer = nullptr;
+			buffer_size = gap_begin = gap_end = 0;
+		}
+		else if (size() < buffer_size)
+			_reallocate(size());
+	}
+
+	template<typename CharT, typename Traits>
+	inline void BasicGapBuffer<CharT, Traits>::clear() noexcept
+	{
+		gap_begin = 0;
+		gap_end = buffer_size;
+	}
+
+	template<typename CharT, typename Traits>
+	inline BasicGapBuffer<CharT, Traits> & BasicGapBuffer<CharT, Traits>::insert(size_type pos, const CharT * s, size_type n)
+	{
+		if (n == 0)
+		{
+			if (pos > size())
+				throw std::out_of_range{ "Accessed position is out of range!" };
+			return *this;
+		}
+		if (s >= buffer && s < buffer + buffer_size)	//s points into *this, which may be moved by reallocation or by the gap
+			return insert(pos, string_type(s, n));
+		_make_room(pos, n);
+		Traits::copy(buffer + gap_begin, s, n);
+		gap_begin += n;
+		return *this;
+	}
+
+	template<typename CharT, typename Traits>
+	inline BasicGapBuffer<CharT, Traits> & BasicGapBuffer<CharT, Traits>::insert(size_type pos, const CharT * s)
+	{
+		return insert(pos, s, Traits::length(s));
+	}
+
+	template<typename CharT, typename Traits>
+	inline BasicGapBuffer<CharT, Traits> & BasicGapBuffer<CharT, Traits>::insert(size_type pos, const string_type & str)
+	{
+		return insert(pos, str.data(), str.size());
+	}
+
+	template<typename CharT, typename Traits>
+	inline BasicGapBuffer<CharT, Traits> & BasicGapBuffer<CharT, Traits>::insert(size_type pos, size_type n, CharT ch)
+	{
+		_make_room(pos, n);
+		Traits::assign(buffer + gap_begin, n, ch);
+		gap_begin += n;
+		return *this;
+	}
+
+	template<typename CharT, typename Traits>
+	inline BasicGapBuffer<CharT, Traits> & BasicGapBuffer<CharT, Traits>::erase(size_type pos, size_type n)
+	{
+		if (pos > size())
+			throw std::out_of_range{ "Accessed position is out of range!" };
+		if (n > size() - pos)
+			n = size() - pos;
+		_move_gap(pos);
+		gap_end += n;
+		return *this;
+	}
+
+	template<typename CharT, typename Traits>
+	inline BasicGapBuffer<CharT, Traits> & BasicGapBuffer<CharT, Traits>::replace(size_type pos, size_type n, const CharT * s, size_type count)
+	{
+		if (s >= buffer && s < buffer + buffer_size)
+			return replace(pos, n, string_type(s, count).data(), count);
+		erase(pos, n);
+		return insert(pos, s, count);
+	}
+
+	template<typename CharT, typename Traits>
+	inline BasicGapBuffer<CharT, Traits> & BasicGapBuffer<CharT, Traits>::append(const CharT * s, size_type n)
+	{
+		return insert(size(), s, n);
+	}
+
+	template<typename CharT, typename Traits>
+	inline BasicGapBuffer<CharT, Traits> & BasicGapBuffer<CharT, Traits>::append(const CharT * s)
+	{
+		return insert(size(), s, Traits::length(s));
+	}
+
+	template<typename CharT, typename Traits>
+	inline BasicGapBuffer<CharT, Traits> & BasicGapBuffer<CharT, Traits>::append(const string_type & str)
+	{
+		return insert(size(), str.data(), str.size());
+	}
+
+	template<typename CharT, typename Traits>
+	inline void BasicGapBuffer<CharT, Traits>::push_back(CharT ch)
+	{
+		insert(size(), 1, ch);
+	}
+
+	template<typename CharT, typename Traits>
+	inline void BasicGapBuffer<CharT, Traits>::pop_back()
+	{
+		erase(size() - 1, 1);
+	}
+
+	template<typename CharT, typename Traits>
+	inline void BasicGapBuffer<CharT, Traits>::swap(BasicGapBuffer & other) noexcept
+	{
+		std::swap(buffer, other.buffer);
+		std::swap(buffer_size, other.buffer_size);
+		std::swap(gap_begin, other.gap_begin);
+		std::swap(gap_end, other.gap_end);
+	}
+
+	template<typename CharT, typename Traits>
+	inline typename BasicGapBuffer<CharT, Traits>::string_type BasicGapBuffer<CharT, Traits>::substr(size_type pos, size_type n) const
+	{
+		if (pos > size())
+			throw std::out_of_range{ "Accessed position is out of range!" };
+		string_type ret(n < size() - pos ? n : size() - pos, CharT());
+		copy(ret.data(), ret.size(), pos);
+		return ret;
+	}
+
+	template<typename CharT, typename Traits>
+	inline typename BasicGapBuffer<CharT, Traits>::size_type BasicGapBuffer<CharT, Traits>::copy(CharT * dest, size_type n, size_type pos) const
+	{
+		if (pos > size())
+			throw std::out_of_range{ "Accessed position is out of range!" };
+		size_type count = n < size() - pos ? n : size() - pos;
+		size_type before = pos < gap_begin ? (count < gap_begin - pos ? count : gap_begin - pos) : 0;
+		Traits::copy(dest, buffer + pos, before);
+		Traits::copy(dest + before, buffer + _physical(pos + before), count - before);
+		return count;
+	}
+
+	template<typename CharT, typename Traits>
+	inline typename BasicGapBuffer<CharT, Traits>::string_type BasicGapBuffer<CharT, Traits>::flatten() const
+	{
+		return substr();
+	}
+
+	template<typename CharT, typename Traits>
+	inline int BasicGapBuffer<CharT, Traits>::compare(const BasicGapBuffer & other) const
+	{
+		size_type n = size() < other.size() ? size() : other.size();
+		for (size_type i = 0; i < n; i++)
+		{
+			if (Traits::lt((*this)[i], other[i])) return -1;
+			if (Traits::lt(other[i], (*this)[i])) return 1;
+		}
+		return size() < other.size() ? -1 : size() > other.size() ? 1 : 0;
+	}
+
+	template<typename CharT, typename Traits>
+	inline bool BasicGapBuffer<CharT, Traits>::_matches_at(size_type pos, const CharT * s, size_type count) const
+	{
+		for (size_type i = 0; i < count; i++)
+			if (!Traits::eq((*this)[pos + i], s[i])) return false;
+		return true;
+	}
+
+	template<typename CharT, typename Traits>
+	inline typename BasicGapBuffer<CharT, Traits>::size_type BasicGapBuffer<CharT, Traits>::find(const CharT * s, size_type pos, size_type count) const
+	{
+		if (count == 0) return pos <= size() ? pos : npos;
+		if (count > size() || pos > size() - count) return npos;
+		const size_type stop = size() - count + 1;		//A match starts in [pos, stop)
+		//Each side of the gap is searched in place: candidates from the first character, checked across the gap if they reach it
+		const CharT* sides[2] = { buffer, buffer + gap_end };
+		const size_type side_begin[2] = { 0, gap_begin };
+		const size_type side_end[2] = { gap_begin, size() };
+		for (int side = 0; side < 2; side++)
+		{
+			size_type first = pos > side_begin[side] ? pos : side_begin[side];
+			size_type last = stop < side_end[side] ? stop : side_end[side];
+			const CharT* base = sides[side] - side_begin[side];
+			for (size_type i = first; i < last; i++)
+			{
+				i = size_type(_find_char(base + i, base + last, s[0]) - base);
+				if (i == last) break;
+				if (i + count <= side_end[side] ? Traits::compare(base + i + 1, s + 1, count - 1) == 0 : _matches_at(i + 1, s + 1, count - 1))
+					return i;
+			}
+		}
+		return npos;
+	}
+
+	template<typename CharT, typename Traits>
+	inline typename BasicGapBuffer<CharT, Traits>::size_type BasicGapBuffer<CharT, Traits>::find(const CharT * s, size_type pos) const
+	{
+		return find(s, pos, Traits::length(s));
+	}
+
+	template<typename CharT, typename Traits>
+	inline typename BasicGapBuffer<CharT, Traits>::size_type BasicGapBuffer<CharT, Traits>::find(const string_type & str, size_type pos) const
+	{
+		return find(str.data(), pos, str.size());
+	}
+
+	template<typename CharT, typename Traits>
+	inline typename BasicGapBuffer<CharT, Traits>::size_type BasicGapBuffer<CharT, Traits>::find(CharT ch, size_type pos) const
+	{
+		return find(&ch, pos, 1);
+	}
+
+	template<typename CharT, typename Traits>
+	template<typename Function>
+	inline void BasicGapBuffer<CharT, Traits>::for_each_chunk(Function f) const
+	{
+		if (gap_begin) f(static_cast<const CharT*>(buffer), gap_begin);
+		if (gap_end < buffer_size) f(static_cast<const CharT*>(buffer + gap_end), buffer_size - gap_end);
+	}
+}
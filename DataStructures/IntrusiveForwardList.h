@@ -0,0 +1,605 @@
+#pragma once
+#include <stdexcept>
+#include <iterator>
+#include <functional>
+#include "ForwardList.h"
+
+namespace DataStructures
+{
+	//The link an object carries to be put into an IntrusiveForwardList. Copying an object does not copy its link,
+	//the copy is not in any list. An object can be in one list per hook member at a time.
+	struct IntrusiveForwardListHook
+	{
+		IntrusiveForwardListHook* next = nullptr;
+
+		IntrusiveForwardListHook() noexcept {}
+		IntrusiveForwardListHook(const IntrusiveForwardListHook&) noexcept {}
+		IntrusiveForwardListHook& operator=(const IntrusiveForwardListHook&) noexcept { return *this; }
+	};
+
+	//Singly linked list of objects that already live somewhere else, e.g. in a pool, linked through their Hook member.
+	//Inserting and erasing link and unlink the objects in place: nothing is copied and nothing is allocated, and the
+	//list never destroys an object. An object must outlive its membership, erase it before it goes away.
+	//The interface follows ForwardList with T& in place of values, including the SizePolicy. The list ends at null
+	//rather than at a tail node, so moving and swapping lists never relinks an object.
+	template<typename T, IntrusiveForwardListHook T::* Hook, class SizePolicy = UntrackedSize>
+	class IntrusiveForwardList
+	{
+	private:
+		class IntrusiveForwardListIterator;
+		class IntrusiveForwardListConstIterator;
+
+	public:
+		using value_type		= T;
+		using reference			= T&;
+		using const_reference	= const T&;
+		using pointer			= T*;
+		using const_pointer		= const T*;
+		using difference_type	= ptrdiff_t;
+		using size_type			= size_t;
+		using hook_type			= IntrusiveForwardListHook;
+
+		using iterator			= IntrusiveForwardListIterator;
+		using const_iterator	= IntrusiveForwardListConstIterator;
+
+		//Constructor, Destructor and Assignment
+		IntrusiveForwardList() noexcept;
+
+		template<typename InputIterator, typename = typename std::enable_if_t<std::_Is_iterator<InputIterator>::value>>
+		IntrusiveForwardList(InputIterator first, InputIterator last);	//Links *first ... in order, they must be T&
+
+		IntrusiveForwardList(const IntrusiveForwardList& origin) = delete;
+		IntrusiveForwardList(IntrusiveForwardList&& origin) noexcept;
+		~IntrusiveForwardList();
+		IntrusiveForwardList& operator=(const IntrusiveForwardList& origin) = delete;
+		IntrusiveForwardList& operator=(IntrusiveForwardList&& origin) noexcept;
+
+		//Element access
+		reference front();
+		const_reference front() const;
+		reference back();			//O(1) with TrackedSize, otherwise O(n)
+		const_reference back() const;
+
+		//Iterators
+		iterator begin() noexcept;
+		const_iterator begin() const noexcept;
+		const_iterator cbegin() const noexcept;
+		iterator end() noexcept;
+		const_iterator end() const noexcept;
+		const_iterator cend() const noexcept;
+		iterator before_begin() noexcept;
+		const_iterator before_begin() const noexcept;
+		const_iterator cbefore_begin() const noexcept;
+		iterator before_end() noexcept;	//O(1) with TrackedSize, otherwise O(n)
+		const_iterator before_end() const noexcept;
+		const_iterator cbefore_end() const noexcept;
+		iterator iterator_to(T& obj) noexcept;	//obj must be in this list
+		const_iterator iterator_to(const T& obj) const noexcept;
+
+		//Capacity
+		bool empty() const noexcept;
+		size_type size() const noexcept;	//O(1) with TrackedSize, otherwise traverses the list
+
+		//Modifiers
+		void clear() noexcept;				//Unlinks all objects
+		iterator insert_after(const_iterator pos, T& obj);
+		iterator erase_after(const_iterator pos);	//Unlinks the object after pos
+		iterator erase_after(const_iterator first, const_iterator last);
+		void push_front(T& obj);
+		void pop_front();
+		void push_back(T& obj);			//O(1) with TrackedSize, otherwise O(n)
+		void swap(IntrusiveForwardList& other) noexcept;
+
+		//Operations
+		void merge(IntrusiveForwardList& other);
+		template<typename Compare> void merge(IntrusiveForwardList& other, Compare comp);
+		void splice_after(const_iterator pos, IntrusiveForwardList& other);
+		void splice_after(const_iterator pos, IntrusiveForwardList& other, const_iterator first);
+		void splice_after(const_iterator pos, IntrusiveForwardList& other, const_iterator first, const_iterator last);
+		void remove(const T& val);	//Unlink all objects equal to val
+		template<typename UnaryPredicate> void remove_if(UnaryPredicate p);
+		void reverse() noexcept;
+		void sort();	//Stable, O(n log n), no allocation
+		template<typename Compare> void sort(Compare comp);
+
+	private:
+		static constexpr bool tracked = _ForwardListTracking<SizePolicy, hook_type>::enabled;
+		_ForwardListTracking<SizePolicy, hook_type> tracking;
+		hook_type head;				//before_begin(), the last hook links to null
+
+		//Helper functions
+		static T* _owner(const hook_type* hook) noexcept;	//The object the hook is a member of
+		template<typename Compare> static hook_type* _merge_runs(hook_type* a, hook_type* b, Compare& comp);
+		template<typename Compare> void _sort_runs(Compare& comp);
+
+		class IntrusiveForwardListIterator
+		{
+		public:
+			using self_type = IntrusiveForwardListIterator;
+			using value_type = T;
+			using reference = T&;
+			using pointer = T*;
+			using difference_type = ptrdiff_t;
+			using iterator_category = std::forward_iterator_tag;
+
+			IntrusiveForwardListIterator() {}
+
+			self_type& operator++() { p = p->next; return *this; }
+			self_type operator++(int) { self_type ret(*this); ++*this; return ret; }
+			bool operator==(const self_type& rhs) const { return p == rhs.p; }
+			bool operator!=(const self_type& rhs) const { return p != rhs.p; }
+			reference operator*() const { return *_owner(p); }
+			pointer operator->() const { return _owner(p); }
+
+		private:
+			IntrusiveForwardListIterator(hook_type* _p) : p(_p) {}
+			IntrusiveForwardListIterator(const IntrusiveForwardListConstIterator& origin) : p(const_cast<hook_type*>(origin.p)) {}
+
+		private:
+			friend class IntrusiveForwardList;
+			friend class IntrusiveForwardListConstIterator;
+			hook_type* p = nullptr;
+		};
+
+		class IntrusiveForwardListConstIterator
+		{
+		public:
+			using self_type = IntrusiveForwardListConstIterator;
+			using value_type = T;
+			using reference = const T&;
+			using pointer = const T*;
+			using difference_type = ptrdiff_t;
+			using iterator_category = std::forward_iterator_tag;
+
+			IntrusiveForwardListConstIterator() {}
+			IntrusiveForwardListConstIterator(const IntrusiveForwardListIterator& origin) : p(origin.p) {}
+
+			self_type& operator++() { p = p->next; return *this; }
+			self_type operator++(int) { self_type ret(*this); ++*this; return ret; }
+			bool operator==(const self_type& rhs) const { return p == rhs.p; }
+			bool operator!=(const self_type& rhs) const { return p != rhs.p; }
+			reference operator*() const { return *_owner(p); }
+			pointer operator->() const { return _owner(p); }
+
+		private:
+			IntrusiveForwardListConstIterator(const hook_type* _p) : p(_p) {}
+
+		private:
+			friend class IntrusiveForwardList;
+			friend class IntrusiveForwardListIterator;
+			const hook_type* p = nullptr;
+		};
+	};
+
+	/* Dividing Line ( 㧥 ;) ( 㧥 ;) ( 㧥 ;)  */
+
+	template<typename T, IntrusiveForwardListHook T::* Hook, class SizePolicy>
+	inline IntrusiveForwardList<T, Hook, SizePolicy>::IntrusiveForwardList() noexcept
+	{
+	}
+
+	template<typename T, IntrusiveForwardListHook T::* Hook, class SizePolicy>
+	template<typename InputIterator, typename SFINAE_MAGIC>
+	inline IntrusiveForwardList<T, Hook, SizePolicy>::IntrusiveForwardList(InputIterator first, InputIterator last)
+	{
+		hook_type* tail = &head;
+		size_type n = 0;
+		for (; first != last; ++first, ++n)
+		{
+			tail->next = &((*first).*Hook);
+			tail = tail->next;
+		}
+		tail->next = nullptr;
+		tracking.set(n, tail == &head ? nullptr : tail);
+	}
+
+	template<typename T, IntrusiveForwardListHook T::* Hook, class SizePolicy>
+	inline IntrusiveForwardList<T, Hook, SizePolicy>::IntrusiveForwardList(IntrusiveForwardList && origin) noexcept
+	{
+		swap(origin);
+	}
+
+	template<typename T, IntrusiveForwardListHook T::* Hook, class SizePolicy>
+	inline IntrusiveForwardList<T, Hook, SizePolicy>::~IntrusiveForwardList()
+	{
+	}
+
+	template<typename T, IntrusiveForwardListHook T::* Hook, class SizePolicy>
+	inline IntrusiveForwardList<T, Hook, SizePolicy> & IntrusiveForwardList<T, Hook, SizePolicy>::operator=(IntrusiveForwardList && origin) noexcept
+	{
+		clear();
+		swap(origin);
+		return *this;
+	}
+
+	template<typename T, IntrusiveForwardListHook T::* Hook, class SizePolicy>
+	inline typename IntrusiveForwardList<T, Hook, SizePolicy>::reference IntrusiveForwardList<T, Hook, SizePolicy>::front()
+	{
+		return *_owner(head.next);
+	}
+
+	template<typename T, IntrusiveForwardListHook T::* Hook, class SizePolicy>
+	inline typename IntrusiveForwardList<T, Hook, SizePolicy>::const_reference IntrusiveForwardList<T, Hook, SizePolicy>::front() const
+	{
+		return *_owner(head.next);
+	}
+
+	template<typename T, IntrusiveForwardListHook T::* Hook, class SizePolicy>
+	inline typename IntrusiveForwardList<T, Hook, SizePolicy>::reference IntrusiveForwardList<T, Hook, SizePolicy>::back()
+	{
+		return *before_end();
+	}
+
+	template<typename T, IntrusiveForwardListHook T::* Hook, class SizePolicy>
+	inline typename IntrusiveForwardList<T, Hook, SizePolicy>::const_reference IntrusiveForwardList<T, Hook, SizePolicy>::back() const
+	{
+		return *before_end();
+	}
+
+	template<typename T, IntrusiveForwardListHook T::* Hook, class SizePolicy>
+	inline typename IntrusiveForwardList<T, Hook, SizePolicy>::iterator IntrusiveForwardList<T, Hook, SizePolicy>::begin() noexcept
+	{
+		return iterator(head.next);
+	}
+
+	template<typename T, IntrusiveForwardListHook T::* Hook, class SizePolicy>
+	inline typename IntrusiveForwardList<T, Hook, SizePolicy>::const_iterator IntrusiveForwardList<T, Hook, SizePolicy>::begin() const noexcept
+	{
+		return const_iterator(head.next);
+	}
+
+	template<typename T, IntrusiveForwardListHook T::* Hook, class SizePolicy>
+	inline typename IntrusiveForwardList<T, Hook, SizePolicy>::const_iterator IntrusiveForwardList<T, Hook, SizePolicy>::cbegin() const noexcept
+	{
+		return const_iterator(head.next);
+	}
+
+	template<typename T, IntrusiveForwardListHook T::* Hook, class SizePolicy>
+	inline typename IntrusiveForwardList<T, Hook, SizePolicy>::iterator IntrusiveForwardList<T, Hook, SizePolicy>::end() noexcept
+	{
+		return iterator(nullptr);
+	}
+
+	template<typename T, IntrusiveForwardListHook T::* Hook, class SizePolicy>
+	inline typename IntrusiveForwardList<T, Hook, SizePolicy>::const_iterator IntrusiveForwardList<T, Hook, SizePolicy>::end() const noexcept
+	{
+		return const_iterator(nullptr);
+	}
+
+	template<typename T, IntrusiveForwardListHook T::* Hook, class SizePolicy>
+	inline typename IntrusiveForwardList<T, Hook, SizePolicy>::const_iterator IntrusiveForwardList<T, Hook, SizePolicy>::cend() const noexcept
+	{
+		return const_iterator(nullptr);
+	}
+
+	template<typename T, IntrusiveForwardListHook T::* Hook, class SizePolicy>
+	inline typename IntrusiveForwardList<T, Hook, SizePolicy>::iterator IntrusiveForwardList<T, Hook, SizePolicy>::before_begin() noexcept
+	{
+		return iterator(&head);
+	}
+
+	template<typename T, IntrusiveForwardListHook T::* Hook, class SizePolicy>
+	inline typename IntrusiveForwardList<T, Hook, SizePolicy>::const_iterator IntrusiveForwardList<T, Hook, SizePolicy>::before_begin() const noexcept
+	{
+		return const_iterator(&head);
+	}
+
+	template<typename T, IntrusiveForwardListHook T::* Hook, class SizePolicy>
+	inline typename IntrusiveForwardList<T, Hook, SizePolicy>::const_iterator IntrusiveForwardList<T, Hook, SizePolicy>::cbefore_begin() const noexcept
+	{
+		return const_iterator(&head);
+	}
+
+	template<typename T, IntrusiveForwardListHook T::* Hook, class SizePolicy>
+	inline typename IntrusiveForwardList<T, Hook, SizePolicy>::iterator IntrusiveForwardList<T, Hook, SizePolicy>::before_end() noexcept
+	{
+		if (tracked)
+			return iterator(head.next ? tracking.last() : &head);
+		hook_type* curr = &head;
+		while (curr->next)
+			curr = curr->next;
+		return iterator(curr);
+	}
+
+	template<typename T, IntrusiveForwardListHook T::* Hook, class SizePolicy>
+	inline typename IntrusiveForwardList<T, Hook, SizePolicy>::const_iterator IntrusiveForwardList<T, Hook, SizePolicy>::before_end() const noexcept
+	{
+		return const_cast<IntrusiveForwardList*>(this)->before_end();
+	}
+
+	template<typename T, IntrusiveForwardListHook T::* Hook, class SizePolicy>
+	inline typename IntrusiveForwardList<T, Hook, SizePolicy>::const_iterator IntrusiveForwardList<T, Hook, SizePolicy>::cbefore_end() const noexcept
+	{
+		return before_end();
+	}
+
+	template<typename T, IntrusiveForwardListHook T::* Hook, class SizePolicy>
+	inline typename IntrusiveForwardList<T, Hook, SizePolicy>::iterator IntrusiveForwardList<T, Hook, SizePolicy>::iterator_to(T & obj) noexcept
+	{
+		return iterator(&(obj.*Hook));
+	}
+
+	template<typename T, IntrusiveForwardListHook T::* Hook, class SizePolicy>
+	inline typename IntrusiveForwardList<T, Hook, SizePolicy>::const_iterator IntrusiveForwardList<T, Hook, SizePolicy>::iterator_to(const T & obj) const noexcept
+	{
+		return const_iterator(&(obj.*Hook));
+	}
+
+	template<typename T, IntrusiveForwardListHook T::* Hook, class SizePolicy>
+	inline bool IntrusiveForwardList<T, Hook, SizePolicy>::empty() const noexcept
+	{
+		return head.next == nullptr;
+	}
+
+	template<typename T, IntrusiveForwardListHook T::* Hook, class SizePolicy>
+	inline typename IntrusiveForwardList<T, Hook, SizePolicy>::size_type IntrusiveForwardList<T, Hook, SizePolicy>::size() const noexcept
+	{
+		if (tracked)
+			return tracking.count();
+		size_type n = 0;
+		for (const hook_type* curr = head.next; curr; curr = curr->next)
+			++n;
+		return n;
+	}
+
+	template<typename T, IntrusiveForwardListHook T::* Hook, class SizePolicy>
+	inline void IntrusiveForwardList<T, Hook, SizePolicy>::clear() noexcept
+	{
+		head.next = nullptr;
+		tracking.set(0, nullptr);
+	}
+
+	template<typename T, IntrusiveForwardListHook T::* Hook, class SizePolicy>
+	inline typename IntrusiveForwardList<T, Hook, SizePolicy>::iterator IntrusiveForwardList<T, Hook, SizePolicy>::insert_after(const_iterator pos, T & obj)
+	{
+		hook_type* prev = iterator(pos).p;
+		hook_type* node = &(obj.*Hook);
+		node->next = prev->next;
+		prev->next = node;
+		tracking.add(1);
+		if (!node->next)
+			tracking.set_last(node);
+		return iterator(node);
+	}
+
+	template<typename T, IntrusiveForwardListHook T::* Hook, class SizePolicy>
+	inline typename IntrusiveForwardList<T, Hook, SizePolicy>::iterator IntrusiveForwardList<T, Hook, SizePolicy>::erase_after(const_iterator pos)
+	{
+		hook_type* prev = iterator(pos).p;
+		hook_type* node = prev->next;
+		prev->next = node->next;
+		node->next = nullptr;
+		tracking.add(-1);
+		if (!prev->next)
+			tracking.set_last(prev == &head ? nullptr : prev);
+		return iterator(prev->next);
+	}
+
+	template<typename T, IntrusiveForwardListHook T::* Hook, class SizePolicy>
+	inline typename IntrusiveForwardList<T, Hook, SizePolicy>::iterator IntrusiveForwardList<T, Hook, SizePolicy>::erase_after(const_iterator first, const_iterator last)
+	{
+		hook_type* prev = iterator(first).p;
+		hook_type* stop = iterator(last).p;
+		ptrdiff_t n = 0;
+		while (prev->next != stop)
+		{
+			hook_type* node = prev->next;
+			prev->next = node->next;
+			node->next = nullptr;
+			++n;
+		}
+		tracking.add(-n);
+		if (!stop)
+			tracking.set_last(prev == &head ? nullptr : prev);
+		return iterator(stop);
+	}
+
+	template<typename T, IntrusiveForwardListHook T::* Hook, class SizePolicy>
+	inline void IntrusiveForwardList<T, Hook, SizePolicy>::push_front(T & obj)
+	{
+		insert_after(before_begin(), obj);
+	}
+
+	template<typename T, IntrusiveForwardListHook T::* Hook, class SizePolicy>
+	inline void IntrusiveForwardList<T, Hook, SizePolicy>::pop_front()
+	{
+		erase_after(before_begin());
+	}
+
+	template<typename T, IntrusiveForwardListHook T::* Hook, class SizePolicy>
+	inline void IntrusiveForwardList<T, Hook, SizePolicy>::push_back(T & obj)
+	{
+		insert_after(before_end(), obj);
+	}
+
+	template<typename T, IntrusiveForwardListHook T::* Hook, class SizePolicy>
+	inline void IntrusiveForwardList<T, Hook, SizePolicy>::swap(IntrusiveForwardList & other) noexcept
+	{
+		std::swap(head.next, other.head.next);
+		std::swap(tracking, other.tracking);
+	}
+
+	template<typename T, IntrusiveForwardListHook T::* Hook, class SizePolicy>
+	inline void IntrusiveForwardList<T, Hook, SizePolicy>::merge(IntrusiveForwardList & other)
+	{
+		merge(other, std::less<T>());
+	}
+
+	template<typename T, IntrusiveForwardListHook T::* Hook, class SizePolicy>
+	template<typename Compare>
+	inline void IntrusiveForwardList<T, Hook, SizePolicy>::merge(IntrusiveForwardList & other, Compare comp)
+	{
+		if (this == &other) return;
+		if (other.empty()) return;
+		//The last object of other ends up last unless it goes before the last object of *this
+		hook_type* last = other.tracking.last();
+		if (tracked && !empty() && comp(*_owner(last), *_owner(tracking.last())))
+			last = tracking.last();
+		head.next = _merge_runs(head.next, other.head.next, comp);
+		other.head.next = nullptr;
+		tracking.set(tracking.count() + other.tracking.count(), last);
+		other.tracking.set(0, nullptr);
+	}
+
+	template<typename T, IntrusiveForwardListHook T::* Hook, class SizePolicy>
+	inline void IntrusiveForwardList<T, Hook, SizePolicy>::splice_after(const_iterator pos, IntrusiveForwardList & other)
+	{
+		if (this == &other) return;
+		splice_after(pos, other, other.cbefore_begin(), other.cend());
+	}
+
+	template<typename T, IntrusiveForwardListHook T::* Hook, class SizePolicy>
+	inline void IntrusiveForwardList<T, Hook, SizePolicy>::splice_after(const_iterator pos, IntrusiveForwardList & other, const_iterator first)
+	{
+		const_iterator next = first;
+		++next;
+		if (pos == first || pos == next) return;
+		splice_after(pos, other, first, other.cend());
+	}
+
+	template<typename T, IntrusiveForwardListHook T::* Hook, class SizePolicy>
+	inline void IntrusiveForwardList<T, Hook, SizePolicy>::splice_after(const_iterator pos, IntrusiveForwardList & other, const_iterator first, const_iterator last)
+	{
+		hook_type* prev = iterator(pos).p;
+		hook_type* next = prev->next;
+		hook_type* before_first = iterator(first).p;
+		hook_type* stop = iterator(last).p;
+		if (before_first->next == stop) return;
+		hook_type* tail = before_first->next;
+		ptrdiff_t n = 1;
+		for (; tail->next != stop; tail = tail->next)
+			++n;
+		prev->next = before_first->next;
+		tail->next = next;
+		before_first->next = stop;
+		if (tracked)
+		{
+			other.tracking.add(-n);
+			tracking.add(n);
+			if (!stop)
+				other.tracking.set_last(before_first == &other.head ? nullptr : before_first);
+			if (!next)
+				tracking.set_last(tail);
+		}
+	}
+
+	template<typename T, IntrusiveForwardListHook T::* Hook, class SizePolicy>
+	inline void IntrusiveForwardList<T, Hook, SizePolicy>::remove(const T & val)
+	{
+		remove_if([&val](const T& elem) { return std::equal_to<T>()(val, elem); });
+	}
+
+	template<typename T, IntrusiveForwardListHook T::* Hook, class SizePolicy>
+	template<typename UnaryPredicate>
+	inline void IntrusiveForwardList<T, Hook, SizePolicy>::remove_if(UnaryPredicate p)
+	{
+		hook_type* prev = &head;
+		ptrdiff_t n = 0;
+		while (hook_type* curr = prev->next)
+		{
+			if (p(*_owner(curr)))
+			{
+				prev->next = curr->next;
+				curr->next = nullptr;
+				++n;
+			}
+			else
+				prev = curr;
+		}
+		tracking.add(-n);
+		tracking.set_last(prev == &head ? nullptr : prev);
+	}
+
+	template<typename T, IntrusiveForwardListHook T::* Hook, class SizePolicy>
+	inline void IntrusiveForwardList<T, Hook, SizePolicy>::reverse() noexcept
+	{
+		hook_type* reversed = nullptr;
+		hook_type* curr = head.next;
+		tracking.set_last(curr);
+		while (curr)
+		{
+			hook_type* next = curr->next;
+			curr->next = reversed;
+			reversed = curr;
+			curr = next;
+		}
+		head.next = reversed;
+	}
+
+	template<typename T, IntrusiveForwardListHook T::* Hook, class SizePolicy>
+	inline void IntrusiveForwardList<T, Hook, SizePolicy>::sort()
+	{
+		sort(std::less<T>());
+	}
+
+	template<typename T, IntrusiveForwardListHook T::* Hook, class SizePolicy>
+	template<typename Compare>
+	inline void IntrusiveForwardList<T, Hook, SizePolicy>::sort(Compare comp)
+	{
+		if (!head.next || !head.next->next) return;
+		_sort_runs(comp);
+	}
+
+	template<typename T, IntrusiveForwardListHook T::* Hook, class SizePolicy>
+	inline T * IntrusiveForwardList<T, Hook, SizePolicy>::_owner(const hook_type * hook) noexcept
+	{
+		//offsetof() of the hook, measured on an aligned address that holds no object
+		const size_t offset = reinterpret_cast<size_t>(&(reinterpret_cast<T*>(alignof(T))->*Hook)) - alignof(T);
+		return reinterpret_cast<T*>(reinterpret_cast<char*>(const_cast<hook_type*>(hook)) - offset);
+	}
+
+	template<typename T, IntrusiveForwardListHook T::* Hook, class SizePolicy>
+	template<typename Compare>
+	inline typename IntrusiveForwardList<T, Hook, SizePolicy>::hook_type * IntrusiveForwardList<T, Hook, SizePolicy>::_merge_runs(hook_type * a, hook_type * b, Compare & comp)
+	{
+		//Stable: an object of b goes first only if it is strictly less
+		hook_type* first = nullptr;
+		hook_type** link = &first;
+		while (a && b)
+		{
+			if (comp(*_owner(b), *_owner(a)))
+			{
+				*link = b;
+				b = b->next;
+			}
+			else
+			{
+				*link = a;
+				a = a->next;
+			}
+			link = &(*link)->next;
+		}
+		*link = a ? a : b;
+		return first;
+	}
+
+	template<typename T, IntrusiveForwardListHook T::* Hook, class SizePolicy>
+	template<typename Compare>
+	inline void IntrusiveForwardList<T, Hook, SizePolicy>::_sort_runs(Compare & comp)
+	{
+		//Bottom-up like ForwardList: runs[i] is empty or holds 2^i sorted objects that came before those in lower runs
+		hook_type* runs[64] = {};
+		hook_type* curr = head.next;
+		while (curr)
+		{
+			hook_type* run = curr;
+			curr = curr->next;
+			run->next = nullptr;
+			size_t i = 0;
+			for (; runs[i]; i++)
+			{
+				run = _merge_runs(runs[i], run, comp);
+				runs[i] = nullptr;
+			}
+			runs[i] = run;
+		}
+		hook_type* sorted = nullptr;
+		for (size_t i = 0; i < 64; i++)
+			if (runs[i])
+				sorted = sorted ? _merge_runs(runs[i], sorted, comp) : runs[i];
+		head.next = sorted;
+		while (sorted->next)
+			sorted = sorted->next;
+		tracking.set_last(sorted);
+	}
+}
@@ -0,0 +1,175 @@
+#pragma once
+#include <istream>
+#include <cstdlib>
+#include <cstring>
+#include "BasicString.h"
+#include "SIMD.h"
+
+namespace DataStructures
+{
+	template<typename CharT, typename Traits = std::char_traits<CharT>> class BasicLineReader;
+	using LineReader = BasicLineReader<char>;
+	using WLineReader = BasicLineReader<wchar_t>;
+
+	constexpr size_t LINE_READER_BUFFER_SIZE = 1U << 16;
+
+	//Reads a stream line after line through one reusable buffer.
+	//The stream buffer is read in large blocks with sgetn(), each line is found with a vectorized search and handed out
+	//as a pointer into the buffer, so nothing is copied or allocated per line. Only a line longer than the buffer grows it.
+	//The reader consumes the stream in blocks, so the stream should not be read by anything else while it is in use.
+	template<typename CharT, typename Traits>
+	class BasicLineReader
+	{
+	public:
+		using value_type = CharT;
+		using traits_type = Traits;
+		using size_type = size_t;
+		using string_type = BasicString<CharT, Traits>;
+
+		//Constructor, Destructor and Assignment
+		explicit BasicLineReader(std::basic_istream<CharT, Traits>& _input, CharT _delim = CharT('\n'), size_type buffer_size = LINE_READER_BUFFER_SIZE);
+		BasicLineReader(const BasicLineReader&) = delete;
+		BasicLineReader& operator=(const BasicLineReader&) = delete;
+		~BasicLineReader();
+
+		//Operations
+		bool next();							//Moves to the next line, false if the input is exhausted. The delimiter is not part of the line
+		template<class Allocator>
+		bool getline(BasicString<CharT, Traits, Allocator>& line);	//next() and copy the line into line, reusing its capacity
+
+		//Element access
+		const CharT* data() const noexcept;		//Current line, valid until the next call to next()
+		size_type size() const noexcept;
+		string_type str() const;
+
+		//Capacity
+		size_type capacity() const noexcept;	//Size of the buffer
+
+	private:
+		std::basic_istream<CharT, Traits>& input;
+		CharT delim;
+		CharT* buffer = nullptr;
+		size_type reserved_size = 0;
+		CharT* line_first = nullptr;			//Current line
+		CharT* line_last = nullptr;
+		CharT* pending_first = nullptr;			//Read from the stream but not handed out yet
+		CharT* pending_last = nullptr;
+		CharT* scanned = nullptr;				//[pending_first, scanned) is known to hold no delimiter
+		bool exhausted = false;
+
+		//Helper functions
+		inline bool _fill();					//Read another block, false at the end of the stream
+	};
+
+	/* Dividing Line ( 㧥 ;) ( 㧥 ;) ( 㧥 ;)  */
+
+	template<typename CharT, typename Traits>
+	inline bool BasicLineReader<CharT, Traits>::_fill()
+	{
+		if (exhausted) return false;
+		size_type pending = pending_last - pending_first;
+		size_type known = scanned - pending_first;
+		if (pending == reserved_size)
+		{
+			//A line longer than the buffer
+			reserved_size = reserved_size + reserved_size / 2 + 1;
+			CharT* grown = reinterpret_cast<CharT*>(realloc(buffer, reserved_size * sizeof(CharT)));
+			if (!grown) throw std::bad_alloc{};
+			buffer = grown;
+		}
+		else if (pending_first != buffer && pending > 0)
+			memmove(buffer, pending_first, pending * sizeof(CharT));
+		pending_first = buffer;
+		pending_last = buffer + pending;
+		scanned = buffer + known;
+
+		std::streamsize n = input.rdbuf()->sgetn(pending_last, std::streamsize(reserved_size - pending));
+		if (n <= 0)
+		{
+			exhausted = true;
+			input.setstate(std::ios_base::eofbit);
+			return false;
+		}
+		pending_last += n;
+		return true;
+	}
+
+	template<typename CharT, typename Traits>
+	inline BasicLineReader<CharT, Traits>::BasicLineReader(std::basic_istream<CharT, Traits>& _input, CharT _delim, size_type buffer_size) :
+		input(_input), delim(_delim), reserved_size(buffer_size > 0 ? buffer_size : 1)
+	{
+		buffer = reinterpret_cast<CharT*>(malloc(reserved_size * sizeof(CharT)));
+		if (!buffer) throw std::bad_alloc{};
+		line_first = line_last = pending_first = pending_last = scanned = buffer;
+	}
+
+	template<typename CharT, typename Traits>
+	inline BasicLineReader<CharT, Traits>::~BasicLineReader()
+	{
+		free(buffer);
+	}
+
+	template<typename CharT, typename Traits>
+	inline bool BasicLineReader<CharT, Traits>::next()
+	{
+		for (;;)
+		{
+			CharT* found = _find_char(scanned, pending_last, delim);
+			if (found != pending_last)
+			{
+				line_first = pending_first;
+				line_last = found;
+				pending_first = scanned = found + 1;
+				return true;
+			}
+			scanned = pending_last;
+			if (!_fill())
+			{
+				//The last line may have no delimiter
+				if (pending_first == pending_last)
+				{
+					line_first = line_last = pending_last;
+					return false;
+				}
+				line_first = pending_first;
+				line_last = pending_last;
+				pending_first = scanned = pending_last;
+				return true;
+			}
+		}
+	}
+
+	template<typename CharT, typename Traits>
+	template<class Allocator>
+	inline bool BasicLineReader<CharT, Traits>::getline(BasicString<CharT, Traits, Allocator> & line)
+	{
+		if (!next()) return false;
+		line.clear();
+		line.append(line_first, line_last - line_first);
+		return true;
+	}
+
+	template<typename CharT, typename Traits>
+	inline const CharT * BasicLineReader<CharT, Traits>::data() const noexcept
+	{
+		return line_first;
+	}
+
+	template<typename CharT, typename Traits>
+	inline typename BasicLineReader<CharT, Traits>::size_type BasicLineReader<CharT, Traits>::size() const noexcept
+	{
+		return line_last - line_first;
+	}
+
+	template<typename CharT, typename Traits>
+	inline typename BasicLineReader<CharT, Traits>::string_type BasicLineReader<CharT, Traits>::str() const
+	{
+		return string_type(line_first, line_last - line_first);
+	}
+
+	template<typename CharT, typename Traits>
+	inline typename BasicLineReader<CharT, Traits>::size_type BasicLineReader<CharT, Traits>::capacity() const noexcept
+	{
+		return reserved_size;
+	}
+}
@@ -0,0 +1,180 @@
+#pragma once
+#include <stdexcept>
+#include <atomic>
+#include <new>
+#include <utility>
+#include "EpochReclaimer.h"
+
+namespace DataStructures
+{
+	//Treiber stack: a singly linked list whose head is swung by CAS, for a free list or an inbox shared by many threads.
+	//A popped node is retired to EpochReclaimer rather than freed, and a thread pops inside a Guard. So the node
+	//a popper has read can neither be freed nor come back at the same address before its CAS, which rules out ABA.
+	//A range is pushed with one CAS and pop_all() takes every element with one exchange.
+	//Only the destructor must not run concurrently with anything else.
+	template<typename T>
+	class LockFreeStack
+	{
+	public:
+		using value_type		= T;
+		using reference			= T&;
+		using const_reference	= const T&;
+		using size_type			= size_t;
+
+		//Constructor, Destructor and Assignment
+		LockFreeStack() noexcept;
+		LockFreeStack(const LockFreeStack&) = delete;
+		LockFreeStack& operator=(const LockFreeStack&) = delete;
+		~LockFreeStack();
+
+		//Capacity
+		bool empty() const noexcept;
+
+		//Modifiers
+		void push(const T& value);
+		void push(T&& value);
+		template<typename ... Args> void emplace(Args&& ... args);
+		template<typename InputIterator> void push(InputIterator first, InputIterator last);	//One CAS, the last element ends on top
+		bool try_pop(T& value);											//false if the stack was empty
+		template<typename OutputIterator> size_type pop_all(OutputIterator out);	//Top first, returns how many
+
+	private:
+		struct Node
+		{
+			Node* next;			//Written before the node is pushed and never after
+			T value;
+
+			template<typename ... Args>
+			Node(Args&& ... args) : next(nullptr), value(std::forward<Args>(args)...) {}
+		};
+
+		std::atomic<Node*> head;
+
+		void _push_chain(Node* first, Node* last) noexcept;
+		static void _destroy_node(void* p) noexcept;
+		static void _destroy_chain(void* p) noexcept;		//Frees p and every node after it
+	};
+}
+
+
+namespace DataStructures
+{
+	/* Dividing Line ( 㧥 ;) ( 㧥 ;) ( 㧥 ;)  */
+
+	template<typename T>
+	inline LockFreeStack<T>::LockFreeStack() noexcept : head(nullptr)
+	{
+	}
+
+	template<typename T>
+	inline LockFreeStack<T>::~LockFreeStack()
+	{
+		_destroy_chain(head.load(std::memory_order_acquire));
+	}
+
+	template<typename T>
+	inline bool LockFreeStack<T>::empty() const noexcept
+	{
+		return head.load(std::memory_order_acquire) == nullptr;
+	}
+
+	template<typename T>
+	inline void LockFreeStack<T>::push(const T & value)
+	{
+		emplace(value);
+	}
+
+	template<typename T>
+	inline void LockFreeStack<T>::push(T && value)
+	{
+		emplace(std::move(value));
+	}
+
+	template<typename T>
+	template<typename ... Args>
+	inline void LockFreeStack<T>::emplace(Args && ... args)
+	{
+		Node* node = new Node(std::forward<Args>(args)...);
+		_push_chain(node, node);
+	}
+
+	template<typename T>
+	template<typename InputIterator>
+	inline void LockFreeStack<T>::push(InputIterator first, InputIterator last)
+	{
+		//Linked privately from the top down, so the chain is published at once
+		Node* top = nullptr;
+		Node* bottom = nullptr;
+		try
+		{
+			for (; first != last; ++first)
+			{
+				Node* node = new Node(*first);
+				node->next = top;
+				top = node;
+				if (!bottom) bottom = node;
+			}
+		}
+		catch (...)
+		{
+			_destroy_chain(top);
+			throw;
+		}
+		if (top) _push_chain(top, bottom);
+	}
+
+	template<typename T>
+	inline bool LockFreeStack<T>::try_pop(T & value)
+	{
+		EpochReclaimer::Guard guard;
+		Node* top = head.load(std::memory_order_acquire);
+		while (top && !head.compare_exchange_weak(top, top->next, std::memory_order_acq_rel, std::memory_order_acquire))
+			;
+		if (!top) return false;
+		//Freed only after the Guard is left, so retiring first also reclaims the node if the move throws
+		EpochReclaimer::retire(top, &_destroy_node);
+		value = std::move(top->value);
+		return true;
+	}
+
+	template<typename T>
+	template<typename OutputIterator>
+	inline typename LockFreeStack<T>::size_type LockFreeStack<T>::pop_all(OutputIterator out)
+	{
+		EpochReclaimer::Guard guard;
+		Node* top = head.exchange(nullptr, std::memory_order_acq_rel);
+		if (!top) return 0;
+		//Poppers that read a node before the exchange may still follow its next, so the chain is retired as it is
+		EpochReclaimer::retire(top, &_destroy_chain);
+		size_type count = 0;
+		for (Node* curr = top; curr; curr = curr->next, ++count)
+			*out++ = std::move(curr->value);
+		return count;
+	}
+
+	template<typename T>
+	inline void LockFreeStack<T>::_push_chain(Node * first, Node * last) noexcept
+	{
+		last->next = head.load(std::memory_order_relaxed);
+		while (!head.compare_exchange_weak(last->next, first, std::memory_order_release, std::memory_order_relaxed))
+			;
+	}
+
+	template<typename T>
+	inline void LockFreeStack<T>::_destroy_node(void * p) noexcept
+	{
+		delete static_cast<Node*>(p);
+	}
+
+	template<typename T>
+	inline void LockFreeStack<T>::_destroy_chain(void * p) noexcept
+	{
+		Node* curr = static_cast<Node*>(p);
+		while (curr)
+		{
+			Node* next = curr->next;
+			delete curr;
+			curr = next;
+		}
+	}
+}
@@ -0,0 +1,194 @@
+#pragma once
+#include <stdexcept>
+#include <atomic>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace DataStructures
+{
+	//Linked queue that any number of threads push to and one thread pops from, e.g. the inbox of a worker.
+	//A push exchanges the head and then links the old head to the new node, no CAS loop and no lock. The consumer
+	//owns the tail, a node whose value has been taken already, and frees it on the next pop, so nothing has to be
+	//reclaimed behind the producers' backs. A range is pushed with one exchange.
+	//A producer stopped between its exchange and its link hides the elements pushed after it until it resumes,
+	//so try_pop() may fail on a queue that is not empty. Elements of one producer come out in the order it pushed them.
+	template<typename T>
+	class MPSCQueue
+	{
+	public:
+		using value_type		= T;
+		using reference			= T&;
+		using const_reference	= const T&;
+		using size_type			= size_t;
+
+		//Constructor, Destructor and Assignment
+		MPSCQueue();
+		MPSCQueue(const MPSCQueue&) = delete;
+		MPSCQueue& operator=(const MPSCQueue&) = delete;
+		~MPSCQueue();
+
+		//Capacity
+		bool empty() const noexcept;									//Consumer only
+
+		//Modifiers, push from any thread
+		void push(const T& value);
+		void push(T&& value);
+		template<typename ... Args> void emplace(Args&& ... args);
+		template<typename InputIterator> void push(InputIterator first, InputIterator last);
+		//Pop from the consumer thread only
+		bool try_pop(T& value);											//false if nothing was ready
+		template<typename OutputIterator> size_type pop_all(OutputIterator out);	//Everything ready, returns how many
+
+	private:
+		struct Node
+		{
+			std::atomic<Node*> next;
+			std::aligned_storage_t<sizeof(T), alignof(T)> storage;	//Holds a value from the push until the pop
+
+			Node() noexcept : next(nullptr) {}
+			T* value() noexcept { return reinterpret_cast<T*>(&storage); }
+		};
+
+		alignas(64) std::atomic<Node*> head;		//Pushed last, shared by the producers
+		alignas(64) Node* tail;					//Owned by the consumer
+
+		template<typename ... Args> static Node* _create_node(Args&& ... args);
+		void _push_chain(Node* first, Node* last) noexcept;
+	};
+}
+
+
+namespace DataStructures
+{
+	/* Dividing Line ( 㧥 ;) ( 㧥 ;) ( 㧥 ;)  */
+
+	template<typename T>
+	inline MPSCQueue<T>::MPSCQueue() : head(nullptr), tail(new Node)
+	{
+		head.store(tail, std::memory_order_relaxed);
+	}
+
+	template<typename T>
+	inline MPSCQueue<T>::~MPSCQueue()
+	{
+		Node* curr = tail->next.load(std::memory_order_acquire);
+		delete tail;
+		while (curr)
+		{
+			Node* next = curr->next.load(std::memory_order_acquire);
+			curr->value()->~T();
+			delete curr;
+			curr = next;
+		}
+	}
+
+	template<typename T>
+	inline bool MPSCQueue<T>::empty() const noexcept
+	{
+		return tail->next.load(std::memory_order_acquire) == nullptr;
+	}
+
+	template<typename T>
+	inline void MPSCQueue<T>::push(const T & value)
+	{
+		emplace(value);
+	}
+
+	template<typename T>
+	inline void MPSCQueue<T>::push(T && value)
+	{
+		emplace(std::move(value));
+	}
+
+	template<typename T>
+	template<typename ... Args>
+	inline void MPSCQueue<T>::emplace(Args && ... args)
+	{
+		Node* node = _create_node(std::forward<Args>(args)...);
+		_push_chain(node, node);
+	}
+
+	template<typename T>
+	template<typename InputIterator>
+	inline void MPSCQueue<T>::push(InputIterator first, InputIterator last)
+	{
+		if (first == last) return;
+		Node* front = _create_node(*first);
+		Node* back = front;
+		try
+		{
+			for (++first; first != last; ++first)
+			{
+				Node* node = _create_node(*first);
+				back->next.store(node, std::memory_order_relaxed);
+				back = node;
+			}
+		}
+		catch (...)
+		{
+			while (front)
+			{
+				Node* next = front->next.load(std::memory_order_relaxed);
+				front->value()->~T();
+				delete front;
+				front = next;
+			}
+			throw;
+		}
+		_push_chain(front, back);
+	}
+
+	template<typename T>
+	inline bool MPSCQueue<T>::try_pop(T & value)
+	{
+		Node* next = tail->next.load(std::memory_order_acquire);
+		if (!next) return false;
+		value = std::move(*next->value());
+		next->value()->~T();
+		delete tail;
+		tail = next;
+		return true;
+	}
+
+	template<typename T>
+	template<typename OutputIterator>
+	inline typename MPSCQueue<T>::size_type MPSCQueue<T>::pop_all(OutputIterator out)
+	{
+		size_type count = 0;
+		for (Node* next = tail->next.load(std::memory_order_acquire); next; next = tail->next.load(std::memory_order_acquire))
+		{
+			*out++ = std::move(*next->value());
+			next->value()->~T();
+			delete tail;
+			tail = next;
+			++count;
+		}
+		return count;
+	}
+
+	template<typename T>
+	template<typename ... Args>
+	inline typename MPSCQueue<T>::Node * MPSCQueue<T>::_create_node(Args && ... args)
+	{
+		Node* node = new Node;
+		try
+		{
+			::new (node->value()) T(std::forward<Args>(args)...);
+		}
+		catch (...)
+		{
+			delete node;
+			throw;
+		}
+		return node;
+	}
+
+	template<typename T>
+	inline void MPSCQueue<T>::_push_chain(Node * first, Node * last) noexcept
+	{
+		//Until the link is stored the consumer sees the queue end at prev, prev is not freed before it has a next
+		Node* prev = head.exchange(last, std::memory_order_acq_rel);
+		prev->next.store(first, std::memory_order_release);
+	}
+}
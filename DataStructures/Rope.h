@@ -0,0 +1,820 @@
+#pragma once
+#include <stdexcept>
+#include <iostream>
+#include "BasicString.h"
+
+constexpr size_t ROPE_LEAF_SIZE = 512U;	//Leaves are merged up to this many characters
+
+namespace DataStructures
+{
+	template<typename CharT = char, typename Traits = std::char_traits<CharT>> class BasicRope;
+	using Rope = BasicRope<char>;
+	using WRope = BasicRope<wchar_t>;
+
+	//Rope (a.k.a. cord) is an AVL-balanced concatenation tree whose leaves are chunks of characters.
+	//Nodes are reference counted and shared between ropes, so copy and substr never copy characters,
+	//and insert, erase and concatenation are O(log n).
+	//A shared node is never modified. Only a leaf owned by this rope alone may be extended in place.
+	template<typename CharT, typename Traits>
+	class BasicRope
+	{
+	private:
+		struct RopeNode;
+
+	public:
+		class RopeConstIterator;
+
+		using traits_type		= Traits;
+		using value_type		= CharT;
+		using size_type			= size_t;
+		using difference_type	= ptrdiff_t;
+		using const_reference	= const CharT&;
+		using const_pointer		= const CharT*;
+		using string_type		= BasicString<CharT, Traits>;
+
+		using const_iterator	= RopeConstIterator;
+		using iterator			= RopeConstIterator;	//Characters in a rope are immutable
+
+		static const size_type npos = -1;
+
+		//Constructor, Destructor and Assignment
+		BasicRope() noexcept;
+		BasicRope(size_type n, CharT ch);
+		BasicRope(const CharT* s, size_type n);
+		BasicRope(const CharT* s);
+		BasicRope(const string_type& str);
+		BasicRope(const BasicRope& origin) noexcept;	//O(1), shares every node with origin
+		BasicRope(BasicRope&& origin) noexcept;
+		~BasicRope();
+
+		BasicRope& operator=(const BasicRope& origin) noexcept;
+		BasicRope& operator=(BasicRope&& origin) noexcept;
+		BasicRope& operator=(const CharT* s);
+		BasicRope& operator=(const string_type& str);
+
+		//Element access
+		CharT at(size_type index) const;			//Check and throw out_of_range exception
+		CharT operator[](size_type index) const;	//No check, O(log n)
+		CharT front() const;
+		CharT back() const;
+
+		//Iterators
+		const_iterator begin() const;
+		const_iterator cbegin() const;
+		const_iterator end() const;
+		const_iterator cend() const;
+
+		//Capacity
+		bool empty() const noexcept;
+		size_type size() const noexcept;
+		size_type length() const noexcept;
+		size_type max_size() const noexcept;
+		size_type depth() const noexcept;			//Height of the tree, 0 for a single leaf
+
+		//Modifiers
+		void clear() noexcept;
+		BasicRope& insert(size_type pos, const BasicRope& rope);
+		BasicRope& insert(size_type pos, const CharT* s, size_type n);
+		BasicRope& insert(size_type pos, const CharT* s);
+		BasicRope& insert(size_type pos, const string_type& str);
+		BasicRope& insert(size_type pos, size_type n, CharT ch);
+		BasicRope& erase(size_type pos = 0, size_type n = npos);
+		BasicRope& append(const BasicRope& rope);
+		BasicRope& append(const CharT* s, size_type n);
+		BasicRope& append(const CharT* s);
+		BasicRope& append(const string_type& str);
+		BasicRope& append(size_type n, CharT ch);
+		void push_back(CharT ch);
+		BasicRope& operator+=(const BasicRope& rope);
+		BasicRope& operator+=(const CharT* s);
+		BasicRope& operator+=(const string_type& str);
+		BasicRope& operator+=(CharT ch);
+		void swap(BasicRope& other) noexcept;
+
+		//Operations
+		BasicRope substr(size_type pos = 0, size_type n = npos) const;	//Shares nodes with *this
+		size_type copy(CharT* dest, size_type n, size_type pos = 0) const;
+		string_type flatten() const;				//Allocates the result only once
+		int compare(const BasicRope& rope) const;
+		template<typename Function> void for_each_chunk(Function f) const;	//Calls f(const CharT* chunk, size_type n) in order
+
+	private:
+		using node_type = RopeNode;
+		node_type* root = nullptr;	//nullptr for an empty rope
+
+		explicit BasicRope(node_type* node) noexcept;
+
+	//Helper functions
+	//Functions taking node_type* consume the reference passed in and return a reference owned by the caller.
+	private:
+		static node_type* _retain(node_type* node) noexcept;
+		static void _release(node_type* node) noexcept;
+		static size_type _height(const node_type* node) noexcept;
+		static node_type* _make_leaf(const CharT* s, size_type n, size_type capacity);
+		static node_type* _make_branch(node_type* left, node_type* right);
+		static node_type* _build(const CharT* s, size_type n);		//Perfectly balanced tree of full leaves
+		static node_type* _balance(node_type* left, node_type* right);	//Branch with at most a single or double rotation
+		static node_type* _join(node_type* left, node_type* right);
+		static void _split(node_type* node, size_type pos, node_type*& left, node_type*& right);
+		template<typename Function> static void _for_each_chunk(const node_type* node, Function& f);
+		const CharT* _find_leaf(size_type pos, size_type& chunk_begin, size_type& chunk_end) const;
+		bool _append_in_place(const CharT* s, size_type n);	//Extends the last leaf if this rope owns the whole right spine
+
+	private:
+		struct RopeNode
+		{
+			size_type refcount = 1;
+			size_type length = 0;
+			size_type height = 0;				//0 for a leaf
+			size_type capacity = 0;				//Leaf only
+			CharT* chars = nullptr;				//Leaf only
+			RopeNode* left = nullptr;			//Branch only
+			RopeNode* right = nullptr;			//Branch only
+		};
+
+	public:
+		class RopeConstIterator
+		{
+		public:
+			using self_type = RopeConstIterator;
+			using value_type = CharT;
+			using reference = const CharT&;
+			using pointer = const CharT*;
+			using difference_type = ptrdiff_t;
+			using iterator_category = std::forward_iterator_tag;
+
+			RopeConstIterator() {}
+
+			//Moving inside a chunk is O(1), stepping to the next chunk is O(log n).
+			RopeConstIterator& operator++() { if (++pos == chunk_end && pos < rope->size()) _seek(); return *this; }
+			RopeConstIterator operator++(int) { RopeConstIterator ret(*this); ++*this; return ret; }
+			bool operator==(const RopeConstIterator& rhs) const { return pos == rhs.pos; }
+			bool operator!=(const RopeConstIterator& rhs) const { return pos != rhs.pos; }
+			reference operator*() const { return chunk[pos - chunk_begin]; }
+			pointer operator->() const { return chunk + (pos - chunk_begin); }
+
+		private:
+			RopeConstIterator(const BasicRope* _rope, size_type _pos) : rope(_rope), pos(_pos) { if (pos < rope->size()) _seek(); }
+			void _seek() { chunk = rope->_find_leaf(pos, chunk_begin, chunk_end); }
+
+		private:
+			friend class BasicRope;
+			const BasicRope* rope = nullptr;
+			size_type pos = 0;
+			const CharT* chunk = nullptr;
+			size_type chunk_begin = 0;
+			size_type chunk_end = 0;
+		};
+	};
+
+	/* Dividing Line ( 㧥 ;) ( 㧥 ;) ( 㧥 ;)  */
+
+	template<typename CharT, typename Traits>
+	inline BasicRope<CharT, Traits>::BasicRope() noexcept
+	{
+	}
+
+	template<typename CharT, typename Traits>
+	inline BasicRope<CharT, Traits>::BasicRope(node_type * node) noexcept : root(node)
+	{
+	}
+
+	template<typename CharT, typename Traits>
+	inline BasicRope<CharT, Traits>::BasicRope(size_type n, CharT ch)
+	{
+		append(n, ch);
+	}
+
+	template<typename CharT, typename Traits>
+	inline BasicRope<CharT, Traits>::BasicRope(const CharT * s, size_type n) : root(_build(s, n))
+	{
+	}
+
+	template<typename CharT, typename Traits>
+	inline BasicRope<CharT, Traits>::BasicRope(const CharT * s) : root(_build(s, Traits::length(s)))
+	{
+	}
+
+	template<typename CharT, typename Traits>
+	inline BasicRope<CharT, Traits>::BasicRope(const string_type & str) : root(_build(str.data(), str.size()))
+	{
+	}
+
+	template<typename CharT, typename Traits>
+	inline BasicRope<CharT, Traits>::BasicRope(const BasicRope & origin) noexcept : root(_retain(origin.root))
+	{
+	}
+
+	template<typename CharT, typename Traits>
+	inline BasicRope<CharT, Traits>::BasicRope(BasicRope && origin) noexcept
+	{
+		swap(origin);
+	}
+
+	template<typename CharT, typename Traits>
+	inline BasicRope<CharT, Traits>::~BasicRope()
+	{
+		_release(root);
+	}
+
+	template<typename CharT, typename Traits>
+	inline BasicRope<CharT, Traits> & BasicRope<CharT, Traits>::operator=(const BasicRope & origin) noexcept
+	{
+		node_type* old = root;
+		root = _retain(origin.root);
+		_release(old);
+		return *this;
+	}
+
+	template<typename CharT, typename Traits>
+	inline BasicRope<CharT, Traits> & BasicRope<CharT, Traits>::operator=(BasicRope && origin) noexcept
+	{
+		swap(origin);
+		return *this;
+	}
+
+	template<typename CharT, typename Traits>
+	inline BasicRope<CharT, Traits> & BasicRope<CharT, Traits>::operator=(const CharT * s)
+	{
+		BasicRope temp(s);
+		swap(temp);
+		return *this;
+	}
+
+	template<typename CharT, typename Traits>
+	inline BasicRope<CharT, Traits> & BasicRope<CharT, Traits>::operator=(const string_type & str)
+	{
+		BasicRope temp(str);
+		swap(temp);
+		return *this;
+	}
+
+	template<typename CharT, typename Traits>
+	inline CharT BasicRope<CharT, Traits>::at(size_type index) const
+	{
+		if (index < size())
+			return (*this)[index];
+		throw std::out_of_range{ "Accessed position is out of range!" };
+	}
+
+	template<typename CharT, typename Traits>
+	inline CharT BasicRope<CharT, Traits>::operator[](size_type index) const
+	{
+		size_type chunk_begin, chunk_end;
+		return _find_leaf(index, chunk_begin, chunk_end)[index - chunk_begin];
+	}
+
+	template<typename CharT, typename Traits>
+	inline CharT BasicRope<CharT, Traits>::front() const
+	{
+		return (*this)[0];
+	}
+
+	template<typename CharT, typename Traits>
+	inline CharT BasicRope<CharT, Traits>::back() const
+	{
+		return (*this)[size() - 1];
+	}
+
+	template<typename CharT, typename Traits>
+	inline typename BasicRope<CharT, Traits>::const_iterator BasicRope<CharT, Traits>::begin() const
+	{
+		return const_iterator(this, 0);
+	}
+
+	template<typename CharT, typename Traits>
+	inline typename BasicRope<CharT, Traits>::const_iterator BasicRope<CharT, Traits>::cbegin() const
+	{
+		return begin();
+	}
+
+	template<typename CharT, typename Traits>
+	inline typename BasicRope<CharT, Traits>::const_iterator BasicRope<CharT, Traits>::end() const
+	{
+		return const_iterator(this, size());
+	}
+
+	template<typename CharT, typename Traits>
+	inline typename BasicRope<CharT, Traits>::const_iterator BasicRope<CharT, Traits>::cend() const
+	{
+		return end();
+	}
+
+	template<typename CharT, typename Traits>
+	inline bool BasicRope<CharT, Traits>::empty() const noexcept
+	{
+		return root == nullptr;
+	}
+
+	template<typename CharT, typename Traits>
+	inline typename BasicRope<CharT, Traits>::size_type BasicRope<CharT, Traits>::size() const noexcept
+	{
+		return root ? root->length : 0;
+	}
+
+	template<typename CharT, typename Traits>
+	inline typename BasicRope<CharT, Traits>::size_type BasicRope<CharT, Traits>::length() const noexcept
+	{
+		return size();
+	}
+
+	template<typename CharT, typename Traits>
+	inline typename BasicRope<CharT, Traits>::size_type BasicRope<CharT, Traits>::max_size() const noexcept
+	{
+		return npos - 1;
+	}
+
+	template<typename CharT, typename Traits>
+	inline typename BasicRope<CharT, Traits>::size_type BasicRope<CharT, Traits>::depth() const noexcept
+	{
+		return _height(root);
+	}
+
+	template<typename CharT, typename Traits>
+	inline void BasicRope<CharT, Traits>::clear() noexcept
+	{
+		_release(root);
+		root = nullptr;
+	}
+
+	template<typename CharT, typename Traits>
+	inline BasicRope<CharT, Traits> & BasicRope<CharT, Traits>::insert(size_type pos, const BasicRope & rope)
+	{
+		if (pos > size())
+			throw std::out_of_range{ "Accessed position is out of range!" };
+		node_type* middle = _retain(rope.root);	//Before splitting, rope may be *this
+		node_type *left, *right;
+		_split(root, pos, left, right);
+		root = _join(_join(left, middle), right);
+		return *this;
+	}
+
+	template<typename CharT, typename Traits>
+	inline BasicRope<CharT, Traits> & BasicRope<CharT, Traits>::insert(size_type pos, const CharT * s, size_type n)
+	{
+		if (pos == size())
+			return append(s, n);
+		return insert(pos, BasicRope(s, n));
+	}
+
+	template<typename CharT, typename Traits>
+	inline BasicRope<CharT, Traits> & BasicRope<CharT, Traits>::insert(size_type pos, const CharT * s)
+	{
+		return insert(pos, s, Traits::length(s));
+	}
+
+	template<typename CharT, typename Traits>
+	inline BasicRope<CharT, Traits> & BasicRope<CharT, Traits>::insert(size_type pos, const string_type & str)
+	{
+		return insert(pos, str.data(), str.size());
+	}
+
+	template<typename CharT, typename Traits>
+	inline BasicRope<CharT, Traits> & BasicRope<CharT, Traits>::insert(size_type pos, size_type n, CharT ch)
+	{
+		return insert(pos, BasicRope(n, ch));
+	}
+
+	template<typename CharT, typename Traits>
+	inline BasicRope<CharT, Traits> & BasicRope<CharT, Traits>::erase(size_type pos, size_type n)
+	{
+		if (pos > size())
+			throw std::out_of_range{ "Accessed position is out of range!" };
+		node_type *left, *middle, *right;
+		_split(root, pos, left, right);
+		_split(right, n, middle, right);
+		_release(middle);
+		root = _join(left, right);
+		return *this;
+	}
+
+	template<typename CharT, typename Traits>
+	inline BasicRope<CharT, Traits> & BasicRope<CharT, Traits>::append(const BasicRope & rope)
+	{
+		root = _join(root, _retain(rope.root));
+		return *this;
+	}
+
+	template<typename CharT, typename Traits>
+	inline BasicRope<CharT, Traits> & BasicRope<CharT, Traits>::append(const CharT * s, size_type n)
+	{
+		if (n == 0 || _append_in_place(s, n))
+			return *this;
+		//A short piece gets a full-sized leaf so that the following short appends land in place
+		root = _join(root, n < ROPE_LEAF_SIZE ? _make_leaf(s, n, ROPE_LEAF_SIZE) : _build(s, n));
+		return *this;
+	}
+
+	template<typename CharT, typename Traits>
+	inline BasicRope<CharT, Traits> & BasicRope<CharT, Traits>::append(const CharT * s)
+	{
+		return append(s, Traits::length(s));
+	}
+
+	template<typename CharT, typename Traits>
+	inline BasicRope<CharT, Traits> & BasicRope<CharT, Traits>::append(const string_type & str)
+	{
+		return append(str.data(), str.size());
+	}
+
+	template<typename CharT, typename Traits>
+	inline BasicRope<CharT, Traits> & BasicRope<CharT, Traits>::append(size_type n, CharT ch)
+	{
+		if (n == 0) return *this;
+		//Every full chunk shares the same leaf
+		size_type chunk = n < ROPE_LEAF_SIZE ? n : ROPE_LEAF_SIZE;
+		node_type* leaf = new node_type;
+		leaf->chars = new CharT[chunk];
+		leaf->capacity = leaf->length = chunk;
+		Traits::assign(leaf->chars, chunk, ch);
+		for (; n >= chunk; n -= chunk)
+			root = _join(root, _retain(leaf));
+		_release(leaf);
+		return n ? append(n, ch) : *this;
+	}
+
+	template<typename CharT, typename Traits>
+	inline void BasicRope<CharT, Traits>::push_back(CharT ch)
+	{
+		append(&ch, 1);
+	}
+
+	template<typename CharT, typename Traits>
+	inline BasicRope<CharT, Traits> & BasicRope<CharT, Traits>::operator+=(const BasicRope & rope)
+	{
+		return append(rope);
+	}
+
+	template<typename CharT, typename Traits>
+	inline BasicRope<CharT, Traits> & BasicRope<CharT, Traits>::operator+=(const CharT * s)
+	{
+		return append(s);
+	}
+
+	template<typename CharT, typename Traits>
+	inline BasicRope<CharT, Traits> & BasicRope<CharT, Traits>::operator+=(const string_type & str)
+	{
+		return append(str);
+	}
+
+	template<typename CharT, typename Traits>
+	inline BasicRope<CharT, Traits> & BasicRope<CharT, Traits>::operator+=(CharT ch)
+	{
+		return append(&ch, 1);
+	}
+
+	template<typename CharT, typename Traits>
+	inline void BasicRope<CharT, Traits>::swap(BasicRope & other) noexcept
+	{
+		std::swap(root, other.root);
+	}
+
+	template<typename CharT, typename Traits>
+	inline BasicRope<CharT, Traits> BasicRope<CharT, Traits>::substr(size_type pos, size_type n) const
+	{
+		if (pos > size())
+			throw std::out_of_range{ "Accessed position is out of range!" };
+		node_type *left, *middle, *right;
+		_split(_retain(root), pos, left, right);
+		_release(left);
+		_split(right, n, middle, right);
+		_release(right);
+		return BasicRope(middle);
+	}
+
+	template<typename CharT, typename Traits>
+	inline typename BasicRope<CharT, Traits>::size_type BasicRope<CharT, Traits>::copy(CharT * dest, size_type n, size_type pos) const
+	{
+		if (pos > size())
+			throw std::out_of_range{ "Accessed position is out of range!" };
+		size_type count = n < size() - pos ? n : size() - pos;
+		size_type offset = 0;
+		CharT* curr = dest;
+		for_each_chunk([&](const CharT* chunk, size_type len)
+		{
+			size_type first = pos > offset ? pos - offset : 0;
+			size_type last = pos + count > offset ? pos + count - offset : 0;
+			if (last > len) last = len;
+			if (first < last)
+			{
+				Traits::copy(curr, chunk + first, last - first);
+				curr += last - first;
+			}
+			offset += len;
+		});
+		return count;
+	}
+
+	template<typename CharT, typename Traits>
+	inline typename BasicRope<CharT, Traits>::string_type BasicRope<CharT, Traits>::flatten() const
+	{
+		string_type ret;
+		ret.reserve(size());
+		for_each_chunk([&ret](const CharT* chunk, size_type n) { ret.append(chunk, n); });
+		return ret;
+	}
+
+	template<typename CharT, typename Traits>
+	inline int BasicRope<CharT, Traits>::compare(const BasicRope & rope) const
+	{
+		const_iterator lhs = begin(), rhs = rope.begin();
+		for (; lhs != end() && rhs != rope.end(); ++lhs, ++rhs)
+			if (!Traits::eq(*lhs, *rhs))
+				return Traits::lt(*lhs, *rhs) ? -1 : 1;
+		return size() < rope.size() ? -1 : size() > rope.size() ? 1 : 0;
+	}
+
+	template<typename CharT, typename Traits>
+	template<typename Function>
+	inline void BasicRope<CharT, Traits>::for_each_chunk(Function f) const
+	{
+		if (root) _for_each_chunk(root, f);
+	}
+
+	template<typename CharT, typename Traits>
+	inline typename BasicRope<CharT, Traits>::node_type * BasicRope<CharT, Traits>::_retain(node_type * node) noexcept
+	{
+		if (node) ++node->refcount;
+		return node;
+	}
+
+	template<typename CharT, typename Traits>
+	inline void BasicRope<CharT, Traits>::_release(node_type * node) noexcept
+	{
+		if (node == nullptr || --node->refcount != 0) return;
+		if (node->height == 0)
+		{
+			delete[] node->chars;
+		}
+		else
+		{
+			_release(node->left);
+			_release(node->right);
+		}
+		delete node;
+	}
+
+	template<typename CharT, typename Traits>
+	inline typename BasicRope<CharT, Traits>::size_type BasicRope<CharT, Traits>::_height(const node_type * node) noexcept
+	{
+		return node ? node->height : 0;
+	}
+
+	template<typename CharT, typename Traits>
+	inline typename BasicRope<CharT, Traits>::node_type * BasicRope<CharT, Traits>::_make_leaf(const CharT * s, size_type n, size_type capacity)
+	{
+		node_type* leaf = new node_type;
+		leaf->chars = new CharT[capacity];
+		leaf->capacity = capacity;
+		leaf->length = n;
+		Traits::copy(leaf->chars, s, n);
+		return leaf;
+	}
+
+	template<typename CharT, typename Traits>
+	inline typename BasicRope<CharT, Traits>::node_type * BasicRope<CharT, Traits>::_make_branch(node_type * left, node_type * right)
+	{
+		node_type* branch = new node_type;
+		branch->left = left;
+		branch->right = right;
+		branch->length = left->length + right->length;
+		branch->height = 1 + (left->height > right->height ? left->height : right->height);
+		return branch;
+	}
+
+	template<typename CharT, typename Traits>
+	inline typename BasicRope<CharT, Traits>::node_type * BasicRope<CharT, Traits>::_build(const CharT * s, size_type n)
+	{
+		if (n == 0) return nullptr;
+		if (n <= ROPE_LEAF_SIZE) return _make_leaf(s, n, n);
+		size_type leaves = (n + ROPE_LEAF_SIZE - 1) / ROPE_LEAF_SIZE;
+		size_type half = leaves / 2 * ROPE_LEAF_SIZE;
+		return _make_branch(_build(s, half), _build(s + half, n - half));
+	}
+
+	template<typename CharT, typename Traits>
+	inline typename BasicRope<CharT, Traits>::node_type * BasicRope<CharT, Traits>::_balance(node_type * left, node_type * right)
+	{
+		if (left->height > right->height + 1)
+		{
+			node_type* a = _retain(left->left);
+			node_type* b = _retain(left->right);
+			_release(left);
+			if (a->height >= b->height)	//Single rotation
+				return _make_branch(a, _make_branch(b, right));
+			node_type* b1 = _retain(b->left);	//Double rotation
+			node_type* b2 = _retain(b->right);
+			_release(b);
+			return _make_branch(_make_branch(a, b1), _make_branch(b2, right));
+		}
+		if (right->height > left->height + 1)
+		{
+			node_type* a = _retain(right->left);
+			node_type* b = _retain(right->right);
+			_release(right);
+			if (b->height >= a->height)
+				return _make_branch(_make_branch(left, a), b);
+			node_type* a1 = _retain(a->left);
+			node_type* a2 = _retain(a->right);
+			_release(a);
+			return _make_branch(_make_branch(left, a1), _make_branch(a2, b));
+		}
+		return _make_branch(left, right);
+	}
+
+	template<typename CharT, typename Traits>
+	inline typename BasicRope<CharT, Traits>::node_type * BasicRope<CharT, Traits>::_join(node_type * left, node_type * right)
+	{
+		if (left == nullptr) return right;
+		if (right == nullptr) return left;
+		//Walk down the spine of the taller tree until the heights match, copying only the nodes on the path
+		if (left->height > right->height + 1)
+		{
+			node_type* a = _retain(left->left);
+			node_type* b = _retain(left->right);
+			_release(left);
+			return _balance(a, _join(b, right));
+		}
+		if (right->height > left->height + 1)
+		{
+			node_type* a = _retain(right->left);
+			node_type* b = _retain(right->right);
+			_release(right);
+			return _balance(_join(left, a), b);
+		}
+		//Merge two short leaves instead of creating a tiny branch
+		size_type n = left->length + right->length;
+		if (left->height == 0 && right->height == 0 && n <= ROPE_LEAF_SIZE)
+		{
+			if (left->refcount == 1 && left->capacity >= n)
+			{
+				Traits::copy(left->chars + left->length, right->chars, right->length);
+				left->length = n;
+				_release(right);
+				return left;
+			}
+			node_type* leaf = _make_leaf(left->chars, left->length, ROPE_LEAF_SIZE);
+			Traits::copy(leaf->chars + left->length, right->chars, right->length);
+			leaf->length = n;
+			_release(left);
+			_release(right);
+			return leaf;
+		}
+		return _make_branch(left, right);
+	}
+
+	template<typename CharT, typename Traits>
+	inline void BasicRope<CharT, Traits>::_split(node_type * node, size_type pos, node_type *& left, node_type *& right)
+	{
+		if (node == nullptr || pos == 0)
+		{
+			left = nullptr;
+			right = node;
+			return;
+		}
+		if (pos >= node->length)
+		{
+			left = node;
+			right = nullptr;
+			return;
+		}
+		if (node->height == 0)
+		{
+			left = _make_leaf(node->chars, pos, pos);
+			right = _make_leaf(node->chars + pos, node->length - pos, node->length - pos);
+			_release(node);
+			return;
+		}
+		node_type* a = _retain(node->left);
+		node_type* b = _retain(node->right);
+		_release(node);
+		if (pos < a->length)
+		{
+			node_type* a2;
+			_split(a, pos, left, a2);
+			right = _join(a2, b);
+		}
+		else
+		{
+			node_type* b1;
+			_split(b, pos - a->length, b1, right);
+			left = _join(a, b1);
+		}
+	}
+
+	template<typename CharT, typename Traits>
+	template<typename Function>
+	inline void BasicRope<CharT, Traits>::_for_each_chunk(const node_type * node, Function & f)
+	{
+		if (node->height == 0)
+		{
+			f(static_cast<const CharT*>(node->chars), node->length);
+			return;
+		}
+		_for_each_chunk(node->left, f);
+		_for_each_chunk(node->right, f);
+	}
+
+	template<typename CharT, typename Traits>
+	inline const CharT * BasicRope<CharT, Traits>::_find_leaf(size_type pos, size_type & chunk_begin, size_type & chunk_end) const
+	{
+		const node_type* curr = root;
+		chunk_begin = 0;
+		while (curr->height != 0)
+		{
+			if (pos - chunk_begin < curr->left->length)
+			{
+				curr = curr->left;
+			}
+			else
+			{
+				chunk_begin += curr->left->length;
+				curr = curr->right;
+			}
+		}
+		chunk_end = chunk_begin + curr->length;
+		return curr->chars;
+	}
+
+	template<typename CharT, typename Traits>
+	inline bool BasicRope<CharT, Traits>::_append_in_place(const CharT * s, size_type n)
+	{
+		node_type* curr = root;
+		while (curr && curr->refcount == 1 && curr->height != 0)
+			curr = curr->right;
+		if (curr == nullptr || curr->refcount != 1 || curr->capacity - curr->length < n)
+			return false;
+		Traits::copy(curr->chars + curr->length, s, n);
+		for (curr = root; curr->height != 0; curr = curr->right)
+			curr->length += n;
+		curr->length += n;
+		return true;
+	}
+
+	template<typename CharT, typename Traits>
+	inline BasicRope<CharT, Traits> operator+(const BasicRope<CharT, Traits>& lhs, const BasicRope<CharT, Traits>& rhs)
+	{
+		return BasicRope<CharT, Traits>(lhs).append(rhs);
+	}
+
+	template<typename CharT, typename Traits>
+	inline BasicRope<CharT, Traits> operator+(const BasicRope<CharT, Traits>& lhs, const CharT* rhs)
+	{
+		return BasicRope<CharT, Traits>(lhs).append(rhs);
+	}
+
+	template<typename CharT, typename Traits>
+	inline BasicRope<CharT, Traits> operator+(const CharT* lhs, const BasicRope<CharT, Traits>& rhs)
+	{
+		return BasicRope<CharT, Traits>(lhs).append(rhs);
+	}
+
+	template<typename CharT, typename Traits>
+	inline bool operator==(const BasicRope<CharT, Traits>& lhs, const BasicRope<CharT, Traits>& rhs)
+	{
+		return lhs.size() == rhs.size() && lhs.compare(rhs) == 0;
+	}
+
+	template<typename CharT, typename Traits>
+	inline bool operator!=(const BasicRope<CharT, Traits>& lhs, const BasicRope<CharT, Traits>& rhs)
+	{
+		return !(lhs == rhs);
+	}
+
+	template<typename CharT, typename Traits>
+	inline bool operator<(const BasicRope<CharT, Traits>& lhs, const BasicRope<CharT, Traits>& rhs)
+	{
+		return lhs.compare(rhs) < 0;
+	}
+
+	template<typename CharT, typename Traits>
+	inline bool operator<=(const BasicRope<CharT, Traits>& lhs, const BasicRope<CharT, Traits>& rhs)
+	{
+		return lhs.compare(rhs) <= 0;
+	}
+
+	template<typename CharT, typename Traits>
+	inline bool operator>(const BasicRope<CharT, Traits>& lhs, const BasicRope<CharT, Traits>& rhs)
+	{
+		return lhs.compare(rhs) > 0;
+	}
+
+	template<typename CharT, typename Traits>
+	inline bool operator>=(const BasicRope<CharT, Traits>& lhs, const BasicRope<CharT, Traits>& rhs)
+	{
+		return lhs.compare(rhs) >= 0;
+	}
+
+	template<typename CharT, typename Traits>
+	inline void swap(BasicRope<CharT, Traits>& lhs, BasicRope<CharT, Traits>& rhs) noexcept
+	{
+		lhs.swap(rhs);
+	}
+
+	template<typename CharT, typename Traits>
+	inline std::basic_ostream<CharT, Traits>& operator<<(std::basic_ostream<CharT, Traits>& os, const BasicRope<CharT, Traits>& rope)
+	{
+		rope.for_each_chunk([&os](const CharT* chunk, size_t n) { os.write(chunk, n); });
+		return os;
+	}
+}
@@ -0,0 +1,345 @@
+#pragma once
+#include <cstddef>
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define DATASTRUCTURES_SSE2
+#include <emmintrin.h>
+#endif
+#if defined(__SSSE3__) || defined(__AVX__)
+#define DATASTRUCTURES_SSSE3		//Not implied by x64, MSVC defines __AVX__ under /arch:AVX
+#include <tmmintrin.h>
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace DataStructures
+{
+	//SSE2 building blocks for the string algorithms, 16 bytes per step with unaligned loads.
+	//Every function has a scalar fallback, used for the tail and when SSE2 is not available.
+
+	inline unsigned _count_trailing_zeros(unsigned x)	//x must not be 0
+	{
+#if defined(_MSC_VER)
+		unsigned long index;
+		_BitScanForward(&index, x);
+		return unsigned(index);
+#elif defined(__GNUC__)
+		return unsigned(__builtin_ctz(x));
+#else
+		unsigned n = 0;
+		for (; !(x & 1); x >>= 1) n++;
+		return n;
+#endif
+	}
+
+	inline unsigned _highest_set_bit(unsigned x)	//x must not be 0
+	{
+#if defined(_MSC_VER)
+		unsigned long index;
+		_BitScanReverse(&index, x);
+		return unsigned(index);
+#elif defined(__GNUC__)
+		return 31 - unsigned(__builtin_clz(x));
+#else
+		unsigned n = 0;
+		for (; x >>= 1;) n++;
+		return n;
+#endif
+	}
+
+	inline void _prefetch(const void* p)	//Only a hint, p need not be dereferenceable
+	{
+#if defined(DATASTRUCTURES_SSE2)
+		_mm_prefetch(static_cast<const char*>(p), _MM_HINT_T0);
+#elif defined(__GNUC__)
+		__builtin_prefetch(p);
+#endif
+	}
+
+	template<typename CharT>
+	inline bool _is_ascii_space(CharT c)	//" \t\n\v\f\r"
+	{
+		return c == CharT(' ') || (static_cast<unsigned long>(c) - '\t' < 5);
+	}
+
+	template<typename CharT>
+	inline CharT _ascii_lower(CharT c)
+	{
+		return c >= CharT('A') && c <= CharT('Z') ? CharT(c + ('a' - 'A')) : c;
+	}
+
+	template<typename CharT>
+	inline CharT _ascii_upper(CharT c)
+	{
+		return c >= CharT('a') && c <= CharT('z') ? CharT(c - ('a' - 'A')) : c;
+	}
+
+	//First ch in [first, last), or last
+	template<typename CharT>
+	inline const CharT* _find_char(const CharT* first, const CharT* last, CharT ch)
+	{
+		for (; first != last; ++first)
+			if (*first == ch) return first;
+		return last;
+	}
+
+#if defined(DATASTRUCTURES_SSE2)
+	inline const char* _find_char(const char* first, const char* last, char ch)
+	{
+		const __m128i needle = _mm_set1_epi8(ch);
+		if (last - first >= 16)
+		{
+			//One unaligned block, then aligned blocks of 64 bytes
+			unsigned mask = unsigned(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(first)), needle)));
+			if (mask) return first + _count_trailing_zeros(mask);
+			first = reinterpret_cast<const char*>((reinterpret_cast<size_t>(first) + 16) & ~size_t(15));
+			for (; last - first >= 64; first += 64)
+			{
+				const __m128i* block = reinterpret_cast<const __m128i*>(first);
+				__m128i a = _mm_cmpeq_epi8(_mm_load_si128(block), needle);
+				__m128i b = _mm_cmpeq_epi8(_mm_load_si128(block + 1), needle);
+				__m128i c = _mm_cmpeq_epi8(_mm_load_si128(block + 2), needle);
+				__m128i d = _mm_cmpeq_epi8(_mm_load_si128(block + 3), needle);
+				if (_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d))))
+				{
+					unsigned long long found = unsigned(_mm_movemask_epi8(a)) | unsigned(_mm_movemask_epi8(b)) << 16;
+					found |= static_cast<unsigned long long>(unsigned(_mm_movemask_epi8(c)) | unsigned(_mm_movemask_epi8(d)) << 16) << 32;
+					unsigned low = unsigned(found);
+					return low ? first + _count_trailing_zeros(low) : first + 32 + _count_trailing_zeros(unsigned(found >> 32));
+				}
+			}
+			for (; last - first >= 16; first += 16)
+			{
+				mask = unsigned(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_load_si128(reinterpret_cast<const __m128i*>(first)), needle)));
+				if (mask) return first + _count_trailing_zeros(mask);
+			}
+		}
+		for (; first != last; ++first)
+			if (*first == ch) return first;
+		return last;
+	}
+
+	inline const wchar_t* _find_char(const wchar_t* first, const wchar_t* last, wchar_t ch)
+	{
+		const size_t width = sizeof(wchar_t);	//2 on Windows, 4 elsewhere
+		const size_t step = 16 / width;
+		const __m128i needle = width == 2 ? _mm_set1_epi16(short(ch)) : _mm_set1_epi32(int(ch));
+		for (; size_t(last - first) >= step; first += step)
+		{
+			__m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first));
+			unsigned mask = unsigned(_mm_movemask_epi8(width == 2 ? _mm_cmpeq_epi16(chunk, needle) : _mm_cmpeq_epi32(chunk, needle)));
+			if (mask) return first + _count_trailing_zeros(mask) / width;
+		}
+		for (; first != last; ++first)
+			if (*first == ch) return first;
+		return last;
+	}
+#endif
+
+	template<typename CharT>
+	inline CharT* _find_char(CharT* first, CharT* last, CharT ch)
+	{
+		return const_cast<CharT*>(_find_char(const_cast<const CharT*>(first), const_cast<const CharT*>(last), ch));
+	}
+
+	//ASCII transforms and searches. Only ASCII letters and whitespace are looked at, every other character is
+	//left alone, so they are safe on UTF-8. The generic versions serve the other character types.
+
+	template<typename CharT>
+	inline void _ascii_to_lower(CharT* first, CharT* last)
+	{
+		for (; first != last; ++first) *first = _ascii_lower(*first);
+	}
+
+	template<typename CharT>
+	inline void _ascii_to_upper(CharT* first, CharT* last)
+	{
+		for (; first != last; ++first) *first = _ascii_upper(*first);
+	}
+
+	template<typename CharT>
+	inline void _replace_char(CharT* first, CharT* last, CharT from, CharT to)
+	{
+		for (; first != last; ++first)
+			if (*first == from) *first = to;
+	}
+
+	//First non-whitespace character in [first, last), or last
+	template<typename CharT>
+	inline const CharT* _skip_ascii_space(const CharT* first, const CharT* last)
+	{
+		for (; first != last && _is_ascii_space(*first); ++first);
+		return first;
+	}
+
+	//One past the last non-whitespace character in [first, last), or first
+	template<typename CharT>
+	inline const CharT* _skip_ascii_space_backward(const CharT* first, const CharT* last)
+	{
+		for (; last != first && _is_ascii_space(last[-1]); --last);
+		return last;
+	}
+
+	//First whitespace character in [first, last), or last
+	template<typename CharT>
+	inline const CharT* _find_ascii_space(const CharT* first, const CharT* last)
+	{
+		for (; first != last && !_is_ascii_space(*first); ++first);
+		return first;
+	}
+
+	//Index of the first position where a and b differ ignoring ASCII case, or n
+	template<typename CharT>
+	inline size_t _mismatch_ignore_case(const CharT* a, const CharT* b, size_t n)
+	{
+		size_t i = 0;
+		for (; i < n && _ascii_lower(a[i]) == _ascii_lower(b[i]); ++i);
+		return i;
+	}
+
+	//First occurrence of [s, s + n) in [first, last) ignoring ASCII case, or last
+	template<typename CharT>
+	inline const CharT* _find_ignore_case(const CharT* first, const CharT* last, const CharT* s, size_t n)
+	{
+		if (n == 0) return first;
+		if (size_t(last - first) < n) return last;
+		for (const CharT* stop = last - n + 1; first != stop; ++first)
+			if (_mismatch_ignore_case(first, s, n) == n) return first;
+		return last;
+	}
+
+#if defined(DATASTRUCTURES_SSE2)
+	//0xFF in every byte of x that is an ASCII letter in [low, low + 26). Shifts the range to the bottom of the signed bytes.
+	inline __m128i _sse2_letter_mask(__m128i x, char low)
+	{
+		return _mm_cmplt_epi8(_mm_add_epi8(x, _mm_set1_epi8(char(0x80 - low))), _mm_set1_epi8(char(0x80 + 26)));
+	}
+
+	inline __m128i _sse2_ascii_lower(__m128i x)
+	{
+		return _mm_or_si128(x, _mm_and_si128(_sse2_letter_mask(x, 'A'), _mm_set1_epi8(0x20)));
+	}
+
+	inline __m128i _sse2_ascii_upper(__m128i x)
+	{
+		return _mm_andnot_si128(_mm_and_si128(_sse2_letter_mask(x, 'a'), _mm_set1_epi8(0x20)), x);
+	}
+
+	inline unsigned _sse2_space_mask(const char* p)	//Bit i set if p[i] is whitespace
+	{
+		__m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+		__m128i space = _mm_cmpeq_epi8(x, _mm_set1_epi8(' '));
+		__m128i control = _mm_cmplt_epi8(_mm_add_epi8(x, _mm_set1_epi8(char(0x80 - '\t'))), _mm_set1_epi8(char(0x80 + 5)));
+		return unsigned(_mm_movemask_epi8(_mm_or_si128(space, control)));
+	}
+
+	//Applies block to every 16 bytes. A short tail is done again as the last 16 bytes, so block must give the same result twice.
+	template<typename BlockOp, typename CharOp>
+	inline void _transform_blocks(char* first, char* last, BlockOp block, CharOp ch)
+	{
+		if (last - first < 16)
+		{
+			for (; first != last; ++first) *first = ch(*first);
+			return;
+		}
+		char* curr = first;
+		for (; last - curr >= 16; curr += 16)
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(curr), block(_mm_loadu_si128(reinterpret_cast<const __m128i*>(curr))));
+		if (curr != last)
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(last - 16), block(_mm_loadu_si128(reinterpret_cast<const __m128i*>(last - 16))));
+	}
+
+	inline void _ascii_to_lower(char* first, char* last)
+	{
+		_transform_blocks(first, last, [](__m128i x) { return _sse2_ascii_lower(x); }, [](char c) { return _ascii_lower(c); });
+	}
+
+	inline void _ascii_to_upper(char* first, char* last)
+	{
+		_transform_blocks(first, last, [](__m128i x) { return _sse2_ascii_upper(x); }, [](char c) { return _ascii_upper(c); });
+	}
+
+	inline void _replace_char(char* first, char* last, char from, char to)
+	{
+		const __m128i old_value = _mm_set1_epi8(from), new_value = _mm_set1_epi8(to);
+		_transform_blocks(first, last,
+			[=](__m128i x)
+			{
+				__m128i hit = _mm_cmpeq_epi8(x, old_value);
+				return _mm_or_si128(_mm_and_si128(hit, new_value), _mm_andnot_si128(hit, x));
+			},
+			[=](char c) { return c == from ? to : c; });
+	}
+
+	inline const char* _skip_ascii_space(const char* first, const char* last)
+	{
+		for (; last - first >= 16; first += 16)
+		{
+			unsigned mask = ~_sse2_space_mask(first) & 0xFFFF;
+			if (mask) return first + _count_trailing_zeros(mask);
+		}
+		for (; first != last && _is_ascii_space(*first); ++first);
+		return first;
+	}
+
+	inline const char* _skip_ascii_space_backward(const char* first, const char* last)
+	{
+		for (; last - first >= 16; last -= 16)
+		{
+			unsigned mask = ~_sse2_space_mask(last - 16) & 0xFFFF;
+			if (mask) return last - 16 + _highest_set_bit(mask) + 1;
+		}
+		for (; last != first && _is_ascii_space(last[-1]); --last);
+		return last;
+	}
+
+	inline const char* _find_ascii_space(const char* first, const char* last)
+	{
+		for (; last - first >= 16; first += 16)
+		{
+			unsigned mask = _sse2_space_mask(first);
+			if (mask) return first + _count_trailing_zeros(mask);
+		}
+		for (; first != last && !_is_ascii_space(*first); ++first);
+		return first;
+	}
+
+	inline size_t _mismatch_ignore_case(const char* a, const char* b, size_t n)
+	{
+		size_t i = 0;
+		for (; n - i >= 16; i += 16)
+		{
+			__m128i x = _sse2_ascii_lower(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)));
+			__m128i y = _sse2_ascii_lower(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)));
+			unsigned mask = ~unsigned(_mm_movemask_epi8(_mm_cmpeq_epi8(x, y))) & 0xFFFF;
+			if (mask) return i + _count_trailing_zeros(mask);
+		}
+		for (; i < n && _ascii_lower(a[i]) == _ascii_lower(b[i]); ++i);
+		return i;
+	}
+
+	//Candidates are the positions where both the first and the last character of s match, 16 at a time,
+	//only those are compared in full
+	inline const char* _find_ignore_case(const char* first, const char* last, const char* s, size_t n)
+	{
+		if (n == 0) return first;
+		if (size_t(last - first) < n) return last;
+		const __m128i head = _mm_set1_epi8(_ascii_lower(s[0]));
+		const __m128i tail = _mm_set1_epi8(_ascii_lower(s[n - 1]));
+		const char* stop = last - n + 1;	//A match starts in [first, stop)
+		for (; stop - first >= 16; first += 16)
+		{
+			__m128i h = _mm_cmpeq_epi8(_sse2_ascii_lower(_mm_loadu_si128(reinterpret_cast<const __m128i*>(first))), head);
+			__m128i t = _mm_cmpeq_epi8(_sse2_ascii_lower(_mm_loadu_si128(reinterpret_cast<const __m128i*>(first + n - 1))), tail);
+			for (unsigned mask = unsigned(_mm_movemask_epi8(_mm_and_si128(h, t))); mask; mask &= mask - 1)
+			{
+				const char* candidate = first + _count_trailing_zeros(mask);
+				if (n < 3 || _mismatch_ignore_case(candidate + 1, s + 1, n - 2) == n - 2) return candidate;
+			}
+		}
+		for (; first != stop; ++first)
+			if (_mismatch_ignore_case(first, s, n) == n) return first;
+		return last;
+	}
+#endif
+}
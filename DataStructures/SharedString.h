@@ -0,0 +1,336 @@
+#pragma once
+#include <stdexcept>
+#include <iterator>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <utility>
+#include "BasicString.h"
+#include "BasicStringView.h"
+
+namespace DataStructures
+{
+	template<typename CharT = char, typename Traits = std::char_traits<CharT>> class BasicSharedString;
+	using SharedString = BasicSharedString<char>;
+	using WSharedString = BasicSharedString<wchar_t>;
+
+	//Immutable characters shared between any number of owners on any threads, for payloads that fan out to many consumers.
+	//A header with an atomic reference count sits in the same allocation as the characters, so copying is one increment
+	//and the last owner frees both at once. A string moved in keeps its buffer and only gets a header of its own.
+	//substr() shares the characters of the whole string and keeps them alive, so a slice is not null-terminated.
+	template<typename CharT, typename Traits>
+	class BasicSharedString
+	{
+	public:
+		using traits_type = Traits;
+		using value_type = CharT;
+		using size_type = size_t;
+		using difference_type = ptrdiff_t;
+		using const_reference = const CharT&;
+		using const_pointer = const CharT*;
+
+		using const_iterator = const CharT*;
+		using iterator = const_iterator;
+		using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+		using reverse_iterator = const_reverse_iterator;
+
+		static const size_type npos = -1;
+
+		//Constructor, Destructor and Assignment
+		BasicSharedString() noexcept = default;
+		BasicSharedString(const CharT* s, size_type n);
+		BasicSharedString(const CharT* s);
+		explicit BasicSharedString(BasicStringView<CharT, Traits> view);
+		template<class Allocator>
+		explicit BasicSharedString(const BasicString<CharT, Traits, Allocator>& str);
+		BasicSharedString(BasicString<CharT, Traits, MallocAllocator<CharT>>&& str);	//Takes the buffer, str is left empty
+		BasicSharedString(const BasicSharedString& other) noexcept;
+		BasicSharedString(BasicSharedString&& other) noexcept;
+		~BasicSharedString();
+		BasicSharedString& operator=(const BasicSharedString& other) noexcept;
+		BasicSharedString& operator=(BasicSharedString&& other) noexcept;
+
+		//Element access
+		const_reference at(size_type index) const;	//Check and throw out_of_range exception
+		const_reference operator[](size_type index) const;
+		const_reference front() const;
+		const_reference back() const;
+		const CharT* data() const noexcept;
+
+		//Iterators
+		const_iterator begin() const noexcept;
+		const_iterator cbegin() const noexcept;
+		const_iterator end() const noexcept;
+		const_iterator cend() const noexcept;
+		const_reverse_iterator rbegin() const noexcept;
+		const_reverse_iterator rend() const noexcept;
+
+		//Capacity
+		bool empty() const noexcept;
+		size_type size() const noexcept;
+		size_type length() const noexcept;
+		size_t use_count() const noexcept;			//Owners of the characters, 0 if there are none
+
+		//Operations
+		BasicSharedString substr(size_type pos = 0, size_type n = npos) const;	//Shares the characters
+		BasicStringView<CharT, Traits> view() const noexcept;
+		operator BasicStringView<CharT, Traits>() const noexcept;
+		BasicString<CharT, Traits> str() const;		//Copies the characters
+		void swap(BasicSharedString& other) noexcept;
+
+	private:
+		struct Header
+		{
+			std::atomic<size_t> references;
+			CharT* adopted;							//Buffer taken from a BasicString, null if the characters follow the header
+			size_t adopted_size;
+		};
+
+		Header* header = nullptr;
+		const CharT* first = nullptr;
+		size_type string_length = 0;
+
+		//Helper functions
+		inline void _allocate(const CharT* s, size_type n);
+		inline void _release() noexcept;
+	};
+
+	/* Dividing Line ( 㧥 ;) ( 㧥 ;) ( 㧥 ;)  */
+
+	template<typename CharT, typename Traits>
+	inline BasicSharedString<CharT, Traits>::BasicSharedString(const CharT * s, size_type n)
+	{
+		_allocate(s, n);
+	}
+
+	template<typename CharT, typename Traits>
+	inline BasicSharedString<CharT, Traits>::BasicSharedString(const CharT * s)
+	{
+		_allocate(s, Traits::length(s));
+	}
+
+	template<typename CharT, typename Traits>
+	inline BasicSharedString<CharT, Traits>::BasicSharedString(BasicStringView<CharT, Traits> view)
+	{
+		_allocate(view.data(), view.size());
+	}
+
+	template<typename CharT, typename Traits>
+	template<class Allocator>
+	inline BasicSharedString<CharT, Traits>::BasicSharedString(const BasicString<CharT, Traits, Allocator>& str)
+	{
+		_allocate(str.data(), str.size());
+	}
+
+	template<typename CharT, typename Traits>
+	inline BasicSharedString<CharT, Traits>::BasicSharedString(BasicString<CharT, Traits, MallocAllocator<CharT>>&& str)
+	{
+		if (!str.storage || str.string_length == 0) return;
+		Header* adopting = static_cast<Header*>(malloc(sizeof(Header)));
+		if (!adopting) throw std::bad_alloc{};
+		header = new (adopting) Header{ { 1 }, reinterpret_cast<CharT*>(str.storage), str.reserved_size + 1 };
+		first = header->adopted;
+		string_length = str.string_length;
+		str.storage = nullptr;
+		str.string_length = 0;
+		str.reserved_size = 0;
+	}
+
+	template<typename CharT, typename Traits>
+	inline BasicSharedString<CharT, Traits>::BasicSharedString(const BasicSharedString & other) noexcept
+		: header(other.header), first(other.first), string_length(other.string_length)
+	{
+		if (header)
+			header->references.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	template<typename CharT, typename Traits>
+	inline BasicSharedString<CharT, Traits>::BasicSharedString(BasicSharedString && other) noexcept
+	{
+		swap(other);
+	}
+
+	template<typename CharT, typename Traits>
+	inline BasicSharedString<CharT, Traits>::~BasicSharedString()
+	{
+		_release();
+	}
+
+	template<typename CharT, typename Traits>
+	inline BasicSharedString<CharT, Traits> & BasicSharedString<CharT, Traits>::operator=(const BasicSharedString & other) noexcept
+	{
+		BasicSharedString copy(other);
+		swap(copy);
+		return *this;
+	}
+
+	template<typename CharT, typename Traits>
+	inline BasicSharedString<CharT, Traits> & BasicSharedString<CharT, Traits>::operator=(BasicSharedString && other) noexcept
+	{
+		BasicSharedString moved(std::move(other));
+		swap(moved);
+		return *this;
+	}
+
+	template<typename CharT, typename Traits>
+	inline void BasicSharedString<CharT, Traits>::_allocate(const CharT * s, size_type n)
+	{
+		if (n == 0) return;
+		void* block = malloc(sizeof(Header) + (n + 1) * sizeof(CharT));
+		if (!block) throw std::bad_alloc{};
+		header = new (block) Header{ { 1 }, nullptr, 0 };
+		CharT* characters = reinterpret_cast<CharT*>(header + 1);
+		Traits::copy(characters, s, n);
+		Traits::assign(characters[n], CharT());
+		first = characters;
+		string_length = n;
+	}
+
+	template<typename CharT, typename Traits>
+	inline void BasicSharedString<CharT, Traits>::_release() noexcept
+	{
+		//The last owner must see every write made through the others before freeing
+		if (header && header->references.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		{
+			if (header->adopted)
+				MallocAllocator<CharT>().deallocate(header->adopted, header->adopted_size);
+			header->~Header();
+			free(header);
+		}
+		header = nullptr;
+		first = nullptr;
+		string_length = 0;
+	}
+
+	template<typename CharT, typename Traits>
+	inline typename BasicSharedString<CharT, Traits>::const_reference BasicSharedString<CharT, Traits>::at(size_type index) const
+	{
+		if (index >= string_length)
+			throw std::out_of_range{ "Accessed position is out of range!" };
+		return first[index];
+	}
+
+	template<typename CharT, typename Traits>
+	inline typename BasicSharedString<CharT, Traits>::const_reference BasicSharedString<CharT, Traits>::operator[](size_type index) const
+	{
+		return first[index];
+	}
+
+	template<typename CharT, typename Traits>
+	inline typename BasicSharedString<CharT, Traits>::const_reference BasicSharedString<CharT, Traits>::front() const
+	{
+		return first[0];
+	}
+
+	template<typename CharT, typename Traits>
+	inline typename BasicSharedString<CharT, Traits>::const_reference BasicSharedString<CharT, Traits>::back() const
+	{
+		return first[string_length - 1];
+	}
+
+	template<typename CharT, typename Traits>
+	inline const CharT * BasicSharedString<CharT, Traits>::data() const noexcept
+	{
+		return first;
+	}
+
+	template<typename CharT, typename Traits>
+	inline typename BasicSharedString<CharT, Traits>::const_iterator BasicSharedString<CharT, Traits>::begin() const noexcept
+	{
+		return first;
+	}
+
+	template<typename CharT, typename Traits>
+	inline typename BasicSharedString<CharT, Traits>::const_iterator BasicSharedString<CharT, Traits>::cbegin() const noexcept
+	{
+		return first;
+	}
+
+	template<typename CharT, typename Traits>
+	inline typename BasicSharedString<CharT, Traits>::const_iterator BasicSharedString<CharT, Traits>::end() const noexcept
+	{
+		return first + string_length;
+	}
+
+	template<typename CharT, typename Traits>
+	inline typename BasicSharedString<CharT, Traits>::const_iterator BasicSharedString<CharT, Traits>::cend() const noexcept
+	{
+		return first + string_length;
+	}
+
+	template<typename CharT, typename Traits>
+	inline typename BasicSharedString<CharT, Traits>::const_reverse_iterator BasicSharedString<CharT, Traits>::rbegin() const noexcept
+	{
+		return const_reverse_iterator(end());
+	}
+
+	template<typename CharT, typename Traits>
+	inline typename BasicSharedString<CharT, Traits>::const_reverse_iterator BasicSharedString<CharT, Traits>::rend() const noexcept
+	{
+		return const_reverse_iterator(begin());
+	}
+
+	template<typename CharT, typename Traits>
+	inline bool BasicSharedString<CharT, Traits>::empty() const noexcept
+	{
+		return string_length == 0;
+	}
+
+	template<typename CharT, typename Traits>
+	inline typename BasicSharedString<CharT, Traits>::size_type BasicSharedString<CharT, Traits>::size() const noexcept
+	{
+		return string_length;
+	}
+
+	template<typename CharT, typename Traits>
+	inline typename BasicSharedString<CharT, Traits>::size_type BasicSharedString<CharT, Traits>::length() const noexcept
+	{
+		return string_length;
+	}
+
+	template<typename CharT, typename Traits>
+	inline size_t BasicSharedString<CharT, Traits>::use_count() const noexcept
+	{
+		return header ? header->references.load(std::memory_order_relaxed) : 0;
+	}
+
+	template<typename CharT, typename Traits>
+	inline BasicSharedString<CharT, Traits> BasicSharedString<CharT, Traits>::substr(size_type pos, size_type n) const
+	{
+		if (pos > string_length)
+			throw std::out_of_range{ "Accessed position is out of range!" };
+		BasicSharedString slice;
+		n = n < string_length - pos ? n : string_length - pos;
+		if (n == 0) return slice;
+		slice = *this;
+		slice.first += pos;
+		slice.string_length = n;
+		return slice;
+	}
+
+	template<typename CharT, typename Traits>
+	inline BasicStringView<CharT, Traits> BasicSharedString<CharT, Traits>::view() const noexcept
+	{
+		return BasicStringView<CharT, Traits>(first, string_length);
+	}
+
+	template<typename CharT, typename Traits>
+	inline BasicSharedString<CharT, Traits>::operator BasicStringView<CharT, Traits>() const noexcept
+	{
+		return view();
+	}
+
+	template<typename CharT, typename Traits>
+	inline BasicString<CharT, Traits> BasicSharedString<CharT, Traits>::str() const
+	{
+		return BasicString<CharT, Traits>(first, string_length);
+	}
+
+	template<typename CharT, typename Traits>
+	inline void BasicSharedString<CharT, Traits>::swap(BasicSharedString & other) noexcept
+	{
+		std::swap(header, other.header);
+		std::swap(first, other.first);
+		std::swap(string_length, other.string_length);
+	}
+}
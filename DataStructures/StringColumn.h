@@ -0,0 +1,389 @@
+#pragma once
+#include <stdexcept>
+#include <iterator>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include "BasicString.h"
+#include "BasicStringView.h"
+#include "Vector.h"
+
+namespace DataStructures
+{
+	class StringColumn;
+
+	enum class StringEncoding { Plain, Dictionary };
+
+	//Many short strings in one contiguous buffer, for columns of millions of rows where a Vector<String> would pay a header
+	//and a heap block per row. Row i is the characters between offsets[i] and offsets[i + 1], so a row costs 4 bytes
+	//besides its characters. Offsets are 32-bit, a column holds at most 4GB of characters.
+	//Dictionary encoding stores every distinct value once and a 32-bit code per row instead, which suits low-cardinality data
+	//such as country names or status strings. Comparing a row to a value is then comparing two codes.
+	//Rows are read as StringView, which stays valid until the column is modified.
+	class StringColumn
+	{
+	public:
+		class const_iterator;
+
+		static const size_t npos = -1;
+
+		//Constructor
+		explicit StringColumn(StringEncoding _encoding = StringEncoding::Plain);
+		StringColumn(std::initializer_list<StringView> values, StringEncoding _encoding = StringEncoding::Plain);
+		template<typename InputIterator>
+		StringColumn(InputIterator first, InputIterator last, StringEncoding _encoding = StringEncoding::Plain);	//Of anything convertible to StringView
+
+		//Element access
+		StringView operator[](size_t row) const;	//No check
+		StringView at(size_t row) const;			//Check and throw out_of_range exception
+		StringView front() const;
+		StringView back() const;
+
+		//Iterators
+		const_iterator begin() const noexcept;
+		const_iterator end() const noexcept;
+
+		//Capacity
+		bool empty() const noexcept;
+		size_t size() const noexcept;
+		size_t memory_usage() const noexcept;		//Bytes allocated for characters, offsets, codes and the dictionary index
+		void reserve(size_t rows, size_t characters);
+		void shrink_to_fit();
+
+		//Modifiers
+		void push_back(StringView value);
+		void pop_back();							//A dictionary keeps the value
+		void clear() noexcept;
+
+		//Dictionary encoding
+		StringEncoding encoding() const noexcept;
+		void dictionary_encode();
+		void decode();
+		size_t dictionary_size() const noexcept;	//Distinct values of an encoded column
+		uint32_t code(size_t row) const;			//Check and throw out_of_range exception, or logic_error if not encoded
+		StringView dictionary_value(uint32_t code) const;
+
+		//Operations
+		size_t count(StringView value) const;		//Rows equal to value
+		size_t find(StringView value, size_t pos = 0) const;
+
+	private:
+		enum : uint32_t { NONE = uint32_t(-1) };
+
+		StringEncoding column_encoding;
+		String characters;							//Every row, or every dictionary value
+		Vector<uint32_t> offsets;					//One more than the rows or dictionary values
+		Vector<uint32_t> codes;						//Rows of an encoded column
+		Vector<uint32_t> slots;						//Open addressing index from value to code, empty slots are NONE
+
+		//Helper functions
+		inline StringView _value(uint32_t index) const noexcept;
+		inline void _append_value(StringView value);
+		inline static size_t _hash(StringView value) noexcept;
+		inline size_t _slot(StringView value) const noexcept;	//Slot holding value's code, or the empty slot where it goes
+		inline uint32_t _find_code(StringView value) const noexcept;
+		inline void _rehash(size_t slot_count);
+	};
+
+	//Yields each row as a StringView
+	class StringColumn::const_iterator
+	{
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = StringView;
+		using difference_type = ptrdiff_t;
+		using pointer = const StringView*;
+		using reference = StringView;
+
+		const_iterator() noexcept = default;
+		const_iterator(const StringColumn* _column, size_t _row) noexcept : column(_column), row(_row) {}
+
+		StringView operator*() const noexcept;
+		const_iterator& operator++() noexcept;
+		const_iterator operator++(int) noexcept;
+		bool operator==(const const_iterator& other) const noexcept;
+		bool operator!=(const const_iterator& other) const noexcept;
+
+	private:
+		const StringColumn* column = nullptr;
+		size_t row = 0;
+	};
+
+	/* Dividing Line ( 㧥 ;) ( 㧥 ;) ( 㧥 ;)  */
+
+	inline StringColumn::StringColumn(StringEncoding _encoding) : column_encoding(_encoding)
+	{
+		offsets.push_back(0);
+	}
+
+	inline StringColumn::StringColumn(std::initializer_list<StringView> values, StringEncoding _encoding) : StringColumn(_encoding)
+	{
+		for (const StringView& value : values)
+			push_back(value);
+	}
+
+	template<typename InputIterator>
+	inline StringColumn::StringColumn(InputIterator first, InputIterator last, StringEncoding _encoding) : StringColumn(_encoding)
+	{
+		for (; first != last; ++first)
+			push_back(StringView(*first));
+	}
+
+	inline StringView StringColumn::operator[](size_t row) const
+	{
+		return _value(column_encoding == StringEncoding::Dictionary ? codes[row] : uint32_t(row));
+	}
+
+	inline StringView StringColumn::at(size_t row) const
+	{
+		if (row >= size())
+			throw std::out_of_range{ "Accessed position is out of range!" };
+		return (*this)[row];
+	}
+
+	inline StringView StringColumn::front() const
+	{
+		return (*this)[0];
+	}
+
+	inline StringView StringColumn::back() const
+	{
+		return (*this)[size() - 1];
+	}
+
+	inline StringColumn::const_iterator StringColumn::begin() const noexcept
+	{
+		return const_iterator(this, 0);
+	}
+
+	inline StringColumn::const_iterator StringColumn::end() const noexcept
+	{
+		return const_iterator(this, size());
+	}
+
+	inline bool StringColumn::empty() const noexcept
+	{
+		return size() == 0;
+	}
+
+	inline size_t StringColumn::size() const noexcept
+	{
+		return column_encoding == StringEncoding::Dictionary ? codes.size() : offsets.size() - 1;
+	}
+
+	inline size_t StringColumn::memory_usage() const noexcept
+	{
+		return characters.capacity() + 1 + (offsets.capacity() + codes.capacity() + slots.capacity()) * sizeof(uint32_t);
+	}
+
+	inline void StringColumn::reserve(size_t rows, size_t _characters)
+	{
+		//An encoded column's characters and offsets belong to the dictionary, which is usually far smaller than the rows
+		if (column_encoding == StringEncoding::Dictionary)
+			codes.reserve(rows);
+		else
+		{
+			offsets.reserve(rows + 1);
+			characters.reserve(_characters);
+		}
+	}
+
+	inline void StringColumn::shrink_to_fit()
+	{
+		characters.shrink_to_fit();
+		offsets.shrink_to_fit();
+		codes.shrink_to_fit();
+	}
+
+	inline void StringColumn::push_back(StringView value)
+	{
+		if (column_encoding == StringEncoding::Plain)
+		{
+			_append_value(value);
+			return;
+		}
+		if ((offsets.size() - 1) * 2 >= slots.size())
+			_rehash(slots.size() ? slots.size() * 2 : 16);
+		size_t slot = _slot(value);
+		if (slots[slot] == NONE)
+		{
+			slots[slot] = uint32_t(offsets.size() - 1);
+			_append_value(value);
+		}
+		codes.push_back(slots[slot]);
+	}
+
+	inline void StringColumn::pop_back()
+	{
+		if (column_encoding == StringEncoding::Dictionary)
+			codes.pop_back();
+		else
+		{
+			offsets.pop_back();
+			characters.resize(offsets.back());
+		}
+	}
+
+	inline void StringColumn::clear() noexcept
+	{
+		characters.clear();
+		offsets.clear();
+		offsets.push_back(0);
+		codes.clear();
+		for (uint32_t& slot : slots)
+			slot = NONE;
+	}
+
+	inline StringEncoding StringColumn::encoding() const noexcept
+	{
+		return column_encoding;
+	}
+
+	inline void StringColumn::dictionary_encode()
+	{
+		if (column_encoding == StringEncoding::Dictionary) return;
+		StringColumn encoded(StringEncoding::Dictionary);
+		encoded.codes.reserve(size());
+		for (StringView value : *this)
+			encoded.push_back(value);
+		encoded.shrink_to_fit();
+		*this = std::move(encoded);
+	}
+
+	inline void StringColumn::decode()
+	{
+		if (column_encoding == StringEncoding::Plain) return;
+		StringColumn decoded;
+		size_t total = 0;
+		for (uint32_t row_code : codes)
+			total += offsets[row_code + 1] - offsets[row_code];
+		decoded.reserve(size(), total);
+		for (StringView value : *this)
+			decoded.push_back(value);
+		*this = std::move(decoded);
+	}
+
+	inline size_t StringColumn::dictionary_size() const noexcept
+	{
+		return column_encoding == StringEncoding::Dictionary ? offsets.size() - 1 : 0;
+	}
+
+	inline uint32_t StringColumn::code(size_t row) const
+	{
+		if (column_encoding != StringEncoding::Dictionary)
+			throw std::logic_error{ "Column is not dictionary encoded!" };
+		if (row >= codes.size())
+			throw std::out_of_range{ "Accessed position is out of range!" };
+		return codes[row];
+	}
+
+	inline StringView StringColumn::dictionary_value(uint32_t code) const
+	{
+		if (code >= dictionary_size())
+			throw std::out_of_range{ "Accessed position is out of range!" };
+		return _value(code);
+	}
+
+	inline size_t StringColumn::count(StringView value) const
+	{
+		size_t n = 0;
+		if (column_encoding == StringEncoding::Dictionary)
+		{
+			uint32_t target = _find_code(value);
+			if (target == NONE) return 0;
+			for (uint32_t row_code : codes)
+				n += row_code == target;
+			return n;
+		}
+		const uint32_t* offset = offsets.data();
+		const char* first = characters.data();
+		for (size_t row = 0, rows = size(); row < rows; row++)
+			n += offset[row + 1] - offset[row] == value.size() && memcmp(first + offset[row], value.data(), value.size()) == 0;
+		return n;
+	}
+
+	inline size_t StringColumn::find(StringView value, size_t pos) const
+	{
+		if (column_encoding == StringEncoding::Dictionary)
+		{
+			uint32_t target = _find_code(value);
+			if (target == NONE) return npos;
+			for (size_t row = pos; row < codes.size(); row++)
+				if (codes[row] == target) return row;
+			return npos;
+		}
+		for (size_t row = pos, rows = size(); row < rows; row++)
+			if (_value(uint32_t(row)) == value) return row;
+		return npos;
+	}
+
+	inline StringView StringColumn::_value(uint32_t index) const noexcept
+	{
+		return StringView(characters.data() + offsets[index], offsets[index + 1] - offsets[index]);
+	}
+
+	inline void StringColumn::_append_value(StringView value)
+	{
+		if (value.size() > size_t(UINT32_MAX) - characters.size())
+			throw std::length_error{ "StringColumn exceeds 4GB of characters!" };
+		characters.append(value.data(), value.size());
+		offsets.push_back(uint32_t(characters.size()));
+	}
+
+	inline size_t StringColumn::_hash(StringView value) noexcept
+	{
+		//FNV-1a
+		uint64_t hash = 14695981039346656037ULL;
+		for (char ch : value)
+			hash = (hash ^ static_cast<unsigned char>(ch)) * 1099511628211ULL;
+		return size_t(hash ^ (hash >> 32));
+	}
+
+	inline size_t StringColumn::_slot(StringView value) const noexcept
+	{
+		size_t mask = slots.size() - 1;
+		for (size_t i = _hash(value) & mask; ; i = (i + 1) & mask)
+			if (slots[i] == NONE || _value(slots[i]) == value) return i;
+	}
+
+	inline uint32_t StringColumn::_find_code(StringView value) const noexcept
+	{
+		return slots.empty() ? NONE : slots[_slot(value)];
+	}
+
+	inline void StringColumn::_rehash(size_t slot_count)
+	{
+		slots.clear();
+		slots.resize(slot_count, NONE);
+		for (uint32_t index = 0; index + 1 < offsets.size(); index++)
+			slots[_slot(_value(index))] = index;
+	}
+
+	inline StringView StringColumn::const_iterator::operator*() const noexcept
+	{
+		return (*column)[row];
+	}
+
+	inline StringColumn::const_iterator & StringColumn::const_iterator::operator++() noexcept
+	{
+		++row;
+		return *this;
+	}
+
+	inline StringColumn::const_iterator StringColumn::const_iterator::operator++(int) noexcept
+	{
+		const_iterator before(*this);
+		++row;
+		return before;
+	}
+
+	inline bool StringColumn::const_iterator::operator==(const const_iterator & other) const noexcept
+	{
+		return row == other.row && column == other.column;
+	}
+
+	inline bool StringColumn::const_iterator::operator!=(const const_iterator & other) const noexcept
+	{
+		return !(*this == other);
+	}
+}
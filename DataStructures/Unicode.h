@@ -0,0 +1,518 @@
+#pragma once
+#include <stdexcept>
+#include <iterator>
+#include <cstring>
+#include "BasicString.h"
+#include "BasicStringView.h"
+#include "SIMD.h"
+
+namespace DataStructures
+{
+	class Utf8Iterator;
+	class Utf8CodePoints;
+
+	constexpr char32_t REPLACEMENT_CHARACTER = 0xFFFD;
+
+	//UTF-8 validation, code point iteration and transcoding between UTF-8, UTF-16 and UTF-32.
+	//Runs of ASCII are copied 16 bytes at a time. With SSSE3 the validator checks any 16 bytes at once with the lookup tables of
+	//Keiser and Lemire, "Validating UTF-8 In Less Than One Instruction Per Byte", otherwise it skips ASCII blocks and decodes the rest.
+	//Strings convert to views, so every function takes a BasicString as well.
+
+	bool validate_utf8(StringView text) noexcept;
+	size_t count_code_points(StringView text) noexcept;	//Of valid UTF-8: every byte that is not a continuation byte
+	Utf8CodePoints code_points(StringView text) noexcept;
+
+	//Throw invalid_argument on malformed input
+	U16String utf8_to_utf16(StringView text);
+	U32String utf8_to_utf32(StringView text);
+	String utf16_to_utf8(U16StringView text);
+	String utf32_to_utf8(U32StringView text);
+
+	//Forward iterator over the code points of UTF-8 text. A malformed sequence gives U+FFFD and skips one byte.
+	class Utf8Iterator
+	{
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = char32_t;
+		using difference_type = ptrdiff_t;
+		using pointer = const char32_t*;
+		using reference = char32_t;
+
+		Utf8Iterator() noexcept = default;
+		Utf8Iterator(const char* _curr, const char* _last) noexcept;
+
+		char32_t operator*() const noexcept;
+		Utf8Iterator& operator++() noexcept;
+		Utf8Iterator operator++(int) noexcept;
+		bool operator==(const Utf8Iterator& other) const noexcept;
+		bool operator!=(const Utf8Iterator& other) const noexcept;
+		const char* base() const noexcept;			//First byte of the current code point
+
+	private:
+		const char* curr = nullptr;
+		const char* next = nullptr;
+		const char* last = nullptr;
+		char32_t value = 0;
+
+		inline void _decode() noexcept;
+	};
+
+	class Utf8CodePoints
+	{
+	public:
+		explicit Utf8CodePoints(StringView _text) noexcept : text(_text) {}
+		Utf8Iterator begin() const noexcept;
+		Utf8Iterator end() const noexcept;
+
+	private:
+		StringView text;
+	};
+
+	/* Dividing Line ( 㧥 ;) ( 㧥 ;) ( 㧥 ;)  */
+
+	//Decodes the code point at curr, returns one past it, or null if the sequence is malformed.
+	//The range of the second byte rules out overlong forms, surrogates and values above U+10FFFF.
+	inline const unsigned char* _decode_utf8(const unsigned char* curr, const unsigned char* last, char32_t& code_point) noexcept
+	{
+		unsigned lead = curr[0];
+		if (lead < 0x80)
+		{
+			code_point = lead;
+			return curr + 1;
+		}
+		if (lead < 0xC2) return nullptr;	//A continuation byte, or an overlong two byte form
+		if (lead < 0xE0)
+		{
+			if (last - curr < 2 || (curr[1] & 0xC0) != 0x80) return nullptr;
+			code_point = ((lead & 0x1F) << 6) | (curr[1] & 0x3F);
+			return curr + 2;
+		}
+		if (lead < 0xF0)
+		{
+			if (last - curr < 3) return nullptr;
+			unsigned second = curr[1];
+			if (second < (lead == 0xE0 ? 0xA0U : 0x80U) || second > (lead == 0xED ? 0x9FU : 0xBFU) || (curr[2] & 0xC0) != 0x80) return nullptr;
+			code_point = ((lead & 0x0F) << 12) | ((second & 0x3F) << 6) | (curr[2] & 0x3F);
+			return curr + 3;
+		}
+		if (lead < 0xF5)
+		{
+			if (last - curr < 4) return nullptr;
+			unsigned second = curr[1];
+			if (second < (lead == 0xF0 ? 0x90U : 0x80U) || second > (lead == 0xF4 ? 0x8FU : 0xBFU) || (curr[2] & 0xC0) != 0x80 || (curr[3] & 0xC0) != 0x80) return nullptr;
+			code_point = ((lead & 0x07) << 18) | ((second & 0x3F) << 12) | ((curr[2] & 0x3F) << 6) | (curr[3] & 0x3F);
+			return curr + 4;
+		}
+		return nullptr;
+	}
+
+	inline char* _encode_utf8(char32_t code_point, char* out) noexcept
+	{
+		if (code_point < 0x80)
+			*out++ = char(code_point);
+		else if (code_point < 0x800)
+		{
+			*out++ = char(0xC0 | (code_point >> 6));
+			*out++ = char(0x80 | (code_point & 0x3F));
+		}
+		else if (code_point < 0x10000)
+		{
+			*out++ = char(0xE0 | (code_point >> 12));
+			*out++ = char(0x80 | ((code_point >> 6) & 0x3F));
+			*out++ = char(0x80 | (code_point & 0x3F));
+		}
+		else
+		{
+			*out++ = char(0xF0 | (code_point >> 18));
+			*out++ = char(0x80 | ((code_point >> 12) & 0x3F));
+			*out++ = char(0x80 | ((code_point >> 6) & 0x3F));
+			*out++ = char(0x80 | (code_point & 0x3F));
+		}
+		return out;
+	}
+
+	inline bool _is_ascii_block(const unsigned char* p) noexcept	//8 bytes
+	{
+		unsigned long long block;
+		memcpy(&block, p, 8);
+		return (block & 0x8080808080808080) == 0;
+	}
+
+	inline bool _validate_utf8_scalar(const unsigned char* curr, const unsigned char* last) noexcept
+	{
+		while (curr != last)
+		{
+			if (last - curr >= 8 && _is_ascii_block(curr))
+			{
+				curr += 8;
+				continue;
+			}
+			if (*curr < 0x80)
+			{
+				++curr;
+				continue;
+			}
+			char32_t ignored;
+			curr = _decode_utf8(curr, last, ignored);
+			if (!curr) return false;
+		}
+		return true;
+	}
+
+	//Number of bytes in [curr, last) with low < byte <= high, compared as signed char
+	inline size_t _count_bytes_between(const unsigned char* curr, const unsigned char* last, signed char low, signed char high) noexcept
+	{
+		size_t count = 0;
+#if defined(DATASTRUCTURES_SSE2)
+		const __m128i lower = _mm_set1_epi8(low);
+		const __m128i upper = _mm_set1_epi8(high);
+		while (last - curr >= 16)
+		{
+			//Byte counters are summed up before they can overflow
+			size_t blocks = size_t(last - curr) / 16 < 255 ? size_t(last - curr) / 16 : 255;
+			__m128i counters = _mm_setzero_si128();
+			for (size_t i = 0; i < blocks; i++, curr += 16)
+			{
+				__m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(curr));
+				counters = _mm_sub_epi8(counters, _mm_andnot_si128(_mm_cmpgt_epi8(block, upper), _mm_cmpgt_epi8(block, lower)));
+			}
+			__m128i sums = _mm_sad_epu8(counters, _mm_setzero_si128());
+			count += size_t(_mm_cvtsi128_si32(sums)) + size_t(_mm_cvtsi128_si32(_mm_srli_si128(sums, 8)));
+		}
+#endif
+		for (; curr != last; ++curr)
+			count += static_cast<signed char>(*curr) > low && static_cast<signed char>(*curr) <= high;
+		return count;
+	}
+
+#if defined(DATASTRUCTURES_SSSE3)
+	//Errors in a block of 16 bytes given the block before it. Every pair of adjacent bytes is classified through three
+	//16-entry tables, indexed by the high and low nibble of the first byte and the high nibble of the second, whose AND
+	//is non-zero only for an invalid pair. Continuation bytes that belong to a three or four byte sequence are checked
+	//against the lead two and three bytes back.
+	inline __m128i _utf8_block_errors(__m128i input, __m128i prev_input) noexcept
+	{
+		const char TOO_SHORT = 1 << 0;			//Lead byte followed by a lead or ASCII byte
+		const char TOO_LONG = 1 << 1;			//ASCII byte followed by a continuation byte
+		const char OVERLONG_3 = 1 << 2;
+		const char TOO_LARGE = 1 << 3;			//Above U+10FFFF
+		const char SURROGATE = 1 << 4;
+		const char OVERLONG_2 = 1 << 5;
+		const char TOO_LARGE_1000 = 1 << 6;
+		const char OVERLONG_4 = 1 << 6;
+		const char TWO_CONTS = char(1 << 7);	//Two continuation bytes in a row
+		const char CARRY = TOO_SHORT | TOO_LONG | TWO_CONTS;
+
+		const __m128i byte_1_high_table = _mm_setr_epi8(
+			TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,
+			TWO_CONTS, TWO_CONTS, TWO_CONTS, TWO_CONTS,
+			TOO_SHORT | OVERLONG_2,
+			TOO_SHORT,
+			TOO_SHORT | OVERLONG_3 | SURROGATE,
+			TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4);
+		const __m128i byte_1_low_table = _mm_setr_epi8(
+			CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4,
+			CARRY | OVERLONG_2,
+			CARRY,
+			CARRY,
+			CARRY | TOO_LARGE,
+			CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000,
+			CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000,
+			CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000,
+			CARRY | TOO_LARGE | TOO_LARGE_1000 | SURROGATE,
+			CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000);
+		const __m128i byte_2_high_table = _mm_setr_epi8(
+			TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+			TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE_1000 | OVERLONG_4,
+			TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE,
+			TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+			TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+			TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT);
+
+		const __m128i nibble = _mm_set1_epi8(0x0F);
+		__m128i prev1 = _mm_alignr_epi8(input, prev_input, 15);
+		__m128i byte_1_high = _mm_shuffle_epi8(byte_1_high_table, _mm_and_si128(_mm_srli_epi16(prev1, 4), nibble));
+		__m128i byte_1_low = _mm_shuffle_epi8(byte_1_low_table, _mm_and_si128(prev1, nibble));
+		__m128i byte_2_high = _mm_shuffle_epi8(byte_2_high_table, _mm_and_si128(_mm_srli_epi16(input, 4), nibble));
+		__m128i special_cases = _mm_and_si128(_mm_and_si128(byte_1_high, byte_1_low), byte_2_high);
+
+		__m128i prev2 = _mm_alignr_epi8(input, prev_input, 14);
+		__m128i prev3 = _mm_alignr_epi8(input, prev_input, 13);
+		__m128i third_byte = _mm_subs_epu8(prev2, _mm_set1_epi8(char(0xE0 - 0x80)));		//0x80 set after a three or four byte lead
+		__m128i fourth_byte = _mm_subs_epu8(prev3, _mm_set1_epi8(char(0xF0 - 0x80)));	//0x80 set after a four byte lead
+		__m128i must_be_continuation = _mm_and_si128(_mm_or_si128(third_byte, fourth_byte), _mm_set1_epi8(char(0x80)));
+		return _mm_xor_si128(must_be_continuation, special_cases);
+	}
+
+	inline bool _validate_utf8_ssse3(const unsigned char* curr, const unsigned char* last) noexcept
+	{
+		//Non-zero where the last bytes of a block start a sequence that does not fit in it
+		const __m128i max_value = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+			char(0xF0 - 1), char(0xE0 - 1), char(0xC0 - 1));
+		__m128i error = _mm_setzero_si128();
+		__m128i prev_input = _mm_setzero_si128();
+		__m128i prev_incomplete = _mm_setzero_si128();
+		auto check = [&](__m128i input)
+		{
+			if (_mm_movemask_epi8(input) == 0)
+			{
+				error = _mm_or_si128(error, prev_incomplete);
+				prev_incomplete = _mm_setzero_si128();
+			}
+			else
+			{
+				error = _mm_or_si128(error, _utf8_block_errors(input, prev_input));
+				prev_incomplete = _mm_subs_epu8(input, max_value);
+			}
+			prev_input = input;
+		};
+		for (; last - curr >= 16; curr += 16)
+			check(_mm_loadu_si128(reinterpret_cast<const __m128i*>(curr)));
+		if (curr != last)
+		{
+			unsigned char tail[16] = {};
+			memcpy(tail, curr, last - curr);
+			check(_mm_loadu_si128(reinterpret_cast<const __m128i*>(tail)));
+		}
+		error = _mm_or_si128(error, prev_incomplete);
+		return _mm_movemask_epi8(_mm_cmpeq_epi8(error, _mm_setzero_si128())) == 0xFFFF;
+	}
+#endif
+
+	inline bool validate_utf8(StringView text) noexcept
+	{
+		const unsigned char* curr = reinterpret_cast<const unsigned char*>(text.data());
+		const unsigned char* last = curr + text.size();
+#if defined(DATASTRUCTURES_SSSE3)
+		return _validate_utf8_ssse3(curr, last);
+#elif defined(DATASTRUCTURES_SSE2)
+		while (last - curr >= 16)
+		{
+			if (_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(curr))) == 0)
+			{
+				curr += 16;
+				continue;
+			}
+			//Decode up to the end of this block, the last sequence may run into the next one
+			for (const unsigned char* block_end = curr + 16; curr < block_end; )
+			{
+				char32_t ignored;
+				curr = _decode_utf8(curr, last, ignored);
+				if (!curr) return false;
+			}
+		}
+		return _validate_utf8_scalar(curr, last);
+#else
+		return _validate_utf8_scalar(curr, last);
+#endif
+	}
+
+	inline size_t count_code_points(StringView text) noexcept
+	{
+		const unsigned char* first = reinterpret_cast<const unsigned char*>(text.data());
+		return _count_bytes_between(first, first + text.size(), -65, 127);	//Continuation bytes are 0x80 to 0xBF, -128 to -65
+	}
+
+	inline Utf8CodePoints code_points(StringView text) noexcept
+	{
+		return Utf8CodePoints(text);
+	}
+
+	inline U16String utf8_to_utf16(StringView text)
+	{
+		const unsigned char* curr = reinterpret_cast<const unsigned char*>(text.data());
+		const unsigned char* last = curr + text.size();
+		//One unit per code point and a second one for each four byte lead, 0xF0 to 0xFF
+		U16String result(count_code_points(text) + _count_bytes_between(curr, last, -17, -1), char16_t(0));
+		char16_t* out = result.data();
+		while (curr != last)
+		{
+#if defined(DATASTRUCTURES_SSE2)
+			if (last - curr >= 16)
+			{
+				__m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(curr));
+				if (_mm_movemask_epi8(block) == 0)
+				{
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_unpacklo_epi8(block, _mm_setzero_si128()));
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(out + 8), _mm_unpackhi_epi8(block, _mm_setzero_si128()));
+					curr += 16;
+					out += 16;
+					continue;
+				}
+			}
+#endif
+			//Decode up to the end of the block, the last sequence may run past it
+			for (const unsigned char* block_end = last - curr < 16 ? last : curr + 16; curr < block_end; )
+			{
+				char32_t code_point;
+				curr = _decode_utf8(curr, last, code_point);
+				if (!curr) throw std::invalid_argument{ "Invalid UTF-8 sequence!" };
+				if (code_point < 0x10000)
+					*out++ = char16_t(code_point);
+				else
+				{
+					code_point -= 0x10000;
+					*out++ = char16_t(0xD800 + (code_point >> 10));
+					*out++ = char16_t(0xDC00 + (code_point & 0x3FF));
+				}
+			}
+		}
+		return result;
+	}
+
+	inline U32String utf8_to_utf32(StringView text)
+	{
+		const unsigned char* curr = reinterpret_cast<const unsigned char*>(text.data());
+		const unsigned char* last = curr + text.size();
+		U32String result(count_code_points(text), char32_t(0));
+		char32_t* out = result.data();
+		while (curr != last)
+		{
+#if defined(DATASTRUCTURES_SSE2)
+			if (last - curr >= 16)
+			{
+				__m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(curr));
+				if (_mm_movemask_epi8(block) == 0)
+				{
+					const __m128i zero = _mm_setzero_si128();
+					__m128i low = _mm_unpacklo_epi8(block, zero);
+					__m128i high = _mm_unpackhi_epi8(block, zero);
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_unpacklo_epi16(low, zero));
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(out + 4), _mm_unpackhi_epi16(low, zero));
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(out + 8), _mm_unpacklo_epi16(high, zero));
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(out + 12), _mm_unpackhi_epi16(high, zero));
+					curr += 16;
+					out += 16;
+					continue;
+				}
+			}
+#endif
+			for (const unsigned char* block_end = last - curr < 16 ? last : curr + 16; curr < block_end; )
+			{
+				curr = _decode_utf8(curr, last, *out++);
+				if (!curr) throw std::invalid_argument{ "Invalid UTF-8 sequence!" };
+			}
+		}
+		return result;
+	}
+
+	inline String utf16_to_utf8(U16StringView text)
+	{
+		const char16_t* first = text.data();
+		const char16_t* last = first + text.size();
+		size_t n = 0;
+		for (const char16_t* curr = first; curr != last; ++curr)
+			n += *curr < 0x80 ? 1 : *curr < 0x800 || (*curr >= 0xD800 && *curr < 0xE000) ? 2 : 3;	//A surrogate pair makes 4
+		String result(n, char(0));
+		char* out = result.data();
+		for (const char16_t* curr = first; curr != last; )
+		{
+#if defined(DATASTRUCTURES_SSE2)
+			if (last - curr >= 8)
+			{
+				__m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(curr));
+				if (_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(block, _mm_set1_epi16(short(0xFF80))), _mm_setzero_si128())) == 0xFFFF)
+				{
+					_mm_storel_epi64(reinterpret_cast<__m128i*>(out), _mm_packus_epi16(block, block));
+					curr += 8;
+					out += 8;
+					continue;
+				}
+			}
+#endif
+			char32_t code_point = *curr++;
+			if (code_point >= 0xD800 && code_point < 0xE000)
+			{
+				if (code_point >= 0xDC00 || curr == last || *curr < 0xDC00 || *curr >= 0xE000)
+					throw std::invalid_argument{ "Invalid UTF-16 sequence!" };
+				code_point = 0x10000 + ((code_point - 0xD800) << 10) + (*curr++ - 0xDC00);
+			}
+			out = _encode_utf8(code_point, out);
+		}
+		return result;
+	}
+
+	inline String utf32_to_utf8(U32StringView text)
+	{
+		const char32_t* first = text.data();
+		const char32_t* last = first + text.size();
+		size_t n = 0;
+		for (const char32_t* curr = first; curr != last; ++curr)
+		{
+			if (*curr > 0x10FFFF || (*curr >= 0xD800 && *curr < 0xE000))
+				throw std::invalid_argument{ "Invalid UTF-32 code point!" };
+			n += *curr < 0x80 ? 1 : *curr < 0x800 ? 2 : *curr < 0x10000 ? 3 : 4;
+		}
+		String result(n, char(0));
+		char* out = result.data();
+		for (const char32_t* curr = first; curr != last; ++curr)
+			out = _encode_utf8(*curr, out);
+		return result;
+	}
+
+	inline Utf8Iterator::Utf8Iterator(const char * _curr, const char * _last) noexcept : curr(_curr), next(_curr), last(_last)
+	{
+		_decode();
+	}
+
+	inline void Utf8Iterator::_decode() noexcept
+	{
+		if (curr == last)
+		{
+			next = last;
+			return;
+		}
+		const unsigned char* first = reinterpret_cast<const unsigned char*>(curr);
+		const unsigned char* after = _decode_utf8(first, reinterpret_cast<const unsigned char*>(last), value);
+		if (!after)
+		{
+			value = REPLACEMENT_CHARACTER;
+			after = first + 1;
+		}
+		next = reinterpret_cast<const char*>(after);
+	}
+
+	inline char32_t Utf8Iterator::operator*() const noexcept
+	{
+		return value;
+	}
+
+	inline Utf8Iterator & Utf8Iterator::operator++() noexcept
+	{
+		curr = next;
+		_decode();
+		return *this;
+	}
+
+	inline Utf8Iterator Utf8Iterator::operator++(int) noexcept
+	{
+		Utf8Iterator before(*this);
+		++*this;
+		return before;
+	}
+
+	inline bool Utf8Iterator::operator==(const Utf8Iterator & other) const noexcept
+	{
+		return curr == other.curr;
+	}
+
+	inline bool Utf8Iterator::operator!=(const Utf8Iterator & other) const noexcept
+	{
+		return curr != other.curr;
+	}
+
+	inline const char * Utf8Iterator::base() const noexcept
+	{
+		return curr;
+	}
+
+	inline Utf8Iterator Utf8CodePoints::begin() const noexcept
+	{
+		return Utf8Iterator(text.data(), text.data() + text.size());
+	}
+
+	inline Utf8Iterator Utf8CodePoints::end() const noexcept
+	{
+		return Utf8Iterator(text.data() + text.size(), text.data() + text.size());
+	}
+}
@@ -0,0 +1,672 @@
+#pragma once
+#include <stdexcept>
+#include <memory>
+#include <new>
+#include <utility>
+#include <iterator>
+#include <type_traits>
+#include <initializer_list>
+
+constexpr size_t UNROLLED_LIST_NODE_BYTES = 128U;	//By default a node holds as many elements as fit in this
+
+namespace DataStructures
+{
+	//Singly linked list whose nodes hold up to K elements each, in order. Traversal reads neighbouring elements from the
+	//same cache lines and follows one pointer per node, and a small T no longer pays a pointer and an allocation apiece.
+	//A full node is split in halves on insert. A node less than half full after an erase takes in its successor
+	//when both fit in one, and an empty node is freed. The interface follows ForwardList, plus O(1) size() and back().
+	//Inserting or erasing invalidates iterators into the nodes it touches.
+	template<typename T, size_t K = (sizeof(T) * 2 <= UNROLLED_LIST_NODE_BYTES ? UNROLLED_LIST_NODE_BYTES / sizeof(T) : 2),
+		class Allocator = std::allocator<T>>
+	class UnrolledList
+	{
+		static_assert(K >= 2, "UnrolledList needs room for two elements per node!");
+
+	private:
+		struct NodeLink;
+		struct Node;
+		class UnrolledListIterator;
+		class UnrolledListConstIterator;
+
+	public:
+		using allocator_type	= Allocator;
+		using value_type		= T;
+		using reference			= T&;
+		using const_reference	= const T&;
+		using pointer			= T*;
+		using const_pointer		= const T*;
+		using difference_type	= ptrdiff_t;
+		using size_type			= size_t;
+
+		using iterator			= UnrolledListIterator;
+		using const_iterator	= UnrolledListConstIterator;
+
+		static constexpr size_type node_capacity = K;
+
+		//Constructor, Destructor and Assignment
+		UnrolledList() noexcept;
+		explicit UnrolledList(const Allocator& alloc) noexcept;
+		UnrolledList(size_type n, const T& val, const Allocator& alloc = Allocator());
+
+		template<typename InputIterator, typename = typename std::enable_if_t<std::_Is_iterator<InputIterator>::value>>
+		UnrolledList(InputIterator first, InputIterator last, const Allocator& alloc = Allocator());
+
+		UnrolledList(std::initializer_list<T> init, const Allocator& alloc = Allocator());
+		UnrolledList(const UnrolledList& origin);
+		UnrolledList(UnrolledList&& origin) noexcept;
+		~UnrolledList();
+		UnrolledList& operator=(const UnrolledList& origin);
+		UnrolledList& operator=(UnrolledList&& origin) noexcept;
+		UnrolledList& operator=(std::initializer_list<T> init);
+		allocator_type get_allocator() const;
+
+		//Element access
+		reference front();
+		const_reference front() const;
+		reference back();
+		const_reference back() const;
+
+		//Iterators
+		iterator begin() noexcept;
+		const_iterator begin() const noexcept;
+		const_iterator cbegin() const noexcept;
+		iterator end() noexcept;
+		const_iterator end() const noexcept;
+		const_iterator cend() const noexcept;
+		iterator before_begin() noexcept;
+		const_iterator before_begin() const noexcept;
+		const_iterator cbefore_begin() const noexcept;
+
+		//Capacity
+		bool empty() const noexcept;
+		size_type size() const noexcept;
+		size_type node_count() const noexcept;		//O(n / K)
+
+		//Modifiers
+		void clear() noexcept;
+		iterator insert_after(const_iterator pos, const T& val);
+		iterator insert_after(const_iterator pos, T&& val);
+		template <typename ... Args> iterator emplace_after(const_iterator pos, Args&& ... args);
+		iterator insert(const_iterator pos, const T& val);	//Inserts before pos
+		iterator insert(const_iterator pos, T&& val);
+		template <typename ... Args> iterator emplace(const_iterator pos, Args&& ... args);
+		iterator erase_after(const_iterator pos);			//Returns the element that followed the erased one
+		iterator erase(const_iterator pos);					//O(n / K) if the node of pos is emptied, its predecessor is searched
+		void push_front(const T& val);
+		void push_front(T&& val);
+		template <typename ... Args> reference emplace_front(Args&& ... args);
+		void pop_front();
+		void push_back(const T& val);
+		void push_back(T&& val);
+		template <typename ... Args> reference emplace_back(Args&& ... args);
+		void swap(UnrolledList& other) noexcept;
+
+		//Operations
+		void remove(const T& val);	//Remove all value equal to val
+		template<typename UnaryPredicate> void remove_if(UnaryPredicate p);
+
+	private:
+		struct NodeLink
+		{
+			Node* next = nullptr;
+			size_type count = 0;
+		};
+
+		struct Node : NodeLink
+		{
+			typename std::aligned_storage<sizeof(T), alignof(T)>::type slots[K];
+
+			T* elements() noexcept { return reinterpret_cast<T*>(slots); }
+			const T* elements() const noexcept { return reinterpret_cast<const T*>(slots); }
+		};
+
+		using node_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Node>;
+		using node_traits = std::allocator_traits<node_allocator>;
+
+		node_allocator allocator;
+		NodeLink head;							//Never holds elements, before_begin() points here
+		Node* last = nullptr;
+		size_type element_count = 0;
+
+		//Helper functions
+		inline Node* _create_node(NodeLink* prev);		//Links an empty node after prev
+		inline void _destroy_node(NodeLink* prev) noexcept;	//Unlinks and frees the empty node after prev
+		inline void _relocate(T* dest, T* from, size_type n);	//dest is uninitialized, from is destroyed
+		inline void _shift_right(Node* node, size_type i);	//Opens a gap at i
+		inline void _shift_left(Node* node, size_type i);	//Closes the gap at i
+		template <typename ... Args> iterator _emplace_at(Node* node, size_type i, Args&& ... args);
+		inline iterator _erase_at(NodeLink* prev, Node* node, size_type i);	//prev is only used if node empties
+
+		class UnrolledListIterator
+		{
+		public:
+			using self_type = UnrolledListIterator;
+			using value_type = T;
+			using reference = T&;
+			using pointer = T*;
+			using difference_type = ptrdiff_t;
+			using iterator_category = std::forward_iterator_tag;
+
+			UnrolledListIterator() {}
+
+			self_type& operator++() { if (++index >= link->count) { link = link->next; index = 0; } return *this; }
+			self_type operator++(int) { self_type ret(*this); ++*this; return ret; }
+			bool operator==(const self_type& rhs) const { return link == rhs.link && index == rhs.index; }
+			bool operator!=(const self_type& rhs) const { return !(*this == rhs); }
+			reference operator*() const { return static_cast<Node*>(link)->elements()[index]; }
+			pointer operator->() const { return &**this; }
+
+		private:
+			UnrolledListIterator(NodeLink* _link, size_type _index) : link(_link), index(_index) {}
+			UnrolledListIterator(const UnrolledListConstIterator& origin) : link(const_cast<NodeLink*>(origin.link)), index(origin.index) {}
+
+		private:
+			friend class UnrolledList;
+			friend class UnrolledListConstIterator;
+			NodeLink* link = nullptr;			//Null at end()
+			size_type index = 0;
+		};
+
+		class UnrolledListConstIterator
+		{
+		public:
+			using self_type = UnrolledListConstIterator;
+			using value_type = T;
+			using reference = const T&;
+			using pointer = const T*;
+			using difference_type = ptrdiff_t;
+			using iterator_category = std::forward_iterator_tag;
+
+			UnrolledListConstIterator() {}
+			UnrolledListConstIterator(const UnrolledListIterator& origin) : link(origin.link), index(origin.index) {}
+
+			self_type& operator++() { if (++index >= link->count) { link = link->next; index = 0; } return *this; }
+			self_type operator++(int) { self_type ret(*this); ++*this; return ret; }
+			bool operator==(const self_type& rhs) const { return link == rhs.link && index == rhs.index; }
+			bool operator!=(const self_type& rhs) const { return !(*this == rhs); }
+			reference operator*() const { return static_cast<const Node*>(link)->elements()[index]; }
+			pointer operator->() const { return &**this; }
+
+		private:
+			UnrolledListConstIterator(const NodeLink* _link, size_type _index) : link(_link), index(_index) {}
+
+		private:
+			friend class UnrolledList;
+			friend class UnrolledListIterator;
+			const NodeLink* link = nullptr;
+			size_type index = 0;
+		};
+	};
+
+	/* Dividing Line ( 㧥 ;) ( 㧥 ;) ( 㧥 ;)  */
+
+	template<typename T, size_t K, class Allocator>
+	inline UnrolledList<T, K, Allocator>::UnrolledList() noexcept
+	{
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline UnrolledList<T, K, Allocator>::UnrolledList(const Allocator & alloc) noexcept : allocator(alloc)
+	{
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline UnrolledList<T, K, Allocator>::UnrolledList(size_type n, const T & val, const Allocator & alloc) : allocator(alloc)
+	{
+		for (size_type i = 0; i < n; i++)
+			emplace_back(val);
+	}
+
+	template<typename T, size_t K, class Allocator>
+	template<typename InputIterator, typename SFINAE_MAGIC>
+	inline UnrolledList<T, K, Allocator>::UnrolledList(InputIterator first, InputIterator last, const Allocator & alloc) : allocator(alloc)
+	{
+		while (first != last)
+			emplace_back(*first++);
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline UnrolledList<T, K, Allocator>::UnrolledList(std::initializer_list<T> init, const Allocator & alloc) :
+		UnrolledList(init.begin(), init.end(), alloc)
+	{
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline UnrolledList<T, K, Allocator>::UnrolledList(const UnrolledList & origin) :
+		UnrolledList(origin.cbegin(), origin.cend(), origin.get_allocator())
+	{
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline UnrolledList<T, K, Allocator>::UnrolledList(UnrolledList && origin) noexcept : allocator(origin.allocator)
+	{
+		swap(origin);
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline UnrolledList<T, K, Allocator>::~UnrolledList()
+	{
+		clear();
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline UnrolledList<T, K, Allocator> & UnrolledList<T, K, Allocator>::operator=(const UnrolledList & origin)
+	{
+		UnrolledList temp(origin);
+		swap(temp);
+		return *this;
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline UnrolledList<T, K, Allocator> & UnrolledList<T, K, Allocator>::operator=(UnrolledList && origin) noexcept
+	{
+		swap(origin);
+		return *this;
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline UnrolledList<T, K, Allocator> & UnrolledList<T, K, Allocator>::operator=(std::initializer_list<T> init)
+	{
+		UnrolledList temp(init, get_allocator());
+		swap(temp);
+		return *this;
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline typename UnrolledList<T, K, Allocator>::allocator_type UnrolledList<T, K, Allocator>::get_allocator() const
+	{
+		return allocator_type(allocator);
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline typename UnrolledList<T, K, Allocator>::reference UnrolledList<T, K, Allocator>::front()
+	{
+		return head.next->elements()[0];
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline typename UnrolledList<T, K, Allocator>::const_reference UnrolledList<T, K, Allocator>::front() const
+	{
+		return head.next->elements()[0];
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline typename UnrolledList<T, K, Allocator>::reference UnrolledList<T, K, Allocator>::back()
+	{
+		return last->elements()[last->count - 1];
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline typename UnrolledList<T, K, Allocator>::const_reference UnrolledList<T, K, Allocator>::back() const
+	{
+		return last->elements()[last->count - 1];
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline typename UnrolledList<T, K, Allocator>::iterator UnrolledList<T, K, Allocator>::begin() noexcept
+	{
+		return iterator(head.next, 0);
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline typename UnrolledList<T, K, Allocator>::const_iterator UnrolledList<T, K, Allocator>::begin() const noexcept
+	{
+		return const_iterator(head.next, 0);
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline typename UnrolledList<T, K, Allocator>::const_iterator UnrolledList<T, K, Allocator>::cbegin() const noexcept
+	{
+		return const_iterator(head.next, 0);
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline typename UnrolledList<T, K, Allocator>::iterator UnrolledList<T, K, Allocator>::end() noexcept
+	{
+		return iterator(nullptr, 0);
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline typename UnrolledList<T, K, Allocator>::const_iterator UnrolledList<T, K, Allocator>::end() const noexcept
+	{
+		return const_iterator(nullptr, 0);
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline typename UnrolledList<T, K, Allocator>::const_iterator UnrolledList<T, K, Allocator>::cend() const noexcept
+	{
+		return const_iterator(nullptr, 0);
+	}
+
+	//The head holds no elements, so one step from index -1 lands on the first element
+	template<typename T, size_t K, class Allocator>
+	inline typename UnrolledList<T, K, Allocator>::iterator UnrolledList<T, K, Allocator>::before_begin() noexcept
+	{
+		return iterator(&head, size_type(-1));
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline typename UnrolledList<T, K, Allocator>::const_iterator UnrolledList<T, K, Allocator>::before_begin() const noexcept
+	{
+		return const_iterator(&head, size_type(-1));
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline typename UnrolledList<T, K, Allocator>::const_iterator UnrolledList<T, K, Allocator>::cbefore_begin() const noexcept
+	{
+		return const_iterator(&head, size_type(-1));
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline bool UnrolledList<T, K, Allocator>::empty() const noexcept
+	{
+		return element_count == 0;
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline typename UnrolledList<T, K, Allocator>::size_type UnrolledList<T, K, Allocator>::size() const noexcept
+	{
+		return element_count;
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline typename UnrolledList<T, K, Allocator>::size_type UnrolledList<T, K, Allocator>::node_count() const noexcept
+	{
+		size_type n = 0;
+		for (const Node* node = head.next; node; node = node->next)
+			++n;
+		return n;
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline void UnrolledList<T, K, Allocator>::clear() noexcept
+	{
+		while (head.next)
+		{
+			Node* node = head.next;
+			for (size_type i = 0; i < node->count; i++)
+				node_traits::destroy(allocator, node->elements() + i);
+			node->count = 0;
+			_destroy_node(&head);
+		}
+		last = nullptr;
+		element_count = 0;
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline typename UnrolledList<T, K, Allocator>::iterator UnrolledList<T, K, Allocator>::insert_after(const_iterator pos, const T & val)
+	{
+		return emplace_after(pos, val);
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline typename UnrolledList<T, K, Allocator>::iterator UnrolledList<T, K, Allocator>::insert_after(const_iterator pos, T && val)
+	{
+		return emplace_after(pos, std::move(val));
+	}
+
+	template<typename T, size_t K, class Allocator>
+	template<typename ...Args>
+	inline typename UnrolledList<T, K, Allocator>::iterator UnrolledList<T, K, Allocator>::emplace_after(const_iterator pos, Args && ...args)
+	{
+		if (pos.link == &head)
+			return _emplace_at(head.next, 0, std::forward<Args>(args) ...);
+		iterator _pos(pos);
+		return _emplace_at(static_cast<Node*>(_pos.link), _pos.index + 1, std::forward<Args>(args) ...);
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline typename UnrolledList<T, K, Allocator>::iterator UnrolledList<T, K, Allocator>::insert(const_iterator pos, const T & val)
+	{
+		return emplace(pos, val);
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline typename UnrolledList<T, K, Allocator>::iterator UnrolledList<T, K, Allocator>::insert(const_iterator pos, T && val)
+	{
+		return emplace(pos, std::move(val));
+	}
+
+	template<typename T, size_t K, class Allocator>
+	template<typename ...Args>
+	inline typename UnrolledList<T, K, Allocator>::iterator UnrolledList<T, K, Allocator>::emplace(const_iterator pos, Args && ...args)
+	{
+		if (!pos.link)
+			return _emplace_at(last, last ? last->count : 0, std::forward<Args>(args) ...);
+		iterator _pos(pos);
+		return _emplace_at(static_cast<Node*>(_pos.link), _pos.index, std::forward<Args>(args) ...);
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline typename UnrolledList<T, K, Allocator>::iterator UnrolledList<T, K, Allocator>::erase_after(const_iterator pos)
+	{
+		if (pos.link == &head)
+			return _erase_at(&head, head.next, 0);
+		iterator _pos(pos);
+		Node* node = static_cast<Node*>(_pos.link);
+		if (_pos.index + 1 < node->count)
+			return _erase_at(nullptr, node, _pos.index + 1);	//pos itself stays, the node cannot empty
+		return _erase_at(node, node->next, 0);
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline typename UnrolledList<T, K, Allocator>::iterator UnrolledList<T, K, Allocator>::erase(const_iterator pos)
+	{
+		iterator _pos(pos);
+		Node* node = static_cast<Node*>(_pos.link);
+		NodeLink* prev = nullptr;
+		if (node->count == 1)
+			for (prev = &head; prev->next != node; prev = prev->next);
+		return _erase_at(prev, node, _pos.index);
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline void UnrolledList<T, K, Allocator>::push_front(const T & val)
+	{
+		emplace_front(val);
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline void UnrolledList<T, K, Allocator>::push_front(T && val)
+	{
+		emplace_front(std::move(val));
+	}
+
+	template<typename T, size_t K, class Allocator>
+	template<typename ...Args>
+	inline typename UnrolledList<T, K, Allocator>::reference UnrolledList<T, K, Allocator>::emplace_front(Args && ...args)
+	{
+		return *_emplace_at(head.next, 0, std::forward<Args>(args) ...);
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline void UnrolledList<T, K, Allocator>::pop_front()
+	{
+		_erase_at(&head, head.next, 0);
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline void UnrolledList<T, K, Allocator>::push_back(const T & val)
+	{
+		emplace_back(val);
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline void UnrolledList<T, K, Allocator>::push_back(T && val)
+	{
+		emplace_back(std::move(val));
+	}
+
+	template<typename T, size_t K, class Allocator>
+	template<typename ...Args>
+	inline typename UnrolledList<T, K, Allocator>::reference UnrolledList<T, K, Allocator>::emplace_back(Args && ...args)
+	{
+		return *_emplace_at(last, last ? last->count : 0, std::forward<Args>(args) ...);
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline void UnrolledList<T, K, Allocator>::swap(UnrolledList & other) noexcept
+	{
+		std::swap(allocator, other.allocator);
+		std::swap(head.next, other.head.next);
+		std::swap(last, other.last);
+		std::swap(element_count, other.element_count);
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline void UnrolledList<T, K, Allocator>::remove(const T & val)
+	{
+		remove_if([&val](const T& elem) { return std::equal_to<T>()(val, elem); });
+	}
+
+	template<typename T, size_t K, class Allocator>
+	template<typename UnaryPredicate>
+	inline void UnrolledList<T, K, Allocator>::remove_if(UnaryPredicate p)
+	{
+		//One pass: the kept elements of each node are packed to its front, then into its predecessor if they fit
+		NodeLink* prev = &head;
+		while (Node* node = prev->next)
+		{
+			T* elements = node->elements();
+			size_type kept = 0;
+			for (size_type i = 0; i < node->count; i++)
+			{
+				if (p(elements[i]))
+				{
+					node_traits::destroy(allocator, elements + i);
+					--element_count;
+				}
+				else
+				{
+					if (kept != i)
+						_relocate(elements + kept, elements + i, 1);
+					++kept;
+				}
+			}
+			node->count = kept;
+			if (prev != &head && prev->count + kept <= K)
+			{
+				_relocate(static_cast<Node*>(prev)->elements() + prev->count, elements, kept);
+				prev->count += kept;
+				node->count = 0;
+			}
+			if (node->count == 0)
+				_destroy_node(prev);
+			else
+				prev = node;
+		}
+		last = prev == &head ? nullptr : static_cast<Node*>(prev);
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline typename UnrolledList<T, K, Allocator>::Node * UnrolledList<T, K, Allocator>::_create_node(NodeLink * prev)
+	{
+		Node* node = node_traits::allocate(allocator, 1);
+		::new (static_cast<void*>(node)) Node;
+		node->next = prev->next;
+		prev->next = node;
+		return node;
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline void UnrolledList<T, K, Allocator>::_destroy_node(NodeLink * prev) noexcept
+	{
+		Node* node = prev->next;
+		prev->next = node->next;
+		node->~Node();
+		node_traits::deallocate(allocator, node, 1);
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline void UnrolledList<T, K, Allocator>::_relocate(T * dest, T * from, size_type n)
+	{
+		for (size_type i = 0; i < n; i++)
+		{
+			node_traits::construct(allocator, dest + i, std::move(from[i]));
+			node_traits::destroy(allocator, from + i);
+		}
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline void UnrolledList<T, K, Allocator>::_shift_right(Node * node, size_type i)
+	{
+		T* elements = node->elements();
+		for (size_type j = node->count; j > i; j--)
+			_relocate(elements + j, elements + j - 1, 1);
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline void UnrolledList<T, K, Allocator>::_shift_left(Node * node, size_type i)
+	{
+		T* elements = node->elements();
+		for (size_type j = i; j + 1 < node->count; j++)
+			_relocate(elements + j, elements + j + 1, 1);
+	}
+
+	template<typename T, size_t K, class Allocator>
+	template<typename ...Args>
+	inline typename UnrolledList<T, K, Allocator>::iterator UnrolledList<T, K, Allocator>::_emplace_at(Node * node, size_type i, Args && ...args)
+	{
+		T value(std::forward<Args>(args) ...);	//args may refer to an element that is about to move
+		if (!node)
+		{
+			node = last = _create_node(&head);
+			i = 0;
+		}
+		else if (node->count == K)
+		{
+			if (i == K && node == last)
+			{
+				//Appending starts a new node instead of leaving two half full ones
+				node = last = _create_node(node);
+				i = 0;
+			}
+			else
+			{
+				Node* upper = _create_node(node);
+				if (node == last)
+					last = upper;
+				_relocate(upper->elements(), node->elements() + K / 2, K - K / 2);
+				upper->count = K - K / 2;
+				node->count = K / 2;
+				if (i > K / 2)
+				{
+					node = upper;
+					i -= K / 2;
+				}
+			}
+		}
+		_shift_right(node, i);
+		node_traits::construct(allocator, node->elements() + i, std::move(value));
+		++node->count;
+		++element_count;
+		return iterator(node, i);
+	}
+
+	template<typename T, size_t K, class Allocator>
+	inline typename UnrolledList<T, K, Allocator>::iterator UnrolledList<T, K, Allocator>::_erase_at(NodeLink * prev, Node * node, size_type i)
+	{
+		node_traits::destroy(allocator, node->elements() + i);
+		_shift_left(node, i);
+		--node->count;
+		--element_count;
+		Node* next = node->next;
+		if (node->count == 0)
+		{
+			if (node == last)
+				last = prev == &head ? nullptr : static_cast<Node*>(prev);
+			_destroy_node(prev);
+			return iterator(next, 0);
+		}
+		if (next && node->count < K / 2 && node->count + next->count <= K)
+		{
+			_relocate(node->elements() + node->count, next->elements(), next->count);
+			node->count += next->count;
+			next->count = 0;
+			if (next == last)
+				last = node;
+			_destroy_node(node);
+		}
+		return i < node->count ? iterator(node, i) : iterator(node->next, 0);
+	}
+}
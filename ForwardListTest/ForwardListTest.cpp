@@ -18,10 +18,17 @@
 #include <iostream>
 #include <iomanip>
 #include "ForwardList.h"
+#include "UnrolledList.h"
+#include "IntrusiveForwardList.h"
+#include "CompactForwardList.h"
+#include "ConcurrentSkipList.h"
+#include "Allocator.h"
 #include "ForwardListTest.h"
 #include <string>
 #include <vector>
 #include <forward_list>
+#include <thread>
+#include <algorithm>
 
 using std::cin;
 using std::cout;
@@ -36,12 +43,12 @@ void print(InputIterator begin, InputIterator end, char delim = ' ')
 	cout << '\n';
 }
 
-template<typename T, template<typename> typename Container>
-void print(const Container<T>& container)
+template<typename T, typename ... Rest, template<typename, typename ...> typename Container>
+void print(const Container<T, Rest...>& container)
 {
 	if (!container.empty())
 	{
-		Container<T>::const_iterator curr = container.cbegin();
+		typename Container<T, Rest...>::const_iterator curr = container.cbegin();
 		cout << *curr++;
 		while (curr != container.cend())
 			cout << ' ' << *curr++;
@@ -68,6 +75,14 @@ int main()
 	//ModifiersTester();
 	OperationsTester();
 	//NonMemberFunctionsTester();
+	AllocatorTester();
+	SizePolicyTester();
+	UnrolledListTester();
+	IntrusiveForwardListTester();
+	BulkOperationsTester();
+	CompactForwardListTester();
+	ConcurrentSkipListTester();
+	ParallelSortTester();
 
 	//Report all memory leaks
 	_CrtDumpMemoryLeaks();
@@ -94,7 +109,7 @@ void ConstructorTester()
 	DS::ForwardList<int> tempfwdls(fwdls4);
 	DS::ForwardList<int> fwdls6(std::move(tempfwdls));
 	//(7) Allocator-extended move constructor.
-	//ForwardList does not use allocator.
+	//Not provided, see AllocatorTester() for the other constructors taking an allocator.
 	//(8) Constructs the container with the contents of the initializer list.
 	DS::ForwardList<int> fwdls7{ 0,1,2,3,4,5,6,7,8,9 };
 
@@ -282,6 +297,12 @@ void OperationsTester()
 	ls9.unique();
 	ls10.unique([](int a, int b) {return abs(a - b) < 2;});
 
+	//sort()
+	DS::ForwardList<int> ls11{ 5,3,9,1,3,0,8 };
+	DS::ForwardList<std::string> ls12{ "pear", "fig", "apple", "kiwi", "plum" };
+	ls11.sort();
+	ls12.sort([](const std::string& a, const std::string& b) {return a.size() < b.size();});	//Stable
+
 	print(ls1);
 	print(ls2);
 	print(ls3);
@@ -292,6 +313,8 @@ void OperationsTester()
 	print(ls8);
 	print(ls9);
 	print(ls10);
+	print(ls11);
+	print(ls12);
 }
 
 /*
@@ -319,4 +342,272 @@ void NonMemberFunctionsTester()
 		<< (fwdls1 <= fwdls4) << '\n'	//True
 		<< (fwdls1 != fwdls4) << '\n';	//True
 }
-*/
\ No newline at end of file
+*/
+
+void AllocatorTester()
+{
+	//Nodes of both lists are carved from the same slabs
+	DS::NodePool pool;
+	DS::PoolAllocator<int> alloc(pool);
+	DS::ForwardList<int, DS::PoolAllocator<int>> fwdls1(alloc);
+	for (int i = 0; i < 5; i++)
+		fwdls1.push_front(i);
+	DS::ForwardList<int, DS::PoolAllocator<int>> fwdls2({ 7,8,9 }, alloc);
+	print(fwdls1);
+	print(fwdls2);
+
+	//Consecutive inserts are adjacent
+	const int* first = &*fwdls1.begin();
+	const int* second = &*++fwdls1.begin();
+	cout << reinterpret_cast<const char*>(first) - reinterpret_cast<const char*>(second) << ' ' << pool.used() << '\n';	//16 128, nodes of 16 bytes on x64
+
+	//Erased nodes are reused by the next insert
+	fwdls1.pop_front();
+	fwdls1.push_front(42);
+	cout << (&*fwdls1.begin() == first) << ' ' << pool.used() << '\n';	//1 128
+
+	//Copies share the pool, splice_after() and merge() need allocators that compare equal
+	DS::ForwardList<int, DS::PoolAllocator<int>> fwdls3(fwdls2);
+	fwdls1.splice_after(fwdls1.before_begin(), fwdls3);
+	print(fwdls1);
+	cout << (fwdls1.get_allocator() == alloc) << ' ' << pool.used() << '\n';	//1 176
+	fwdls1.clear();
+	fwdls2.clear();
+	cout << pool.used() << '\n';	//0
+}
+
+void SizePolicyTester()
+{
+	//A queue: push_back() and back() need the last node, size() the count
+	DS::ForwardList<int, std::allocator<int>, DS::TrackedSize> queue{ 1,2,3 };
+	queue.push_back(4);
+	queue.pop_front();
+	cout << queue.size() << ' ' << queue.front() << ' ' << queue.back() << '\n';	//3 2 4
+
+	//Every mutator keeps them up to date
+	DS::ForwardList<int, std::allocator<int>, DS::TrackedSize> other{ 9,8,7 };
+	queue.splice_after(queue.before_end(), other, other.begin());
+	cout << queue.size() << ' ' << queue.back() << ' ' << other.size() << ' ' << other.back() << '\n';	//5 7 1 9
+	queue.sort();
+	other.merge({ 10,11 });
+	cout << queue.size() << ' ' << queue.back() << ' ' << other.size() << ' ' << other.back() << '\n';	//5 8 3 11
+	queue.reverse();
+	queue.erase_after(queue.begin(), queue.end());
+	cout << queue.size() << ' ' << queue.back() << '\n';	//1 8
+	queue.swap(other);
+	queue.pop_back();
+	print(queue);
+	print(other);
+	cout << queue.size() << ' ' << other.size() << '\n';	//2 1
+
+	//Without the policy the same calls traverse the list
+	DS::ForwardList<int> list{ 1,2,3 };
+	list.push_back(4);
+	cout << list.size() << ' ' << list.back() << '\n';	//4 4
+}
+
+void UnrolledListTester()
+{
+	//Four elements per node, so a few pushes already split and merge nodes
+	DS::UnrolledList<int, 4> list{ 1,2,3,4,5,6 };
+	list.push_front(0);
+	list.push_back(7);
+	for (auto& elem : list) cout << elem << ' ';
+	cout << '\n' << list.size() << ' ' << list.front() << ' ' << list.back() << ' ' << list.node_count() << '\n';	//8 0 7 3
+
+	//Inserting into a full node splits it in halves
+	auto iter = list.begin();
+	++iter;
+	iter = list.insert_after(iter, 100);
+	cout << *iter << '\n';	//100
+	list.insert(list.begin(), -1);	//Invalidates iter, the node it pointed into is split
+	for (auto& elem : list) cout << elem << ' ';
+	cout << '\n' << list.size() << ' ' << list.node_count() << '\n';	//10 4
+
+	//Erasing until a node is less than half full takes in its successor
+	list.erase_after(list.before_begin());
+	list.erase(list.begin());
+	list.remove(100);
+	list.remove_if([](int elem) { return elem % 2 == 1; });
+	for (auto& elem : list) cout << elem << ' ';
+	cout << '\n' << list.size() << ' ' << list.back() << ' ' << list.node_count() << '\n';	//3 6 1
+
+	DS::UnrolledList<std::string> strs(3, "abc");
+	DS::UnrolledList<std::string> copy(strs);
+	strs.pop_front();
+	copy.emplace_back(2, 'x');
+	strs.swap(copy);
+	for (const auto& elem : strs) cout << elem << ' ';
+	cout << '\n' << strs.size() << ' ' << copy.size() << '\n';	//4 2
+}
+
+struct Task
+{
+	int priority;
+	std::string name;
+	DS::IntrusiveForwardListHook hook;
+
+	bool operator<(const Task& rhs) const { return priority < rhs.priority; }
+};
+
+void IntrusiveForwardListTester()
+{
+	//The tasks stay where they are, the lists link them through their hook
+	std::vector<Task> tasks{ { 3,"c" },{ 1,"a" },{ 2,"b" },{ 1,"d" },{ 5,"e" } };
+	DS::IntrusiveForwardList<Task, &Task::hook, DS::TrackedSize> ready(tasks.begin(), tasks.begin() + 3);
+	DS::IntrusiveForwardList<Task, &Task::hook, DS::TrackedSize> waiting;
+	waiting.push_front(tasks[3]);
+	waiting.push_back(tasks[4]);
+	for (const auto& task : ready) cout << task.name << ' ';
+	cout << '\n' << ready.size() << ' ' << ready.back().name << ' ' << (&ready.front() == &tasks[0]) << '\n';	//3 b 1
+
+	//Stable: "a" was there before "d"
+	ready.sort();
+	ready.merge(waiting);
+	for (const auto& task : ready) cout << task.name << ' ';
+	cout << '\n' << ready.size() << ' ' << waiting.size() << ' ' << ready.back().name << '\n';	//5 0 e
+
+	//Unlinking leaves the objects alone
+	ready.remove_if([](const Task& task) { return task.priority == 1; });
+	waiting.splice_after(waiting.before_begin(), ready, ready.iterator_to(tasks[0]));
+	ready.pop_front();
+	for (const auto& task : ready) cout << task.name << ' ';
+	cout << '\n' << ready.size() << ' ' << waiting.front().name << ' ' << tasks[1].name << '\n';	//1 e a
+
+	//Splicing a list into itself
+	ready.splice_after(ready.cbegin(), waiting);
+	ready.splice_after(ready.cbegin(), ready);
+	ready.splice_after(ready.cbegin(), ready, ready.cbefore_begin());
+	ready.splice_after(ready.cbefore_begin(), ready, ready.cbegin());
+	for (const auto& task : ready) cout << task.name << ' ';
+	cout << '\n' << ready.size() << ' ' << ready.back().name << '\n';	//2 c
+
+	//Without the policy size() and back() traverse the list
+	DS::IntrusiveForwardList<Task, &Task::hook> list;
+	ready.clear();
+	waiting.clear();
+	for (auto& task : tasks) list.push_front(task);
+	list.reverse();
+	list.erase_after(list.begin(), list.end());
+	cout << list.size() << ' ' << list.back().name << '\n';	//1 c
+}
+
+void BulkOperationsTester()
+{
+	DS::ForwardList<int> list{ 5,3,3,8,1,3 };
+	cout << list.accumulate(0) << ' ' << list.accumulate(1, [](int product, int elem) { return product * elem; }) << '\n';	//23 1080
+	int odd = 0;
+	list.for_each([&odd](int elem) { odd += elem % 2; });
+	cout << odd << ' ' << *list.find(8) << ' ' << (list.find(7) == list.end()) << ' ' << *list.find_if([](int elem) { return elem < 3; }) << '\n';	//5 8 1 1
+
+	list.unique();
+	list.remove_if([](int elem) { return elem == 8; });
+	print(list);	//5 3 1 3
+
+	//After sort() the traversal order jumps around in memory, compact() puts the values back in address order
+	list.sort();
+	list.compact();
+	print(list);	//1 3 3 5
+	const int* prev = nullptr;
+	bool ascending = true;
+	for (const auto& elem : list)
+	{
+		ascending = ascending && (prev == nullptr || prev < &elem);
+		prev = &elem;
+	}
+	cout << ascending << ' ' << list.size() << '\n';	//1 4
+}
+
+void CompactForwardListTester()
+{
+	DS::CompactForwardList<int> list{ 4,2,3 };
+	list.push_front(1);
+	list.push_back(5);
+	auto iter = list.begin();
+	list.reserve(1000);		//Growing the arena keeps iterators valid
+	cout << *iter << ' ' << list.size() << ' ' << list.front() << ' ' << list.back() << '\n';	//1 5 1 5
+
+	//Erased nodes are reused before the arena grows
+	list.erase_after(list.begin());
+	list.pop_front();
+	size_t capacity = list.capacity();
+	list.insert_after(list.before_begin(), 0);
+	list.emplace_after(list.before_end(), 6);
+	for (auto elem : list) cout << elem << ' ';
+	cout << '\n' << (list.capacity() == capacity) << '\n';	//0 2 3 5 6 1
+
+	list.sort([](int a, int b) { return a > b; });
+	DS::CompactForwardList<int> other{ 9,7,1 };
+	list.merge(other, [](int a, int b) { return a > b; });
+	for (auto elem : list) cout << elem << ' ';
+	cout << '\n' << list.size() << ' ' << other.size() << '\n';	//9 7 6 5 3 2 1 0 8 0
+
+	list.remove_if([](int elem) { return elem % 3 == 0; });
+	list.reverse();
+	other.splice_after(other.before_begin(), list, list.begin(), list.end());
+	for (auto elem : list) cout << elem << ' ';
+	cout << '\n';	//1
+	for (auto elem : other) cout << elem << ' ';
+	cout << '\n' << other.accumulate(0) << ' ' << other.back() << '\n';	//2 5 7 14 7
+
+	//Splicing a list into itself relinks the nodes
+	DS::CompactForwardList<int> self{ 1,2,3,4 };
+	self.splice_after(self.begin(), self);
+	self.splice_after(self.begin(), self, self.before_begin());
+	self.splice_after(self.before_begin(), self, self.begin());
+	self.splice_after(self.begin(), list, list.before_begin());
+	for (auto elem : self) cout << elem << ' ';
+	cout << '\n' << self.size() << ' ' << self.back() << ' ' << list.size() << '\n';	//2 1 3 4 1 5 1 0
+
+	//Iterators of two lists may share an index
+	DS::CompactForwardList<int> front{ 8,9 };
+	self.splice_after(self.cbefore_begin(), front, front.cbefore_begin());
+	front.push_back(7);
+	self.splice_after(self.cbegin(), front, front.cbefore_begin());
+	for (auto elem : self) cout << elem << ' ';
+	cout << '\n' << self.size() << ' ' << front.size() << '\n';	//8 7 9 2 1 3 4 1 8 0
+}
+
+void ConcurrentSkipListTester()
+{
+	DS::ConcurrentSkipListMap<int, std::string> map{ { 3, "three" }, { 1, "one" }, { 4, "four" } };
+	cout << map.insert({ 1, "uno" }) << map.emplace(5, "five") << map.erase(4) << map.erase(4) << ' ' << map.size() << '\n';	//0110 3
+	for (const auto& elem : map) cout << elem.first << elem.second << ' ';
+	cout << '\n';	//1one 3three 5five
+	cout << map.lower_bound(2)->second << ' ' << map.upper_bound(3)->second << ' ' << (map.find(2) == map.end()) << '\n';	//three five 1
+
+	//Writers on every thread, each owning the keys that are congruent to its index
+	DS::ConcurrentSkipListSet<int> set;
+	std::vector<std::thread> threads;
+	for (int t = 0; t < 4; t++)
+		threads.emplace_back([&set, t]
+		{
+			for (int i = t; i < 1000; i += 4)
+				set.insert(i);
+			for (int i = t; i < 1000; i += 8)
+				set.erase(i);
+		});
+	for (auto& thread : threads)
+		thread.join();
+	size_t count = 0;
+	for (auto iter = set.lower_bound(100); iter != set.end() && *iter < 200; ++iter)
+		count++;
+	cout << set.size() << ' ' << count << ' ' << set.contains(101) << set.contains(104) << '\n';	//500 52 10
+}
+
+void ParallelSortTester()
+{
+	//Long enough to be cut into 4 pieces, every key shared by many elements to show stability
+	DS::ForwardList<std::pair<int, int>> list;
+	for (int i = 300000; i-- > 0;)
+		list.push_front({ i * 7 % 1000, i });
+	list.parallel_sort([](const auto& a, const auto& b) { return a.first < b.first; }, 4);
+	bool stable = std::is_sorted(list.begin(), list.end());	//Equal keys still in ascending order of second
+	cout << stable << ' ' << list.front().second << ' ' << list.back().first << ' ' << list.back().second << '\n';	//1 0 999 299857
+
+	DS::ForwardList<int> small{ 3,1,2 };
+	small.parallel_sort();		//Too short for threads, sorted by sort()
+	small.push_back(4);
+	for (auto elem : small) cout << elem << ' ';
+	cout << '\n';	//1 2 3 4
+}
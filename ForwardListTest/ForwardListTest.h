@@ -15,3 +15,19 @@ void ModifiersTester();
 void OperationsTester();
 
 void NonMemberFunctionsTester();
+
+void AllocatorTester();
+
+void SizePolicyTester();
+
+void UnrolledListTester();
+
+void IntrusiveForwardListTester();
+
+void BulkOperationsTester();
+
+void CompactForwardListTester();
+
+void ConcurrentSkipListTester();
+
+void ParallelSortTester();
@@ -0,0 +1,53 @@
+#pragma once
+
+void StreamBenchmark();
+
+void RopeBenchmark();
+
+void StringConcatBenchmark();
+
+void NumericConversionBenchmark();
+
+void LineReadingBenchmark();
+
+void StringAllocatorBenchmark();
+
+void AsciiNormalizationBenchmark();
+
+void UnicodeBenchmark();
+
+void MultiPatternSearchBenchmark();
+
+void StringColumnBenchmark();
+
+void SharedStringBenchmark();
+
+void FormatBenchmark();
+
+void CodecBenchmark();
+
+void EditDistanceBenchmark();
+
+void GapBufferBenchmark();
+
+void ForwardListPoolBenchmark();
+
+void ForwardListSortBenchmark();
+
+void ForwardListQueueBenchmark();
+
+void UnrolledListBenchmark();
+
+void IntrusiveForwardListBenchmark();
+
+void ForwardListPrefetchBenchmark();
+
+void CompactForwardListBenchmark();
+
+void ConcurrentSkipListBenchmark();
+
+void ForwardListParallelSortBenchmark();
+
+void LockFreeStackBenchmark();
+
+void ChunkedStackBenchmark();
@@ -19,7 +19,13 @@
 #include <iomanip>
 #include <string>
 #include <stack>
+#include <vector>
+#include <thread>
+#include <iterator>
 #include "Stack.h"
+#include "LockFreeStack.h"
+#include "MPSCQueue.h"
+#include "ChunkedStack.h"
 #include "StackTest.h"
 
 using std::cin;
@@ -82,6 +88,9 @@ int main()
 	CapacityTester();
 	ModifiersTester();
 	NonMemberFunctionsTester();
+	LockFreeStackTester();
+	MPSCQueueTester();
+	ChunkedStackTester();
 
 	//Report all memory leaks
 	_CrtDumpMemoryLeaks();
@@ -173,4 +182,108 @@ void NonMemberFunctionsTester()
 		<< (vec1 != vec4) << '\n';	//True
 }
 
+void LockFreeStackTester()
+{
+	DS::LockFreeStack<std::string> s;
+	s.push("free");
+	s.emplace(3, 'x');
+	std::vector<std::string> batch{ "a", "b", "c" };
+	s.push(batch.begin(), batch.end());		//One CAS, c ends on top
+	std::string value;
+	cout << std::boolalpha << s.try_pop(value) << ' ' << value << '\n';	//true c
+
+	std::vector<std::string> popped;
+	cout << s.pop_all(std::back_inserter(popped)) << ' ' << s.empty() << ' ' << s.try_pop(value) << '\n';	//4 true false
+	print(popped.begin(), popped.end());	//b a xxx free
+
+	//Every thread pushes its numbers and pops as many, whatever it pops was pushed by someone
+	DS::LockFreeStack<int> shared;
+	std::vector<std::thread> threads;
+	std::vector<long> sums(4);
+	for (int t = 0; t < 4; t++)
+		threads.emplace_back([&shared, &sums, t]
+		{
+			int value;
+			for (int i = 0; i < 1000; i++)
+			{
+				shared.push(t * 1000 + i);
+				if (shared.try_pop(value))
+					sums[t] += value;
+			}
+		});
+	for (auto& thread : threads)
+		thread.join();
+	cout << sums[0] + sums[1] + sums[2] + sums[3] << ' ' << shared.empty() << '\n';	//7998000 true
+	cout << std::noboolalpha;
+}
+
+void MPSCQueueTester()
+{
+	DS::MPSCQueue<std::string> q;
+	q.push("first");
+	std::vector<std::string> batch{ "second", "third" };
+	q.push(batch.begin(), batch.end());
+	q.emplace(2, '4');
+	std::string value;
+	cout << std::boolalpha << q.try_pop(value) << ' ' << value << '\n';	//true first
+	std::vector<std::string> popped;
+	cout << q.pop_all(std::back_inserter(popped)) << ' ' << q.empty() << '\n';	//3 true
+	print(popped.begin(), popped.end());	//second third 44
+
+	//Three producers, the consumer sees each one's messages in the order they were sent
+	DS::MPSCQueue<std::pair<int, int>> inbox;
+	std::vector<std::thread> producers;
+	for (int t = 0; t < 3; t++)
+		producers.emplace_back([&inbox, t]
+		{
+			for (int i = 0; i < 1000; i++)
+				inbox.emplace(t, i);
+		});
+	int next[3] = {}, received = 0;
+	bool ordered = true;
+	while (received < 3000)
+	{
+		std::pair<int, int> message;
+		if (!inbox.try_pop(message))
+			continue;
+		ordered = ordered && message.second == next[message.first]++;
+		received++;
+	}
+	for (auto& producer : producers)
+		producer.join();
+	cout << ordered << ' ' << inbox.empty() << '\n';	//true true
+	cout << std::noboolalpha;
+}
+
+void ChunkedStackTester()
+{
+	//Four elements per chunk, so the pushes and pops below cross chunk boundaries
+	DS::ChunkedStack<int, 4> c{ 1,2,3,4,5 };
+	for (int i = 6; i <= 10; i++)
+		c.push_back(i);
+	print(c.begin(), c.end());						//1 2 3 4 5 6 7 8 9 10
+	for (int i = 0; i < 6; i++)
+		c.pop_back();
+	cout << c.back() << ' ' << c.size() << '\n';	//4 4
+	c.push_back(5);									//Reuses the spare chunk
+	c.pop_back();
+	c.pop_back();
+	print(c.begin(), c.end());						//1 2 3
 
+	DS::Stack<std::string, DS::ChunkedStack<std::string, 4>> s1;
+	for (int i = 0; i < 9; i++)
+		s1.push(std::string(i + 1, 'a' + i));
+	DS::Stack<std::string, DS::ChunkedStack<std::string, 4>> s2(s1);
+	cout << s1.emplace("top") << ' ' << s1.size() << '\n';	//top 10
+	s1.pop();
+	cout << std::boolalpha << (s1 == s2) << ' ';	//true
+	s2.pop();
+	cout << (s2 < s1) << ' ' << (s1 >= s2) << '\n';	//true true
+	while (!s2.empty())
+	{
+		cout << s2.top() << ' ';
+		s2.pop();
+	}
+	cout << s2.empty() << '\n';						//hhhhhhhh ... a true
+	cout << std::noboolalpha;
+}
@@ -11,3 +11,9 @@ void CapacityTester();
 void ModifiersTester();
 
 void NonMemberFunctionsTester();
+
+void LockFreeStackTester();
+
+void MPSCQueueTester();
+
+void ChunkedStackTester();